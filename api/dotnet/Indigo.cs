@@ -194,6 +194,16 @@ namespace com.epam.indigo
             return result;
         }
 
+        public double* checkResult(double* result)
+        {
+            if (result == null)
+            {
+                throw new IndigoException(_sbyteToStringUTF8(IndigoLib.indigoGetLastError()));
+            }
+
+            return result;
+        }
+
         public int* checkResult(int* result)
         {
             if (result == null)
@@ -801,6 +811,56 @@ namespace com.epam.indigo
             checkResult(IndigoLib.indigoTransform(reaction.self, monomer.self));
         }
 
+        public IndigoObject createTransformSet(IndigoObject reactions)
+        {
+            setSessionID();
+            return new IndigoObject(this, checkResult(IndigoLib.indigoCreateTransformSet(reactions.self)));
+        }
+
+        public IndigoObject createTransformSet(IEnumerable reactions)
+        {
+            return createTransformSet(toIndigoArray(reactions));
+        }
+
+        public int applyTransformSet(IndigoObject transformSet, IndigoObject monomers)
+        {
+            setSessionID();
+            return checkResult(IndigoLib.indigoApplyTransformSet(transformSet.self, monomers.self));
+        }
+
+        public IndigoObject iterateTransformSet(IndigoObject transformSet, IndigoObject monomers, int threads)
+        {
+            setSessionID();
+            return new IndigoObject(this, checkResult(IndigoLib.indigoIterateTransformSet(transformSet.self, monomers.self, threads)), monomers);
+        }
+
+        public IndigoObject iterateTransformSet(IndigoObject transformSet, IndigoObject monomers)
+        {
+            return iterateTransformSet(transformSet, monomers, -1);
+        }
+
+        public IndigoObject layoutBatch(IndigoObject objects, int threads, int timeout)
+        {
+            setSessionID();
+            return new IndigoObject(this, checkResult(IndigoLib.indigoLayoutBatch(objects.self, threads, timeout)));
+        }
+
+        public IndigoObject layoutBatch(IndigoObject objects)
+        {
+            return layoutBatch(objects, -1, 0);
+        }
+
+        public IndigoObject computeDescriptors(IndigoObject source, string descriptors, int threads)
+        {
+            setSessionID();
+            return new IndigoObject(this, checkResult(IndigoLib.indigoComputeDescriptors(source.self, descriptors, threads)));
+        }
+
+        public IndigoObject computeDescriptors(IndigoObject source, string descriptors)
+        {
+            return computeDescriptors(source, descriptors, -1);
+        }
+
         public IndigoObject loadBuffer(byte[] buf)
         {
             setSessionID();
@@ -901,6 +961,28 @@ namespace com.epam.indigo
             return new IndigoObject(this, result, molecule);
         }
 
+        public IndigoObject canonicalTautomer(IndigoObject molecule, string parameters)
+        {
+            setSessionID();
+            return new IndigoObject(this, checkResult(IndigoLib.indigoCanonicalTautomer(molecule.self, parameters)));
+        }
+
+        public IndigoObject canonicalTautomer(IndigoObject molecule)
+        {
+            return canonicalTautomer(molecule, "");
+        }
+
+        public string tautomerHash(IndigoObject molecule, string parameters)
+        {
+            setSessionID();
+            return checkResult(IndigoLib.indigoTautomerHash(molecule.self, parameters));
+        }
+
+        public string tautomerHash(IndigoObject molecule)
+        {
+            return tautomerHash(molecule, "");
+        }
+
         public int buildPkaModel(int level, float threshold, string filename)
         {
             setSessionID();
@@ -864,6 +864,9 @@ namespace com.epam.indigo
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoClean2d(int item);
 
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoClean2dIncremental(int molecule, int natoms, int[] atoms);
+
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern sbyte* indigoSmiles(int item);
 
@@ -1134,12 +1137,42 @@ namespace com.epam.indigo
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoTransform(int reaction, int monomers);
 
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoCreateTransformSet(int reactions);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoApplyTransformSet(int transform_set, int monomers);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoIterateTransformSet(int transform_set, int monomers, int threads);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoLayoutBatch(int objects, int threads, int per_item_timeout_ms);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoComputeDescriptors(int source, string descriptors, int threads);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern double* indigoDescriptorColumn(int table, int column);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern sbyte* indigoDescriptorString(int table, int column, int row);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern sbyte* indigoDescriptorError(int table, int row);
+
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoExpandAbbreviations(int structure);
 
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoIterateTautomers(int structure, string parameters);
 
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoCanonicalTautomer(int structure, string parameters);
+
+        [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
+        public static extern sbyte* indigoTautomerHash(int structure, string parameters);
+
         [DllImport("indigo"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoNameToStructure(string name, string parameters);
 
@@ -1549,6 +1549,17 @@ namespace com.epam.indigo
             dispatcher.checkResult(IndigoLib.indigoClean2d(self));
         }
 
+        public void clean2dIncremental(int[] atoms)
+        {
+            dispatcher.setSessionID();
+            dispatcher.checkResult(IndigoLib.indigoClean2dIncremental(self, atoms.Length, atoms));
+        }
+
+        public void clean2dIncremental(ICollection atoms)
+        {
+            clean2dIncremental(Indigo.toIntArray(atoms));
+        }
+
 
         public string smiles()
         {
@@ -1768,6 +1779,29 @@ namespace com.epam.indigo
             return dispatcher.checkResult(IndigoLib.indigoCount(self));
         }
 
+        public double[] descriptorColumn(int column)
+        {
+            dispatcher.setSessionID();
+            int count = dispatcher.checkResult(IndigoLib.indigoCount(self));
+            double* ptr = dispatcher.checkResult(IndigoLib.indigoDescriptorColumn(self, column));
+            double[] res = new double[count];
+            for (int i = 0; i < count; i++)
+                res[i] = ptr[i];
+            return res;
+        }
+
+        public string descriptorString(int column, int row)
+        {
+            dispatcher.setSessionID();
+            return dispatcher.checkResult(IndigoLib.indigoDescriptorString(self, column, row));
+        }
+
+        public string descriptorError(int row)
+        {
+            dispatcher.setSessionID();
+            return dispatcher.checkResult(IndigoLib.indigoDescriptorError(self, row));
+        }
+
         public void clear()
         {
             dispatcher.setSessionID();
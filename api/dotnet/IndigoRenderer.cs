@@ -97,6 +97,28 @@ namespace com.epam.indigo
             _indigo.checkResult(IndigoRendererLib.indigoRenderGridToFile(items.self, refatoms, ncolumns, filename));
         }
 
+        public byte[] renderGridPagesToBuffer(IndigoObject iterator, int ncolumns, int nrows)
+        {
+            using (IndigoObject bufh = _indigo.writeBuffer())
+            {
+                _indigo.setSessionID();
+                _indigo.checkResult(IndigoRendererLib.indigoRenderGridPages(iterator.self, ncolumns, nrows, bufh.self));
+                return bufh.toBuffer();
+            }
+        }
+
+        public int renderGridPagesToFile(IndigoObject iterator, int ncolumns, int nrows, string filename)
+        {
+            _indigo.setSessionID();
+            return _indigo.checkResult(IndigoRendererLib.indigoRenderGridPagesToFile(iterator.self, ncolumns, nrows, filename));
+        }
+
+        public IndigoObject prepare(IndigoObject obj)
+        {
+            _indigo.setSessionID();
+            return new IndigoObject(_indigo, _indigo.checkResult(IndigoRendererLib.indigoRenderPrepare(obj.self)));
+        }
+
         public void reset()
         {
             _indigo.setSessionID();
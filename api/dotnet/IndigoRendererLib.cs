@@ -20,7 +20,16 @@ namespace com.epam.indigo
         [DllImport("indigo-renderer"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoRenderGridToFile(int items, int[] refAtoms, int nColumns, string filename);
 
+        [DllImport("indigo-renderer"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoRenderGridPages(int iterator, int nColumns, int nRows, int output);
+
+        [DllImport("indigo-renderer"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoRenderGridPagesToFile(int iterator, int nColumns, int nRows, string filename);
+
         [DllImport("indigo-renderer"), SuppressUnmanagedCodeSecurity]
         public static extern int indigoRenderReset();
+
+        [DllImport("indigo-renderer"), SuppressUnmanagedCodeSecurity]
+        public static extern int indigoRenderPrepare(int obj);
     }
 }
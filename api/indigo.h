@@ -691,6 +691,20 @@ CEXPORT int indigoUnfoldHydrogens(int item);
 CEXPORT int indigoLayout(int object);
 CEXPORT int indigoClean2d(int object);
 
+// Cleans up the coordinates around the given atoms only (for example after
+// an atom was added or moved in an editor). Atoms farther than a few bonds
+// from them keep their positions.
+CEXPORT int indigoClean2dIncremental(int molecule, int natoms, int* atoms);
+
+// Lays out copies of all molecules and reactions from an array or an iterator
+// in parallel and returns them as a new array in the input order.
+// threads: number of worker threads, 0 - use the calling thread only,
+// -1 - select automatically
+// per_item_timeout_ms: time limit for a single object, 0 - use the "timeout" option.
+// An object that fails or runs out of time keeps its original coordinates
+// and gets the error message in the "layout-error" property.
+CEXPORT int indigoLayoutBatch(int objects, int threads, int per_item_timeout_ms);
+
 CEXPORT const char* indigoSmiles(int item);
 CEXPORT const char* indigoSmarts(int item);
 CEXPORT const char* indigoCanonicalSmarts(int item);
@@ -911,6 +925,22 @@ CEXPORT int indigoMapMolecule(int handle, int molecule);
 // Accepts a molecule and options for tautomer enumeration algorithms
 // Returns an iterator object over the molecules that are tautomers of this molecule.
 CEXPORT int indigoIterateTautomers(int molecule, const char* options);
+// Options: "[INCHI|RSMARTS] [QUEUE <n>] [LIMIT <n>]"
+//   QUEUE <n> -- keep at most n pending tautomers in memory (RSMARTS only)
+//   LIMIT <n> -- enumerate at most n tautomers (RSMARTS only)
+// If any of QUEUE or LIMIT is given, tautomers are enumerated breadth-first
+// and only the pending ones are stored.
+
+// Returns a deterministic representative of the tautomers of the molecule:
+// the aromatized tautomer with the minimal canonical SMILES.
+// The tautomers are not stored; QUEUE and LIMIT options are accepted, but
+// INCHI method is not. The result does not depend on the given tautomer only
+// if all the tautomers are enumerated, so an error is raised if QUEUE, LIMIT
+// or the internal limit of 2^20 tautomers cuts the enumeration.
+CEXPORT int indigoCanonicalTautomer(int molecule, const char* options);
+// Returns a hash (16 hex digits) of the canonical tautomer of the molecule.
+// The options and the errors are the same as for indigoCanonicalTautomer().
+CEXPORT const char* indigoTautomerHash(int molecule, const char* options);
 
 /* Scaffold detection */
 
@@ -919,6 +949,11 @@ CEXPORT int indigoIterateTautomers(int molecule, const char* options);
 //   (i) treated as a structure: the maximum (by the number of rings) common
 //       substructure of the given structures.
 //  (ii) passed to indigoAllScaffolds()
+// options: "EXACT|APPROX [max_iterations] [THREADS n] [TIMEOUT ms]"
+// THREADS or TIMEOUT select the tree reduction: chunks of the structures are
+// reduced in parallel and the results are merged pairwise (n = -1 selects the
+// number of threads automatically). When the TIMEOUT budget is exhausted, the
+// scaffold of the largest group of structures processed by then is returned.
 CEXPORT int indigoExtractCommonScaffold(int structures, const char* options);
 
 // Returns an array of all possible scaffolds.
@@ -986,6 +1021,38 @@ CEXPORT int indigoReactionProductEnumerate(int reaction, int monomers);
 
 CEXPORT int indigoTransform(int reaction, int monomers);
 
+/* Transform sets */
+
+// Prepares a reaction or an array of reactions to be applied to many
+// molecules. Each transformation is merged and fingerprinted only once.
+CEXPORT int indigoCreateTransformSet(int reactions);
+// Applies all transformations of the set in order to a molecule or to
+// an array of molecules in-place. Returns the number of applied transformations.
+CEXPORT int indigoApplyTransformSet(int transform_set, int monomers);
+// Returns an iterator over the transformed copies of the molecules from
+// an array or an iterator (e.g. indigoIterateSDFile). Molecules are
+// transformed in parallel and returned in the input order.
+// threads: number of worker threads, 0 - use the calling thread only,
+// -1 - select automatically
+CEXPORT int indigoIterateTransformSet(int transform_set, int monomers, int threads);
+
+/* Batch descriptors */
+
+// Computes descriptors for all molecules from an array or an iterator.
+// descriptors: ';'-separated list of mw, mono, most_abundant, nominal,
+// formula, composition, atoms, bonds, heavy_atoms, hydrogens, components, sssr
+// threads: number of worker threads, 0 - use the calling thread only,
+// -1 - select automatically
+// Returns a descriptor table; indigoCount() returns its number of rows.
+CEXPORT int indigoComputeDescriptors(int source, const char* descriptors, int threads);
+// Returns all values of a numeric column, one per row. NaN marks a failed value.
+// The pointer is valid until the table is freed.
+CEXPORT const double* indigoDescriptorColumn(int table, int column);
+// Returns a value of a string column (formula or composition)
+CEXPORT const char* indigoDescriptorString(int table, int column, int row);
+// Returns an error message for a row, or an empty string if all values were computed
+CEXPORT const char* indigoDescriptorError(int table, int row);
+
 CEXPORT int indigoTransformHELMtoSCSR(int monomer);
 
 /* Debug functionality */
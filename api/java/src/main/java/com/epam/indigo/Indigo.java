@@ -863,6 +863,49 @@ public class Indigo {
         checkResult(guard, _lib.indigoTransform(reaction.self, monomer.self));
     }
 
+    public IndigoObject createTransformSet(IndigoObject reactions) {
+        setSessionID();
+        return new IndigoObject(this, checkResult(this, reactions, _lib.indigoCreateTransformSet(reactions.self)));
+    }
+
+    public IndigoObject createTransformSet(Collection<IndigoObject> reactions) {
+        return createTransformSet(toIndigoArray(reactions));
+    }
+
+    public int applyTransformSet(IndigoObject transformSet, IndigoObject monomers) {
+        Object[] guard = new Object[]{this, transformSet, monomers};
+        setSessionID();
+        return checkResult(guard, _lib.indigoApplyTransformSet(transformSet.self, monomers.self));
+    }
+
+    public IndigoObject iterateTransformSet(IndigoObject transformSet, IndigoObject monomers, int threads) {
+        Object[] guard = new Object[]{this, transformSet, monomers};
+        setSessionID();
+        return new IndigoObject(this, checkResult(guard, _lib.indigoIterateTransformSet(transformSet.self, monomers.self, threads)), guard);
+    }
+
+    public IndigoObject iterateTransformSet(IndigoObject transformSet, IndigoObject monomers) {
+        return iterateTransformSet(transformSet, monomers, -1);
+    }
+
+    public IndigoObject layoutBatch(IndigoObject objects, int threads, int timeout) {
+        setSessionID();
+        return new IndigoObject(this, checkResult(this, objects, _lib.indigoLayoutBatch(objects.self, threads, timeout)));
+    }
+
+    public IndigoObject layoutBatch(IndigoObject objects) {
+        return layoutBatch(objects, -1, 0);
+    }
+
+    public IndigoObject computeDescriptors(IndigoObject source, String descriptors, int threads) {
+        setSessionID();
+        return new IndigoObject(this, checkResult(this, source, _lib.indigoComputeDescriptors(source.self, descriptors, threads)));
+    }
+
+    public IndigoObject computeDescriptors(IndigoObject source, String descriptors) {
+        return computeDescriptors(source, descriptors, -1);
+    }
+
     public IndigoObject createSaver(IndigoObject output, String format) {
         setSessionID();
         return new IndigoObject(this, checkResult(this, output, _lib.indigoCreateSaver(output.self, format)), output);
@@ -958,6 +1001,24 @@ public class Indigo {
         return new IndigoObject(this, result, molecule);
     }
 
+    public IndigoObject canonicalTautomer(IndigoObject molecule, String params) {
+        setSessionID();
+        return new IndigoObject(this, checkResult(this, _lib.indigoCanonicalTautomer(molecule.self, params)));
+    }
+
+    public IndigoObject canonicalTautomer(IndigoObject molecule) {
+        return canonicalTautomer(molecule, "");
+    }
+
+    public String tautomerHash(IndigoObject molecule, String params) {
+        setSessionID();
+        return checkResultString(this, _lib.indigoTautomerHash(molecule.self, params));
+    }
+
+    public String tautomerHash(IndigoObject molecule) {
+        return tautomerHash(molecule, "");
+    }
+
     public int buildPkaModel(int level, float threshold, String filename) {
         setSessionID();
         return checkResult(this, _lib.indigoBuildPkaModel(level, threshold, filename));
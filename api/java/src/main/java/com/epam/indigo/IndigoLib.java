@@ -399,6 +399,7 @@ public interface IndigoLib extends Library
    int indigoLayout (int object);
 
    int indigoClean2d (int object);
+   int indigoClean2dIncremental (int molecule, int natoms, int atoms[]);
 
    Pointer indigoSmiles (int item);
 
@@ -500,9 +501,19 @@ public interface IndigoLib extends Library
    int indigoToBuffer (int handle, PointerByReference buf, IntByReference size);
    int indigoReactionProductEnumerate (int reaction, int monomers);
    int indigoTransform (int reaction, int monomers);
+   int indigoCreateTransformSet (int reactions);
+   int indigoApplyTransformSet (int transform_set, int monomers);
+   int indigoIterateTransformSet (int transform_set, int monomers, int threads);
+   int indigoLayoutBatch (int objects, int threads, int per_item_timeout_ms);
+   int indigoComputeDescriptors (int source, String descriptors, int threads);
+   Pointer indigoDescriptorColumn (int table, int column);
+   Pointer indigoDescriptorString (int table, int column, int row);
+   Pointer indigoDescriptorError (int table, int row);
 
    int indigoExpandAbbreviations (int structure);
    int indigoIterateTautomers(int structure, String params);
+   int indigoCanonicalTautomer(int structure, String params);
+   Pointer indigoTautomerHash(int structure, String params);
    
    int indigoNameToStructure(String name, String params);
 
@@ -1560,6 +1560,17 @@ public class IndigoObject implements Iterator<IndigoObject>, Iterable<IndigoObje
       Indigo.checkResult(this, _lib.indigoClean2d(self));
    }
 
+   public void clean2dIncremental (int[] atoms)
+   {
+      dispatcher.setSessionID();
+      Indigo.checkResult(this, _lib.indigoClean2dIncremental(self, atoms.length, atoms));
+   }
+
+   public void clean2dIncremental (Collection<Integer> atoms)
+   {
+      clean2dIncremental(Indigo.toIntArray(atoms));
+   }
+
    public String smiles()
    {
       dispatcher.setSessionID();
@@ -1732,6 +1743,26 @@ public class IndigoObject implements Iterator<IndigoObject>, Iterable<IndigoObje
       return Indigo.checkResult(this, _lib.indigoCount(self));
    }
 
+   public double[] descriptorColumn (int column)
+   {
+      dispatcher.setSessionID();
+      int count = Indigo.checkResult(this, _lib.indigoCount(self));
+      Pointer ptr = Indigo.checkResultPointer(this, _lib.indigoDescriptorColumn(self, column));
+      return ptr.getDoubleArray(0, count);
+   }
+
+   public String descriptorString (int column, int row)
+   {
+      dispatcher.setSessionID();
+      return Indigo.checkResultString(this, _lib.indigoDescriptorString(self, column, row));
+   }
+
+   public String descriptorError (int row)
+   {
+      dispatcher.setSessionID();
+      return Indigo.checkResultString(this, _lib.indigoDescriptorError(self, row));
+   }
+
    public void clear ()
    {
       dispatcher.setSessionID();
@@ -326,8 +326,16 @@ CEXPORT int bingoGetRecordObj(int db, int id)
             AutoPtr<IndigoMolecule> molptr(new IndigoMolecule());
 
             Molecule& mol = molptr->mol;
-            CmfLoader cmf_loader(buf_scn);
-            cmf_loader.loadMolecule(mol);
+            if (Cmf2Loader::checkVersion((const char*)cf_buf, cf_len))
+            {
+                Cmf2Loader cmf2_loader((const char*)cf_buf, cf_len);
+                cmf2_loader.loadMolecule(mol);
+            }
+            else
+            {
+                CmfLoader cmf_loader((const char*)cf_buf, cf_len);
+                cmf_loader.loadMolecule(mol);
+            }
 
             indigo_obj_id = self.addObject(molptr.release());
         }
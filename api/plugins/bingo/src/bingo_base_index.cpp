@@ -27,6 +27,7 @@ static const char* _max_mmf_size_prop = "max_mmf_size";
 static const char* _min_mmf_size_prop = "min_mmf_size";
 static const char* _mt_size_prop = "mt_size";
 static const char* _id_key_prop = "key";
+static const char* _cf_format_prop = "cf_format";
 static const size_t _min_mmf_size = 33554432;  // 32Mb
 static const size_t _max_mmf_size = 536870912; // 512Mb
 static const int _small_base_size = 10000;
@@ -36,6 +37,7 @@ BaseIndex::BaseIndex(IndexType type)
 {
     _type = type;
     _read_only = false;
+    _cf2 = false;
     _index_id = -1;
 }
 
@@ -65,6 +67,10 @@ void BaseIndex::create(const char* location, const MoleculeFingerprintParameters
     _checkOptions(option_map, true);
 
     _read_only = _getAccessType(option_map);
+    _cf2 = _getCfFormat(option_map);
+
+    if (_cf2 && _type != MOLECULE)
+        throw Exception("Creating index error: cmf2 format is supported only for molecules");
 
     size_t min_mmf_size = _getMinMMfSize(option_map);
     size_t max_mmf_size = _getMaxMMfSize(option_map);
@@ -145,6 +151,9 @@ void BaseIndex::load(const char* location, const char* options, int index_id)
     _fp_params.sim_qwords = _properties.ref().getULong("fp_sim");
     _fp_params.similarity_type = MoleculeFingerprintBuilder::parseSimilarityType(_properties.ref().get("fp_similarity_type"));
 
+    const char* cf_format = _properties.ref().getNoThrow(_cf_format_prop);
+    _cf2 = (cf_format != 0 && strcmp(cf_format, "cmf2") == 0);
+
     // unsigned long cf_block_size = _properties->getULong("cf_block_size");
 
     _mappingLoad();
@@ -384,7 +393,7 @@ void BaseIndex::_checkOptions(std::map<std::string, std::string>& option_map, bo
         if (is_create)
         {
             if ((it->first.compare(_read_only_prop) != 0) && (it->first.compare(_mt_size_prop) != 0) && (it->first.compare(_min_mmf_size_prop) != 0) &&
-                (it->first.compare(_max_mmf_size_prop) != 0) && (it->first.compare(_id_key_prop) != 0))
+                (it->first.compare(_max_mmf_size_prop) != 0) && (it->first.compare(_id_key_prop) != 0) && (it->first.compare(_cf_format_prop) != 0))
                 throw Exception("Creating index error: incorrect input options");
         }
         else if ((it->first.compare(_read_only_prop)) != 0 && (it->first.compare(_id_key_prop) != 0))
@@ -443,6 +452,21 @@ bool BaseIndex::_getAccessType(std::map<std::string, std::string>& option_map)
     return false;
 }
 
+bool BaseIndex::_getCfFormat(std::map<std::string, std::string>& option_map)
+{
+    if (option_map.find(_cf_format_prop) == option_map.end())
+        return false;
+
+    const std::string& format = option_map[_cf_format_prop];
+
+    if (format.compare("cmf2") == 0)
+        return true;
+    if (format.compare("cmf") != 0)
+        throw Exception("Creating index error: incorrect cf_format value");
+
+    return false;
+}
+
 void BaseIndex::_saveProperties(const MoleculeFingerprintParameters& fp_params, int sub_block_size, int sim_block_size, int cf_block_size,
                                 std::map<std::string, std::string>& option_map)
 {
@@ -468,7 +492,7 @@ bool BaseIndex::_prepareIndexData(IndexObject& obj, _ObjectIndexData& obj_data)
 {
     {
         profTimerStart(t, "prepare_cf");
-        if (!obj.buildCfString(obj_data.cf_str))
+        if (!(_cf2 ? obj.buildCf2String(obj_data.cf_str) : obj.buildCfString(obj_data.cf_str)))
             return false;
     }
 
@@ -494,7 +518,7 @@ bool BaseIndex::_prepareIndexDataWithExtFP(IndexObject& obj, _ObjectIndexData& o
 {
     {
         profTimerStart(t, "prepare_cf");
-        if (!obj.buildCfString(obj_data.cf_str))
+        if (!(_cf2 ? obj.buildCf2String(obj_data.cf_str) : obj.buildCfString(obj_data.cf_str)))
             return false;
     }
 
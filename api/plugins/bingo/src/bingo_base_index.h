@@ -128,6 +128,8 @@ namespace bingo
         BaseIndex(IndexType type);
         IndexType _type;
         bool _read_only;
+        // Objects are saved in CMF version 2 instead of CMF
+        bool _cf2;
 
     private:
         struct _ObjectIndexData
@@ -163,6 +165,8 @@ namespace bingo
 
         static bool _getAccessType(std::map<std::string, std::string>& option_map);
 
+        static bool _getCfFormat(std::map<std::string, std::string>& option_map);
+
         void _saveProperties(const MoleculeFingerprintParameters& fp_params, int sub_block_size, int sim_block_size, int cf_block_size,
                              std::map<std::string, std::string>& option_map);
 
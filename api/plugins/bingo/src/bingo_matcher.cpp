@@ -285,9 +285,18 @@ bool BaseMatcher::_loadCurrentObject()
         {
             Molecule& mol = _current_obj->getMolecule();
 
-            CmfLoader cmf_loader(buf_scn);
+            if (Cmf2Loader::checkVersion(cf_str, cf_len))
+            {
+                Cmf2Loader cmf2_loader(cf_str, cf_len);
+
+                cmf2_loader.loadMolecule(mol);
+            }
+            else
+            {
+                CmfLoader cmf_loader(cf_str, cf_len);
 
-            cmf_loader.loadMolecule(mol);
+                cmf_loader.loadMolecule(mol);
+            }
         }
         else if (IndigoReaction::is(*_current_obj))
         {
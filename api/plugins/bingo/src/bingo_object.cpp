@@ -9,6 +9,7 @@
 #include "reaction/reaction_fingerprint.h"
 #include "reaction/reaction_substructure_matcher.h"
 
+#include "molecule/cmf2_saver.h"
 #include "molecule/cmf_loader.h"
 #include "molecule/cmf_saver.h"
 #include "molecule/molecule.h"
@@ -148,6 +149,16 @@ bool IndexMolecule::buildCfString(Array<char>& cf) // const
     return true;
 }
 
+bool IndexMolecule::buildCf2String(Array<char>& cf) // const
+{
+    ArrayOutput arr_out(cf);
+    Cmf2Saver cmf2_saver(arr_out);
+
+    cmf2_saver.saveMolecule(_mol);
+
+    return true;
+}
+
 bool IndexMolecule::buildHash(dword& hash)
 {
     hash = ExactStorage::calculateMolHash(_mol);
@@ -194,6 +205,11 @@ bool IndexReaction::buildCfString(Array<char>& cf) // const
     return true;
 }
 
+bool IndexReaction::buildCf2String(Array<char>& cf) // const
+{
+    throw Exception("CMF2 format is not supported for reactions");
+}
+
 bool IndexReaction::buildHash(dword& hash)
 {
     hash = ExactStorage::calculateRxnHash(_rxn);
@@ -12,6 +12,7 @@
 #include "reaction/reaction_fingerprint.h"
 #include "reaction/reaction_substructure_matcher.h"
 
+#include "molecule/cmf2_loader.h"
 #include "molecule/cmf_loader.h"
 #include "molecule/cmf_saver.h"
 #include "molecule/molecule.h"
@@ -122,6 +123,9 @@ namespace bingo
 
         virtual bool buildCfString(Array<char>& cf) /* const */ = 0;
 
+        // The same in the sectioned format of CMF version 2
+        virtual bool buildCf2String(Array<char>& cf) /* const */ = 0;
+
         virtual bool buildHash(dword& hash) /* const */ = 0;
 
         virtual ~IndexObject(){};
@@ -141,6 +145,8 @@ namespace bingo
 
         virtual bool buildCfString(Array<char>& cf) /*const*/;
 
+        virtual bool buildCf2String(Array<char>& cf) /*const*/;
+
         virtual bool buildHash(dword& hash) /* const */;
     };
 
@@ -158,6 +164,8 @@ namespace bingo
 
         virtual bool buildCfString(Array<char>& cf) /*const*/;
 
+        virtual bool buildCf2String(Array<char>& cf) /*const*/;
+
         virtual bool buildHash(dword& hash) /* const */;
     };
 }; // namespace bingo
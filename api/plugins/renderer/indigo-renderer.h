@@ -44,7 +44,26 @@ CEXPORT int indigoRenderToFile(int object, const char* filename);
 // Works like indigoRenderGrid(), but renders directly to file
 CEXPORT int indigoRenderGridToFile(int objects, int* refAtoms, int nColumns, const char* filename);
 
+// Renders the objects of an iterator (e.g. indigoIterateSDFile) as a grid of
+// nColumns x nRows objects per page into a multi-page PDF or SVG document.
+// The pages are written as they are drawn, so only the objects of one page
+// are held in memory at a time. All the pages have the size of the first one,
+// unless "render-image-size" is set. SVG documents use SVG 1.2 pages.
+// Returns the number of pages.
+CEXPORT int indigoRenderGridPages(int iterator, int nColumns, int nRows, int output);
+
+// Works like indigoRenderGridPages(), but renders directly to file
+CEXPORT int indigoRenderGridPagesToFile(int iterator, int nColumns, int nRows, const char* filename);
+
 // Resets all the rendering settings
 CEXPORT int indigoRenderReset();
 
+// Returns a prepared depiction of a molecule or a reaction. It can be passed
+// to indigoRender() and to indigoRenderGrid() (in an array of depictions)
+// instead of the structure. The first render records the drawing, and later
+// renders replay it at any size and into any format except CDXML, which is
+// much faster for repeated thumbnails. The drawing keeps the options that were
+// set at the first render and is scaled as a whole, line widths included.
+CEXPORT int indigoRenderPrepare(int object);
+
 #endif
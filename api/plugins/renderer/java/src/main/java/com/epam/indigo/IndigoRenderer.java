@@ -77,6 +77,30 @@ public class IndigoRenderer
       }
    }
    
+   public int renderGridPagesToFile (IndigoObject iterator, int ncolumns, int nrows, String filename)
+   {
+      _indigo.setSessionID();
+      return Indigo.checkResult(this, iterator, _lib.indigoRenderGridPagesToFile(iterator.self, ncolumns, nrows, filename));
+   }
+
+   public byte[] renderGridPagesToBuffer (IndigoObject iterator, int ncolumns, int nrows)
+   {
+      _indigo.setSessionID();
+      IndigoObject buf = _indigo.writeBuffer();
+      try {
+         Indigo.checkResult(this, iterator, _lib.indigoRenderGridPages(iterator.self, ncolumns, nrows, buf.self));
+         return buf.toBuffer();
+      } finally {
+         buf.dispose();
+      }
+   }
+
+   public IndigoObject prepare (IndigoObject obj)
+   {
+      _indigo.setSessionID();
+      return new IndigoObject(_indigo, Indigo.checkResult(this, obj, _lib.indigoRenderPrepare(obj.self)));
+   }
+
    public void renderResetSettings(){
        _indigo.setSessionID();
        _lib.indigoRenderReset();
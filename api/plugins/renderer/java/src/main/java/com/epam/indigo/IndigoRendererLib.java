@@ -28,5 +28,8 @@ public interface IndigoRendererLib extends Library
    int indigoRenderGrid (int objects, int[] refAtoms, int nColumns, int output);
    int indigoRenderToFile (int object, String filename);
    int indigoRenderGridToFile (int objects, int[] refAtoms, int nColumns, String filename);
+   int indigoRenderGridPages (int iterator, int nColumns, int nRows, int output);
+   int indigoRenderGridPagesToFile (int iterator, int nColumns, int nRows, String filename);
    int indigoRenderReset();
+   int indigoRenderPrepare (int object);
 }
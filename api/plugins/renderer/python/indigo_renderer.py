@@ -41,6 +41,16 @@ class IndigoRenderer(object):
         self._lib.indigoRenderGridToFile.argtypes = [c_int, POINTER(c_int), c_int, c_char_p]
         self._lib.indigoRenderReset.restype = c_int
         self._lib.indigoRenderReset.argtypes = [c_int]
+        self._lib.indigoRenderPrepare.restype = c_int
+        self._lib.indigoRenderPrepare.argtypes = [c_int]
+        self._lib.indigoRenderGridPages.restype = c_int
+        self._lib.indigoRenderGridPages.argtypes = [c_int, c_int, c_int, c_int]
+        self._lib.indigoRenderGridPagesToFile.restype = c_int
+        self._lib.indigoRenderGridPagesToFile.argtypes = [c_int, c_int, c_int, c_char_p]
+
+    def prepare(self, obj):
+        self.indigo._setSessionId()
+        return self.indigo.IndigoObject(self.indigo, self.indigo._checkResult(self._lib.indigoRenderPrepare(obj.id)))
 
     def renderToBuffer(self, obj):
         self.indigo._setSessionId()
@@ -67,6 +77,21 @@ class IndigoRenderer(object):
         self.indigo._checkResult(
             self._lib.indigoRenderGridToFile(objects.id, arr, ncolumns, filename.encode('ascii')))
 
+    def renderGridPagesToFile(self, iterator, ncolumns, nrows, filename):
+        self.indigo._setSessionId()
+        return self.indigo._checkResult(
+            self._lib.indigoRenderGridPagesToFile(iterator.id, ncolumns, nrows, filename.encode('ascii')))
+
+    def renderGridPagesToBuffer(self, iterator, ncolumns, nrows):
+        self.indigo._setSessionId()
+        wb = self.indigo.writeBuffer()
+        try:
+            self.indigo._checkResult(
+                self._lib.indigoRenderGridPages(iterator.id, ncolumns, nrows, wb.id))
+            return wb.toBuffer()
+        finally:
+            wb.dispose()
+
     def renderGridToBuffer(self, objects, refatoms, ncolumns):
         self.indigo._setSessionId()
         arr = None
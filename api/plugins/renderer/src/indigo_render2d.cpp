@@ -394,9 +394,14 @@ else if (IndigoBaseReaction::is(obj))
     rp.rxn->clone(self.getObject(object).getBaseReaction(), 0, 0, 0);
     rp.rmode = RENDER_RXN;
 }
+else if (obj.type == IndigoRenderDepiction::RENDER_DEPICTION)
+{
+    rp.depiction = &((IndigoRenderDepiction&)obj).depiction;
+    rp.rmode = RENDER_DEPICTION;
+}
 else
 {
-    throw IndigoError("The object provided should be a molecule, a reaction or an array of such");
+    throw IndigoError("The object provided should be a molecule, a reaction, a prepared depiction or an array of such");
 }
 
 IndigoObject& out = self.getObject(output);
@@ -482,9 +487,22 @@ else if (IndigoBaseReaction::is(*objs[0]))
         rp.rmode = RENDER_RXN;
     }
 }
+else if (objs[0]->type == IndigoRenderDepiction::RENDER_DEPICTION)
+{
+    for (int i = 0; i < objs.size(); ++i)
+    {
+        if (objs[i]->type != IndigoRenderDepiction::RENDER_DEPICTION)
+            throw IndigoError("The array elements should all be prepared depictions");
+        rp.depictions.push(&((IndigoRenderDepiction*)objs[i])->depiction);
+        Array<char>& title = rp.titles.push();
+        if (objs[i]->getProperties().contains(rp.cnvOpt.titleProp.ptr()))
+            title.copy(objs[i]->getProperties().valueBuf(rp.cnvOpt.titleProp.ptr()));
+        rp.rmode = RENDER_DEPICTION;
+    }
+}
 else
 {
-    throw IndigoError("The array elements should be molecules or reactions");
+    throw IndigoError("The array elements should be molecules, reactions or prepared depictions");
 }
 
 if (refAtoms != NULL)
@@ -531,6 +549,39 @@ return 1;
 INDIGO_END(-1)
 }
 
+CEXPORT int indigoRenderPrepare(int object)
+{
+    INDIGO_BEGIN
+    {
+        IndigoObject& obj = self.getObject(object);
+        AutoPtr<IndigoRenderDepiction> result(new IndigoRenderDepiction());
+        RenderDepiction& depiction = result->depiction;
+
+        if (IndigoBaseMolecule::is(obj))
+        {
+            if (obj.getBaseMolecule().isQueryMolecule())
+                depiction.mol.reset(new QueryMolecule());
+            else
+                depiction.mol.reset(new Molecule());
+            depiction.mol->clone_KeepIndices(obj.getBaseMolecule());
+        }
+        else if (IndigoBaseReaction::is(obj))
+        {
+            if (obj.getBaseReaction().isQueryReaction())
+                depiction.rxn.reset(new QueryReaction());
+            else
+                depiction.rxn.reset(new Reaction());
+            depiction.rxn->clone(obj.getBaseReaction(), 0, 0, 0);
+        }
+        else
+            throw IndigoError("The object provided should be a molecule or a reaction");
+
+        result->getProperties().copy(obj.getProperties());
+        return self.addObject(result.release());
+    }
+    INDIGO_END(-1);
+}
+
 DINGO_MODE indigoRenderGuessOutputFormat(const char* filename)
 {
     const char* ext = strrchr(filename, '.');
@@ -574,6 +625,130 @@ CEXPORT int indigoRenderGridToFile(int objects, int* refAtoms, int nColumns, con
     return res;
 }
 
+// Takes the objects of the grid pages from an iterator
+class IndigoRenderPageSource : public RenderPageSource
+{
+public:
+    IndigoRenderPageSource(IndigoObject& iterator, int pageSize) : _iterator(iterator), _pageSize(pageSize)
+    {
+    }
+
+    virtual bool nextPage(RenderParams& rp)
+    {
+        // The objects of the previous page are released here; the params only
+        // point to the prepared depictions
+        _objects.clear();
+        while (_objects.size() < _pageSize)
+        {
+            IndigoObject* next = _iterator.next();
+            if (next == NULL)
+                break;
+            _objects.add(next);
+            _addObject(rp, *next, _objects.size() == 1);
+        }
+        if (_objects.size() == 0)
+            return false;
+
+        bool hasNonemptyTitles = false;
+        for (int i = 0; i < rp.titles.size(); ++i)
+            if (rp.titles[i].size() > 0)
+            {
+                hasNonemptyTitles = true;
+                break;
+            }
+        if (!hasNonemptyTitles)
+            rp.titles.clear();
+        return true;
+    }
+
+private:
+    void _addObject(RenderParams& rp, IndigoObject& obj, bool first)
+    {
+        IndigoObject& item = obj.type == IndigoObject::ARRAY_ELEMENT ? ((IndigoArrayElement&)obj).get() : obj;
+
+        if (IndigoBaseMolecule::is(item) && (first || rp.rmode == RENDER_MOL))
+        {
+            BaseMolecule& bm = item.getBaseMolecule();
+            rp.mols.add(bm.isQueryMolecule() ? (BaseMolecule*)new QueryMolecule() : (BaseMolecule*)new Molecule());
+            rp.mols.top()->clone_KeepIndices(bm);
+            rp.rmode = RENDER_MOL;
+        }
+        else if (IndigoBaseReaction::is(item) && (first || rp.rmode == RENDER_RXN))
+        {
+            BaseReaction& br = item.getBaseReaction();
+            rp.rxns.add(br.isQueryReaction() ? (BaseReaction*)new QueryReaction() : (BaseReaction*)new Reaction());
+            rp.rxns.top()->clone(br, 0, 0, 0);
+            rp.rmode = RENDER_RXN;
+        }
+        else if (item.type == IndigoRenderDepiction::RENDER_DEPICTION && (first || rp.rmode == RENDER_DEPICTION))
+        {
+            rp.depictions.push(&((IndigoRenderDepiction&)item).depiction);
+            rp.rmode = RENDER_DEPICTION;
+        }
+        else
+            throw IndigoError("The objects of a page should all be molecules, reactions or prepared depictions");
+
+        Array<char>& title = rp.titles.push();
+        if (item.getProperties().contains(rp.cnvOpt.titleProp.ptr()))
+            title.copy(item.getProperties().valueBuf(rp.cnvOpt.titleProp.ptr()));
+    }
+
+    IndigoObject& _iterator;
+    int _pageSize;
+    PtrArray<IndigoObject> _objects;
+};
+
+CEXPORT int indigoRenderGridPages(int iterator, int nColumns, int nRows, int output)
+{
+    INDIGO_BEGIN
+    {
+        RenderParams& rp = indigoRendererGetInstance().renderParams;
+        if (nColumns < 1 || nRows < 1)
+            throw IndigoError("The number of columns and rows should be positive");
+
+        IndigoObject& out = self.getObject(output);
+        if (out.type != IndigoObject::OUTPUT)
+            throw IndigoError("Invalid output object type");
+
+        rp.clearArrays();
+        rp.rOpt.output = &IndigoOutput::get(out);
+        rp.cnvOpt.gridColumnNumber = nColumns;
+        rp.cnvOpt.gridRowNumber = nRows;
+
+        IndigoRenderPageSource source(self.getObject(iterator), nColumns * nRows);
+        int pages;
+        try
+        {
+            pages = RenderParamInterface::renderPages(rp, source);
+        }
+        catch (...)
+        {
+            rp.cnvOpt.gridRowNumber = 0;
+            throw;
+        }
+        rp.cnvOpt.gridRowNumber = 0;
+        return pages;
+    }
+    INDIGO_END(-1)
+}
+
+CEXPORT int indigoRenderGridPagesToFile(int iterator, int nColumns, int nRows, const char* filename)
+{
+    int f = indigoWriteFile(filename);
+
+    if (f == -1)
+        return -1;
+
+    RenderParams& rp = indigoRendererGetInstance().renderParams;
+    DINGO_MODE setMode = rp.rOpt.mode;
+    rp.rOpt.mode = (setMode == MODE_NONE) ? indigoRenderGuessOutputFormat(filename) : setMode;
+    int res = indigoRenderGridPages(iterator, nColumns, nRows, f);
+    rp.rOpt.mode = setMode;
+
+    indigoFree(f);
+    return res;
+}
+
 CEXPORT int indigoRenderReset(){INDIGO_BEGIN{IndigoRenderer& rp = indigoRendererGetInstance();
 rp.init();
 return 1;
@@ -662,6 +837,7 @@ _IndigoRenderingOptionsHandlersSetter::_IndigoRenderingOptionsHandlersSetter()
     mgr.setOptionHandlerFloat("render-grid-title-font-size", SETTER_GETTER_FLOAT_OPTION(rp.rOpt.titleFontFactor));
     mgr.setOptionHandlerString("render-grid-title-property", SETTER_GETTER_STR_OPTION(rp.cnvOpt.titleProp));
     mgr.setOptionHandlerInt("render-grid-title-offset", SETTER_GETTER_INT_OPTION(rp.cnvOpt.titleOffset));
+    mgr.setOptionHandlerInt("render-grid-threads", SETTER_GETTER_INT_OPTION(rp.cnvOpt.gridThreads));
 
     mgr.setOptionHandlerBool("render-cdxml-properties-enabled", SETTER_GETTER_BOOL_OPTION(cdxmlContext.enabled));
     mgr.setOptionHandlerString("render-cdxml-properties-fonttable", SETTER_GETTER_STR_OPTION(cdxmlContext.fonttable));
@@ -21,6 +21,7 @@
 
 #include "base_cpp/tlscont.h"
 #include "indigo_internal.h"
+#include "render2d/render_depiction.h"
 #include "render2d/render_params.h"
 
 class IndigoRenderer : public IndigoPluginContext
@@ -56,6 +57,46 @@ protected:
     RenderParams params;
 };
 
+class IndigoRenderDepiction : public IndigoObject
+{
+public:
+    enum
+    {
+        RENDER_DEPICTION = 111
+    };
+
+    IndigoRenderDepiction() : IndigoObject(RENDER_DEPICTION)
+    {
+    }
+
+    virtual ~IndigoRenderDepiction()
+    {
+    }
+
+    virtual const char* getTypeName() const
+    {
+        return "RenderDepiction";
+    }
+
+    virtual PropertiesMap& getProperties()
+    {
+        return _properties;
+    }
+
+    virtual IndigoObject* clone()
+    {
+        AutoPtr<IndigoRenderDepiction> res(new IndigoRenderDepiction());
+        res->depiction.copy(depiction);
+        res->_properties.copy(_properties);
+        return res.release();
+    }
+
+    RenderDepiction depiction;
+
+private:
+    PropertiesMap _properties;
+};
+
 // TL_DECL_EXT(IndigoRenderer, indigo_renderer_self);
 
 #endif
@@ -50,6 +50,238 @@ void testHDC()
     indigoFree(molecule);
 }
 
+static int bufferContains(const char* buf, int size, const char* str)
+{
+    int i, len = (int)strlen(str);
+
+    for (i = 0; i + len <= size; i++)
+        if (memcmp(buf + i, str, len) == 0)
+            return 1;
+    return 0;
+}
+
+void testSVG()
+{
+    int buffer_object;
+    char* raw_ptr;
+    int size;
+    int molecule;
+
+    molecule = indigoLoadMoleculeFromString("CN1C=NC2=C1C(=O)N(C(=O)N2C)C");
+    indigoSetOption("render-output-format", "svg");
+
+    buffer_object = indigoWriteBuffer();
+    indigoRender(molecule, buffer_object);
+    indigoToBuffer(buffer_object, &raw_ptr, &size);
+
+    // Glyphs are written as plain paths, without the font subsets shared between threads
+    if (!bufferContains(raw_ptr, size, "<svg") || bufferContains(raw_ptr, size, "<symbol"))
+    {
+        printf("Unexpected SVG output\n");
+        exit(-1);
+    }
+
+    indigoFree(buffer_object);
+    indigoFree(molecule);
+}
+
+void testPNG()
+{
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    int buffer_objects[2];
+    char* raw_ptr[2];
+    int size[2];
+    int molecule, other, buffer_object, i;
+
+    molecule = indigoLoadMoleculeFromString("CN1C=NC2=C1C(=O)N(C(=O)N2C)C");
+    indigoSetOption("render-output-format", "png");
+
+    // The second image reuses the encoder state and font caches of the first one
+    for (i = 0; i < 2; i++)
+    {
+        buffer_objects[i] = indigoWriteBuffer();
+        indigoRender(molecule, buffer_objects[i]);
+        indigoToBuffer(buffer_objects[i], &raw_ptr[i], &size[i]);
+    }
+
+    if (size[0] < 8 || memcmp(raw_ptr[0], signature, 8) != 0 || !bufferContains(raw_ptr[0], size[0], "IEND"))
+    {
+        printf("Unexpected PNG output\n");
+        exit(-1);
+    }
+    if (size[0] != size[1] || memcmp(raw_ptr[0], raw_ptr[1], size[0]) != 0)
+    {
+        printf("PNG output differs between renders\n");
+        exit(-1);
+    }
+    indigoFree(buffer_objects[0]);
+    indigoFree(buffer_objects[1]);
+
+    // Images of the same size are drawn on the surface of the previous one, which
+    // must be cleared also when there is no background
+    other = indigoLoadMoleculeFromString("c1ccccc1[N+](=O)[O-]");
+    indigoSetOptionColor("render-background-color", -1, -1, -1);
+    indigoSetOptionXY("render-image-size", 200, 200);
+    for (i = 0; i < 2; i++)
+    {
+        buffer_objects[i] = indigoWriteBuffer();
+        indigoRender(molecule, buffer_objects[i]);
+        indigoToBuffer(buffer_objects[i], &raw_ptr[i], &size[i]);
+        if (i == 0)
+        {
+            buffer_object = indigoWriteBuffer();
+            indigoRender(other, buffer_object);
+            indigoFree(buffer_object);
+        }
+    }
+    indigoSetOption("render-background-color", "255, 255, 255");
+    indigoSetOptionXY("render-image-size", -1, -1);
+    if (size[0] != size[1] || memcmp(raw_ptr[0], raw_ptr[1], size[0]) != 0)
+    {
+        printf("PNG output depends on the previous image\n");
+        exit(-1);
+    }
+
+    indigoFree(buffer_objects[0]);
+    indigoFree(buffer_objects[1]);
+    indigoFree(other);
+    indigoFree(molecule);
+}
+
+void testPrepare()
+{
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    int buffer_objects[2];
+    char* raw_ptr[2];
+    int size[2];
+    int molecule, depiction, array, buffer_object, i;
+
+    molecule = indigoLoadMoleculeFromString("CN1C=NC2=C1C(=O)N(C(=O)N2C)C");
+    depiction = indigoRenderPrepare(molecule);
+    indigoSetOption("render-output-format", "png");
+
+    // The first render records the drawing and the second one replays it
+    for (i = 0; i < 2; i++)
+    {
+        buffer_objects[i] = indigoWriteBuffer();
+        indigoRender(depiction, buffer_objects[i]);
+        indigoToBuffer(buffer_objects[i], &raw_ptr[i], &size[i]);
+    }
+    if (size[0] < 8 || memcmp(raw_ptr[0], signature, 8) != 0 || size[0] != size[1] || memcmp(raw_ptr[0], raw_ptr[1], size[0]) != 0)
+    {
+        printf("Unexpected output for a prepared depiction\n");
+        exit(-1);
+    }
+
+    indigoSetOption("render-output-format", "svg");
+    buffer_object = indigoWriteBuffer();
+    indigoRender(depiction, buffer_object);
+    indigoToBuffer(buffer_object, &raw_ptr[0], &size[0]);
+    if (!bufferContains(raw_ptr[0], size[0], "<path") || bufferContains(raw_ptr[0], size[0], "<symbol"))
+    {
+        printf("Unexpected SVG output for a prepared depiction\n");
+        exit(-1);
+    }
+    indigoFree(buffer_object);
+
+    indigoSetOption("render-output-format", "png");
+    array = indigoCreateArray();
+    indigoArrayAdd(array, depiction);
+    indigoArrayAdd(array, depiction);
+    buffer_object = indigoWriteBuffer();
+    if (indigoRenderGrid(array, NULL, 2, buffer_object) != 1)
+        exit(-1);
+
+    indigoFree(buffer_object);
+    indigoFree(array);
+    indigoFree(buffer_objects[0]);
+    indigoFree(buffer_objects[1]);
+    indigoFree(depiction);
+    indigoFree(molecule);
+}
+
+void testGridThreads()
+{
+    static const char* smiles[] = {"CN1C=NC2=C1C(=O)N(C(=O)N2C)C", "c1ccccc1[N+](=O)[O-]", "CC(=O)Oc1ccccc1C(=O)O", "OC[C@H]1OC(O)[C@H](O)[C@@H](O)[C@@H]1O",
+                                   "CN1CCC[C@H]1c2cccnc2"};
+    static const int threads[] = {0, 1, 3};
+    int buffer_objects[3];
+    char* raw_ptr[3];
+    int size[3];
+    int array, molecule, i;
+
+    array = indigoCreateArray();
+    for (i = 0; i < 10; i++)
+    {
+        molecule = indigoLoadMoleculeFromString(smiles[i % 5]);
+        indigoSetName(molecule, smiles[i % 5]);
+        indigoArrayAdd(array, molecule);
+        indigoFree(molecule);
+    }
+    indigoSetOption("render-output-format", "png");
+    indigoSetOption("render-grid-title-property", "^NAME");
+
+    // The threaded grids must be the same as the serial one. The structures
+    // are laid out again for every render, as each one works on a copy.
+    for (i = 0; i < 3; i++)
+    {
+        indigoSetOptionInt("render-grid-threads", threads[i]);
+        buffer_objects[i] = indigoWriteBuffer();
+        if (indigoRenderGrid(array, NULL, 4, buffer_objects[i]) != 1)
+            exit(-1);
+        indigoToBuffer(buffer_objects[i], &raw_ptr[i], &size[i]);
+    }
+    indigoSetOptionInt("render-grid-threads", 0);
+
+    for (i = 1; i < 3; i++)
+    {
+        if (size[0] != size[i] || memcmp(raw_ptr[0], raw_ptr[i], size[0]) != 0)
+        {
+            printf("Grid rendered with %d threads differs from the serial one\n", threads[i]);
+            exit(-1);
+        }
+    }
+
+    for (i = 0; i < 3; i++)
+        indigoFree(buffer_objects[i]);
+    indigoFree(array);
+}
+
+void testGridPages()
+{
+    int buffer_object, array, iterator, molecule, i;
+    char* raw_ptr;
+    int size;
+
+    array = indigoCreateArray();
+    for (i = 0; i < 10; i++)
+    {
+        molecule = indigoLoadMoleculeFromString(i % 2 ? "c1ccccc1[N+](=O)[O-]" : "CN1CCC[C@H]1c2cccnc2");
+        indigoArrayAdd(array, molecule);
+        indigoFree(molecule);
+    }
+    indigoSetOption("render-output-format", "pdf");
+
+    // 2 x 2 objects per page
+    buffer_object = indigoWriteBuffer();
+    iterator = indigoIterateArray(array);
+    if (indigoRenderGridPages(iterator, 2, 2, buffer_object) != 3)
+    {
+        printf("Wrong number of grid pages\n");
+        exit(-1);
+    }
+    indigoToBuffer(buffer_object, &raw_ptr, &size);
+    if (size < 8 || memcmp(raw_ptr, "%PDF", 4) != 0 || memcmp(raw_ptr + size - 6, "%%EOF", 5) != 0)
+    {
+        printf("Grid pages are not a complete PDF document\n");
+        exit(-1);
+    }
+
+    indigoFree(iterator);
+    indigoFree(buffer_object);
+    indigoFree(array);
+}
+
 int main(void)
 {
     int m;
@@ -66,5 +298,10 @@ int main(void)
     indigoRenderToFile(m, "indigo-renderer-test.png");
 
     testHDC();
+    testSVG();
+    testPNG();
+    testPrepare();
+    testGridThreads();
+    testGridPages();
     return 0;
 }
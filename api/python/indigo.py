@@ -805,6 +805,13 @@ class IndigoObject(object):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoClean2d(self.id))
 
+    def clean2dIncremental(self, atoms):
+        arr2 = (c_int * len(atoms))()
+        for i in range(len(atoms)):
+            arr2[i] = atoms[i]
+        self.dispatcher._setSessionId()
+        return self.dispatcher._checkResult(Indigo._lib.indigoClean2dIncremental(self.id, len(arr2), arr2))
+
     def resetCharge(self):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoResetCharge(self.id))
@@ -1275,6 +1282,22 @@ class IndigoObject(object):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoCount(self.id))
 
+    def descriptorColumn(self, column):
+        self.dispatcher._setSessionId()
+        count = self.dispatcher._checkResult(Indigo._lib.indigoCount(self.id))
+        values = Indigo._lib.indigoDescriptorColumn(self.id, column)
+        if values is None:
+            raise IndigoException(Indigo._lib.indigoGetLastError())
+        return [values[i] for i in range(count)]
+
+    def descriptorString(self, column, row):
+        self.dispatcher._setSessionId()
+        return self.dispatcher._checkResultString(Indigo._lib.indigoDescriptorString(self.id, column, row))
+
+    def descriptorError(self, row):
+        self.dispatcher._setSessionId()
+        return self.dispatcher._checkResultString(Indigo._lib.indigoDescriptorError(self.id, row))
+
     def clear(self):
         self.dispatcher._setSessionId()
         return self.dispatcher._checkResult(Indigo._lib.indigoClear(self.id))
@@ -1679,6 +1702,22 @@ class Indigo(object):
         Indigo._lib.indigoReactionProductEnumerate.argtypes = [c_int, c_int]
         Indigo._lib.indigoTransform.restype = c_int
         Indigo._lib.indigoTransform.argtypes = [c_int, c_int]
+        Indigo._lib.indigoCreateTransformSet.restype = c_int
+        Indigo._lib.indigoCreateTransformSet.argtypes = [c_int]
+        Indigo._lib.indigoApplyTransformSet.restype = c_int
+        Indigo._lib.indigoApplyTransformSet.argtypes = [c_int, c_int]
+        Indigo._lib.indigoIterateTransformSet.restype = c_int
+        Indigo._lib.indigoIterateTransformSet.argtypes = [c_int, c_int, c_int]
+        Indigo._lib.indigoLayoutBatch.restype = c_int
+        Indigo._lib.indigoLayoutBatch.argtypes = [c_int, c_int, c_int]
+        Indigo._lib.indigoComputeDescriptors.restype = c_int
+        Indigo._lib.indigoComputeDescriptors.argtypes = [c_int, c_char_p, c_int]
+        Indigo._lib.indigoDescriptorColumn.restype = POINTER(c_double)
+        Indigo._lib.indigoDescriptorColumn.argtypes = [c_int, c_int]
+        Indigo._lib.indigoDescriptorString.restype = c_char_p
+        Indigo._lib.indigoDescriptorString.argtypes = [c_int, c_int, c_int]
+        Indigo._lib.indigoDescriptorError.restype = c_char_p
+        Indigo._lib.indigoDescriptorError.argtypes = [c_int, c_int]
         Indigo._lib.indigoDbgBreakpoint.restype = None
         Indigo._lib.indigoDbgBreakpoint.argtypes = None
         Indigo._lib.indigoClone.restype = c_int
@@ -2151,6 +2190,8 @@ class Indigo(object):
         Indigo._lib.indigoLayout.argtypes = [c_int]
         Indigo._lib.indigoClean2d.restype = c_int
         Indigo._lib.indigoClean2d.argtypes = [c_int]
+        Indigo._lib.indigoClean2dIncremental.restype = c_int
+        Indigo._lib.indigoClean2dIncremental.argtypes = [c_int, c_int, POINTER(c_int)]
         Indigo._lib.indigoSmiles.restype = c_char_p
         Indigo._lib.indigoSmiles.argtypes = [c_int]
         Indigo._lib.indigoSmarts.restype = c_char_p
@@ -2245,6 +2286,10 @@ class Indigo(object):
         Indigo._lib.indigoMapMolecule.argtypes = [c_int, c_int]
         Indigo._lib.indigoIterateTautomers.restype = c_int
         Indigo._lib.indigoIterateTautomers.argtypes = [c_int, c_char_p]
+        Indigo._lib.indigoCanonicalTautomer.restype = c_int
+        Indigo._lib.indigoCanonicalTautomer.argtypes = [c_int, c_char_p]
+        Indigo._lib.indigoTautomerHash.restype = c_char_p
+        Indigo._lib.indigoTautomerHash.argtypes = [c_int, c_char_p]
         Indigo._lib.indigoAllScaffolds.restype = c_int
         Indigo._lib.indigoAllScaffolds.argtypes = [c_int]
         Indigo._lib.indigoDecomposedMoleculeScaffold.restype = c_int
@@ -2676,6 +2721,27 @@ class Indigo(object):
         else:
             return self.IndigoObject(self, newobj, self)
 
+    def createTransformSet(self, reactions):
+        self._setSessionId()
+        reactions = self.convertToArray(reactions)
+        return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoCreateTransformSet(reactions.id)))
+
+    def applyTransformSet(self, transform_set, monomers):
+        self._setSessionId()
+        return self._checkResult(Indigo._lib.indigoApplyTransformSet(transform_set.id, monomers.id))
+
+    def iterateTransformSet(self, transform_set, monomers, threads=-1):
+        self._setSessionId()
+        return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoIterateTransformSet(transform_set.id, monomers.id, threads)), [transform_set, monomers])
+
+    def layoutBatch(self, objects, threads=-1, timeout=0):
+        self._setSessionId()
+        return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoLayoutBatch(objects.id, threads, timeout)))
+
+    def computeDescriptors(self, source, descriptors, threads=-1):
+        self._setSessionId()
+        return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoComputeDescriptors(source.id, descriptors.encode(ENCODE_ENCODING), threads)))
+
     def loadBuffer(self, buf):
         buf = list(buf)
         values = (c_byte * len(buf))()
@@ -2727,6 +2793,18 @@ class Indigo(object):
         self._setSessionId()
         return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoIterateTautomers(molecule.id, params.encode(ENCODE_ENCODING))), molecule)
 
+    def canonicalTautomer(self, molecule, params=''):
+        if params is None:
+            params = ''
+        self._setSessionId()
+        return self.IndigoObject(self, self._checkResult(Indigo._lib.indigoCanonicalTautomer(molecule.id, params.encode(ENCODE_ENCODING))))
+
+    def tautomerHash(self, molecule, params=''):
+        if params is None:
+            params = ''
+        self._setSessionId()
+        return self._checkResultString(Indigo._lib.indigoTautomerHash(molecule.id, params.encode(ENCODE_ENCODING)))
+
     def nameToStructure(self, name, params=None):
         """
         Converts a chemical name into a corresponding structure
@@ -54,6 +54,8 @@ void Indigo::init()
     deconvolution_aromatization = true;
     deco_save_ap_bond_orders = false;
     deco_ignore_errors = true;
+    deco_first_embedding_only = false;
+    deco_threads = 0;
     molfile_saving_mode = 0;
     molfile_saving_no_chiral = false;
     molfile_saving_chiral_flag = -1;
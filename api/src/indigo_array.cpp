@@ -94,6 +94,11 @@ MonomersProperties& IndigoArrayElement::getMonomersProperties()
     return array->objects[idx]->getMonomersProperties();
 }
 
+PropertiesMap& IndigoArrayElement::getProperties()
+{
+    return array->objects[idx]->getProperties();
+}
+
 BaseReaction& IndigoArrayElement::getBaseReaction()
 {
     return array->objects[idx]->getBaseReaction();
@@ -146,6 +151,32 @@ bool IndigoArrayIter::hasNext()
     return _idx + 1 < _arr->objects.size();
 }
 
+IndigoItemReader::IndigoItemReader(IndigoObject& source) : _source(source), _idx(0), _finished(false)
+{
+}
+
+IndigoObject* IndigoItemReader::next()
+{
+    _item.free();
+    if (_finished)
+        return nullptr;
+
+    if (IndigoArray::is(_source))
+    {
+        IndigoArray& arr = IndigoArray::cast(_source);
+        if (_idx < arr.objects.size())
+            return arr.objects[_idx++];
+    }
+    else
+    {
+        _item.reset(_source.next());
+        if (_item.get() != nullptr)
+            return _item.get();
+    }
+    _finished = true;
+    return nullptr;
+}
+
 CEXPORT int indigoCreateArray()
 {
     INDIGO_BEGIN
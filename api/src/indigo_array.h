@@ -54,6 +54,7 @@ public:
     virtual QueryMolecule& getQueryMolecule();
 
     virtual MonomersProperties& getMonomersProperties();
+    virtual PropertiesMap& getProperties();
     virtual BaseReaction& getBaseReaction();
     virtual Reaction& getReaction();
 
@@ -81,6 +82,24 @@ protected:
     int _idx;
 };
 
+// Reads the items of an array or an iterator in their order. Batch functions
+// use it to take the next part of their input.
+class IndigoItemReader
+{
+public:
+    IndigoItemReader(IndigoObject& source);
+
+    // Returns the next item or nullptr at the end of the source. The item
+    // is valid until the next call.
+    IndigoObject* next();
+
+protected:
+    IndigoObject& _source;
+    AutoPtr<IndigoObject> _item;
+    int _idx;
+    bool _finished;
+};
+
 #ifdef _WIN32
 #pragma warning(pop)
 #endif
@@ -20,6 +20,7 @@
 #include "base_cpp/array.h"
 #include "base_cpp/obj_array.h"
 #include "base_cpp/obj_list.h"
+#include "base_cpp/os_thread_wrapper.h"
 #include "base_cpp/red_black.h"
 #include "base_cpp/tlscont.h"
 #include "graph/automorphism_search.h"
@@ -39,8 +40,8 @@
 IMPL_ERROR(IndigoDeconvolution, "R-Group deconvolution");
 
 IndigoDeconvolution::IndigoDeconvolution()
-    : IndigoObject(IndigoObject::DECONVOLUTION), save_ap_bond_orders(false), ignore_errors(false), aromatize(true), cbEmbedding(0), embeddingUserdata(0),
-      _userDefinedScaffold(false)
+    : IndigoObject(IndigoObject::DECONVOLUTION), save_ap_bond_orders(false), ignore_errors(false), aromatize(true), first_embedding_only(false), cbEmbedding(0),
+      embeddingUserdata(0), _userDefinedScaffold(false)
 {
 }
 
@@ -98,61 +99,194 @@ void IndigoDeconvolution::setScaffold(QueryMolecule& scaffold)
     }
 }
 
-void IndigoDeconvolution::makeRGroups(QueryMolecule& scaffold)
+//
+// Parallel scaffold matching
+//
+
+class IndigoDeconvolutionCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result);
+
+    // Each command has its own copy of the scaffold, because
+    // the matching caches some data in the query molecule
+    QueryMolecule scaffold;
+    IndigoDeconvolution* deco;
+    AromaticityOptions* arom_options;
+
+    IndigoDeconvolutionElem* elem;
+    int index;
+};
+
+class IndigoDeconvolutionResult : public OsCommandResult
+{
+public:
+    virtual void clear()
+    {
+        index = -1;
+        error.clear();
+    }
+
+    int index;
+    Array<char> error;
+};
+
+class IndigoDeconvolutionDispatcher : public OsCommandDispatcher
+{
+public:
+    IndigoDeconvolutionDispatcher(IndigoDeconvolution& deco, AromaticityOptions& arom_options, ObjArray<Array<char>>& errors)
+        : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _deco(deco), _arom_options(arom_options), _errors(errors), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<IndigoDeconvolutionCommand> command(new IndigoDeconvolutionCommand());
+        command->scaffold.clone_KeepIndices(_deco.getScaffold(), 0);
+        command->deco = &_deco;
+        command->arom_options = &_arom_options;
+        return command.release();
+    }
+
+    virtual OsCommandResult* _allocateResult()
+    {
+        return new IndigoDeconvolutionResult();
+    }
+
+    virtual bool _setupCommand(OsCommand& command_)
+    {
+        if (_next >= _deco.getItems().size())
+            return false;
+
+        IndigoDeconvolutionCommand& command = (IndigoDeconvolutionCommand&)command_;
+        command.index = _next;
+        command.elem = &_deco.getItems()[_next];
+        _next++;
+        return true;
+    }
+
+    virtual void _handleResult(OsCommandResult& result_)
+    {
+        IndigoDeconvolutionResult& result = (IndigoDeconvolutionResult&)result_;
+        if (result.error.size() > 0)
+            _errors[result.index].copy(result.error);
+    }
+
+private:
+    IndigoDeconvolution& _deco;
+    AromaticityOptions& _arom_options;
+    ObjArray<Array<char>>& _errors;
+    int _next;
+};
+
+void IndigoDeconvolutionCommand::execute(OsCommandResult& result_)
+{
+    IndigoDeconvolutionResult& result = (IndigoDeconvolutionResult&)result_;
+    result.index = index;
+
+    try
+    {
+        deco->matchScaffold(*elem, scaffold, false, *arom_options);
+    }
+    catch (Exception& e)
+    {
+        result.error.readString(e.message(), true);
+    }
+    /*
+     * Aromaticity matcher refers to the scaffold copy of this command
+     */
+    elem->deco_enum.am.reset(0);
+}
+
+void IndigoDeconvolution::makeRGroups(QueryMolecule& scaffold, int threads)
 {
 
     setScaffold(scaffold);
 
+    if (threads == 0)
+    {
+        for (int mol_idx = 0; mol_idx < _deconvolutionElems.size(); ++mol_idx)
+        {
+            IndigoDeconvolutionElem& elem = _deconvolutionElems[mol_idx];
+            makeRGroup(elem, false, true);
+        }
+        return;
+    }
+
+    if (_fullScaffold.vertexCount() == 0)
+        throw Error("error: scaffold vertex count equals 0");
+
+    /*
+     * Embeddings are found in parallel, but the full scaffold depends on
+     * the order of the molecules, so R-groups are created sequentially
+     */
+    ObjArray<Array<char>> errors;
+    for (int mol_idx = 0; mol_idx < _deconvolutionElems.size(); ++mol_idx)
+        errors.push();
+
+    AromaticityOptions arom_options = indigoGetInstance().arom_options;
+    IndigoDeconvolutionDispatcher dispatcher(*this, arom_options, errors);
+    dispatcher.run(threads);
+
     for (int mol_idx = 0; mol_idx < _deconvolutionElems.size(); ++mol_idx)
     {
+        /*
+         * Report the error of the first failed molecule, as the sequential mode does
+         */
+        if (errors[mol_idx].size() > 0)
+            throw Exception("%s", errors[mol_idx].ptr());
+
         IndigoDeconvolutionElem& elem = _deconvolutionElems[mol_idx];
-        makeRGroup(elem, false, true);
+        if (elem.deco_enum.contexts.size() > 0)
+            _buildRGroups(elem, true);
     }
 }
 
 void IndigoDeconvolution::makeRGroup(IndigoDeconvolutionElem& elem, bool all_matches, bool change_scaffold)
 {
-
     if (_fullScaffold.vertexCount() == 0)
         throw Error("error: scaffold vertex count equals 0");
 
+    Indigo& indigo = indigoGetInstance();
+    if (matchScaffold(elem, _scaffold, all_matches, indigo.arom_options))
+        _buildRGroups(elem, change_scaffold);
+}
+
+bool IndigoDeconvolution::matchScaffold(IndigoDeconvolutionElem& elem, QueryMolecule& scaffold, bool all_matches, const AromaticityOptions& arom_options)
+{
     Molecule& mol_in = elem.mol_in;
 
     DecompositionEnumerator& deco_enum = elem.deco_enum;
     if (mol_in.vertexCount() == 0)
     {
         deco_enum.contexts.clear();
-        return;
+        return false;
     }
 
     if (aromatize)
-    {
-        Indigo& indigo = indigoGetInstance();
-        MoleculeAromatizer::aromatizeBonds(mol_in, indigo.arom_options);
-    }
+        MoleculeAromatizer::aromatizeBonds(mol_in, arom_options);
 
     /*
      * Set enumerator parameters
      */
-    if (aromatize && AromaticityMatcher::isNecessary(_scaffold))
-    {
-        Indigo& indigo = indigoGetInstance();
-        deco_enum.am.reset(new AromaticityMatcher(_scaffold, mol_in, indigo.arom_options));
-    }
+    if (aromatize && AromaticityMatcher::isNecessary(scaffold))
+        deco_enum.am.reset(new AromaticityMatcher(scaffold, mol_in, arom_options));
 
     deco_enum.fmcache.reset(new MoleculeSubstructureMatcher::FragmentMatchCache);
     deco_enum.fmcache->clear();
     deco_enum.all_matches = all_matches;
     deco_enum.remove_rsites = _userDefinedScaffold;
+    deco_enum.skip_automorphisms = first_embedding_only;
     deco_enum.contexts.clear();
     deco_enum.deco = this;
-    deco_enum.calculateAutoMaps(_scaffold);
+    deco_enum.calculateAutoMaps(scaffold);
 
     /*
      * Create substructure enumerator and set up options
      */
     EmbeddingEnumerator emb_enum(mol_in);
-    emb_enum.setSubgraph(_scaffold);
+    emb_enum.setSubgraph(scaffold);
     emb_enum.cb_embedding = _rGroupsEmbedding;
     emb_enum.cb_match_edge = _matchBonds;
     emb_enum.cb_match_vertex = _matchAtoms;
@@ -167,26 +301,28 @@ void IndigoDeconvolution::makeRGroup(IndigoDeconvolutionElem& elem, bool all_mat
     if (deco_enum.contexts.size() == 0)
     {
         if (ignore_errors)
-        {
-            return;
-        }
+            return false;
         else
             throw Error("no embeddings obtained");
     }
-    else
+    return true;
+}
+
+void IndigoDeconvolution::_buildRGroups(IndigoDeconvolutionElem& elem, bool change_scaffold)
+{
+    DecompositionEnumerator& deco_enum = elem.deco_enum;
+
+    for (int match_idx = 0; match_idx < deco_enum.contexts.size(); ++match_idx)
     {
-        for (int match_idx = 0; match_idx < deco_enum.contexts.size(); ++match_idx)
-        {
-            IndigoDecompositionMatch& deco_match = deco_enum.contexts[match_idx];
-            deco_match.mol_out.clone_KeepIndices(mol_in);
+        IndigoDecompositionMatch& deco_match = deco_enum.contexts[match_idx];
+        deco_match.mol_out.clone_KeepIndices(elem.mol_in);
 
-            createRgroups(deco_match, change_scaffold);
+        createRgroups(deco_match, change_scaffold);
 
-            deco_match.mol_scaffold.makeEdgeSubmolecule(deco_match.mol_out, deco_match.scaffoldAtoms, deco_match.scaffoldBonds, 0, 0);
-            deco_match.mol_scaffold.unhighlightAll();
+        deco_match.mol_scaffold.makeEdgeSubmolecule(deco_match.mol_out, deco_match.scaffoldAtoms, deco_match.scaffoldBonds, 0, 0);
+        deco_match.mol_scaffold.unhighlightAll();
 
-            deco_match.mol_out.highlightSubmolecule(_scaffold, deco_match.lastMapping.ptr(), true);
-        }
+        deco_match.mol_out.highlightSubmolecule(_scaffold, deco_match.lastMapping.ptr(), true);
     }
 }
 
@@ -1246,6 +1382,8 @@ void IndigoDeconvolution::DecompositionEnumerator::calculateAutoMaps(Graph& sub)
     {
         d_map[i] = i;
     }
+    if (skip_automorphisms)
+        return;
     /*
      * Search automorphisms if the scaffold not user-defined
      */
@@ -1295,6 +1433,8 @@ void IndigoDeconvolution::DecompositionEnumerator::addMatch(IndigoDecompositionM
      * Add match itself
      */
     contexts.push().copy(match);
+    if (skip_automorphisms)
+        return;
     /*
      * Add all other automorphisms matches
      */
@@ -1573,6 +1713,7 @@ AutoPtr<IndigoDeconvolution> deco(new IndigoDeconvolution());
 deco->save_ap_bond_orders = self.deco_save_ap_bond_orders;
 deco->ignore_errors = self.deco_ignore_errors;
 deco->aromatize = self.deconvolution_aromatization;
+deco->first_embedding_only = self.deco_first_embedding_only;
 int i;
 
 for (i = 0; i < mol_array.objects.size(); i++)
@@ -1586,7 +1727,7 @@ for (i = 0; i < mol_array.objects.size(); i++)
 
 QueryMolecule& scaf = self.getObject(scaffold).getQueryMolecule();
 
-deco->makeRGroups(scaf);
+deco->makeRGroups(scaf, self.deco_threads);
 return self.addObject(deco.release());
 }
 INDIGO_END(-1)
@@ -1776,6 +1917,7 @@ CEXPORT int indigoCreateDecomposer(int scaffold){INDIGO_BEGIN{AutoPtr<IndigoDeco
 deco->save_ap_bond_orders = self.deco_save_ap_bond_orders;
 deco->ignore_errors = self.deco_ignore_errors;
 deco->aromatize = self.deconvolution_aromatization;
+deco->first_embedding_only = self.deco_first_embedding_only;
 
 QueryMolecule& scaf = self.getObject(scaffold).getQueryMolecule();
 
@@ -52,13 +52,26 @@ public:
     void addMolecule(Molecule& mol, PropertiesMap& props, int idx);
 
     void setScaffold(QueryMolecule& scaffold);
-    void makeRGroups(QueryMolecule& scaffold);
+    /*
+     * Decompose all the added molecules. If threads is not zero then the scaffold is
+     * matched in parallel, and the R-groups are assigned afterwards in the input order
+     */
+    void makeRGroups(QueryMolecule& scaffold, int threads = 0);
     void makeRGroup(IndigoDeconvolutionElem& elem, bool all_matches, bool change_scaffold);
+    /*
+     * Find the scaffold embeddings for the molecule. Does not change the deconvolution,
+     * so it can be called from several threads, each with its own copy of the scaffold
+     */
+    bool matchScaffold(IndigoDeconvolutionElem& elem, QueryMolecule& scaffold, bool all_matches, const AromaticityOptions& arom_options);
 
     QueryMolecule& getDecomposedScaffold()
     {
         return _fullScaffold;
     }
+    QueryMolecule& getScaffold()
+    {
+        return _scaffold;
+    }
     ObjArray<IndigoDeconvolutionElem>& getItems()
     {
         return _deconvolutionElems;
@@ -75,6 +88,11 @@ public:
      * Aromatize
      */
     bool aromatize;
+    /*
+     * Do not search for the scaffold automorphisms. Faster, but gives the same
+     * result only for the scaffolds without symmetry
+     */
+    bool first_embedding_only;
 
     int (*cbEmbedding)(const int* sub_vert_map, const int* sub_edge_map, const void* info, void* userdata);
     void* embeddingUserdata;
@@ -83,7 +101,7 @@ public:
     class DecompositionEnumerator
     {
     public:
-        DecompositionEnumerator() : all_matches(false), remove_rsites(false), deco(0)
+        DecompositionEnumerator() : all_matches(false), remove_rsites(false), skip_automorphisms(false), deco(0)
         {
         }
         ~DecompositionEnumerator()
@@ -99,6 +117,7 @@ public:
 
         bool all_matches;
         bool remove_rsites;
+        bool skip_automorphisms;
         IndigoDeconvolution* deco;
         ObjArray<IndigoDecompositionMatch> contexts;
 
@@ -123,6 +142,7 @@ private:
     void _parseOptions(const char* options);
 
     void _addFullRGroup(IndigoDecompositionMatch& deco_match, Array<int>& auto_map, int rg_idx, int new_rg_idx);
+    void _buildRGroups(IndigoDeconvolutionElem& elem, bool change_scaffold);
 
     static int _rGroupsEmbedding(Graph& g1, Graph& g2, int* core1, int* core2, void* userdata);
 
@@ -0,0 +1,476 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "indigo_descriptors.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "base_cpp/scanner.h"
+#include "indigo_array.h"
+#include "indigo_molecule.h"
+#include "molecule/elements.h"
+#include "molecule/molecule_gross_formula.h"
+#include "molecule/molecule_mass.h"
+
+#include <cmath>
+#include <limits>
+
+// Number of molecules that are read from the source and processed at once
+static const int _DESCRIPTORS_BATCH_SIZE = 1000;
+
+static const struct
+{
+    const char* name;
+    int type;
+} _descriptor_names[] = {{"mw", DESCRIPTOR_MW},
+                         {"mono", DESCRIPTOR_MONO},
+                         {"most_abundant", DESCRIPTOR_MOST_ABUNDANT},
+                         {"nominal", DESCRIPTOR_NOMINAL},
+                         {"formula", DESCRIPTOR_FORMULA},
+                         {"composition", DESCRIPTOR_COMPOSITION},
+                         {"atoms", DESCRIPTOR_ATOMS},
+                         {"bonds", DESCRIPTOR_BONDS},
+                         {"heavy_atoms", DESCRIPTOR_HEAVY_ATOMS},
+                         {"hydrogens", DESCRIPTOR_HYDROGENS},
+                         {"components", DESCRIPTOR_COMPONENTS},
+                         {"sssr", DESCRIPTOR_SSSR}};
+
+//
+// IndigoDescriptorTable
+//
+
+IndigoDescriptorTable::IndigoDescriptorTable() : IndigoObject(DESCRIPTOR_TABLE), _rows(0)
+{
+}
+
+IndigoDescriptorTable::~IndigoDescriptorTable()
+{
+}
+
+IndigoDescriptorTable& IndigoDescriptorTable::cast(IndigoObject& obj)
+{
+    if (obj.type == IndigoObject::DESCRIPTOR_TABLE)
+        return (IndigoDescriptorTable&)obj;
+    throw IndigoError("%s is not a descriptor table", obj.debugInfo());
+}
+
+bool IndigoDescriptorTable::isStringDescriptor(int type)
+{
+    return type == DESCRIPTOR_FORMULA || type == DESCRIPTOR_COMPOSITION;
+}
+
+void IndigoDescriptorTable::parseDescriptors(const char* descriptors)
+{
+    if (descriptors == 0)
+        throw IndigoError("indigoComputeDescriptors(): zero string pointer");
+
+    BufferScanner scanner(descriptors);
+    QS_DEF(Array<char>, word);
+
+    types.clear();
+    while (true)
+    {
+        scanner.skipSpace();
+        if (scanner.isEOF())
+            break;
+
+        scanner.readWord(word, ";");
+        word.pop();
+        if (!scanner.isEOF())
+            scanner.skip(1);
+
+        // Trim trailing spaces
+        while (word.size() > 0 && isspace(word.top()))
+            word.pop();
+        if (word.size() == 0)
+            continue;
+        word.push(0);
+
+        int i, n = sizeof(_descriptor_names) / sizeof(_descriptor_names[0]);
+        for (i = 0; i < n; i++)
+            if (strcasecmp(word.ptr(), _descriptor_names[i].name) == 0)
+                break;
+        if (i == n)
+            throw IndigoError("indigoComputeDescriptors(): unknown descriptor '%s'", word.ptr());
+        types.push(_descriptor_names[i].type);
+    }
+
+    if (types.size() == 0)
+        throw IndigoError("indigoComputeDescriptors(): no descriptors given");
+
+    _numbers.clear();
+    _string_offsets.clear();
+    _strings.clear();
+    for (int i = 0; i < types.size(); i++)
+    {
+        _numbers.push();
+        _string_offsets.push();
+        _strings.push();
+    }
+    _rows = 0;
+    _error_offsets.clear();
+    _errors.clear();
+}
+
+int IndigoDescriptorTable::rowCount() const
+{
+    return _rows;
+}
+
+int IndigoDescriptorTable::columnCount() const
+{
+    return types.size();
+}
+
+void IndigoDescriptorTable::_checkColumn(int column)
+{
+    if (column < 0 || column >= types.size())
+        throw IndigoError("descriptor table: column index %d is out of range [0, %d)", column, types.size());
+}
+
+void IndigoDescriptorTable::_checkRow(int row)
+{
+    if (row < 0 || row >= _rows)
+        throw IndigoError("descriptor table: row index %d is out of range [0, %d)", row, _rows);
+}
+
+int IndigoDescriptorTable::addRows(int count)
+{
+    int first = _rows;
+    _rows += count;
+
+    for (int i = 0; i < types.size(); i++)
+    {
+        if (isStringDescriptor(types[i]))
+            _string_offsets[i].expandFill(_rows, -1);
+        else
+            _numbers[i].expandFill(_rows, std::numeric_limits<double>::quiet_NaN());
+    }
+    _error_offsets.expandFill(_rows, -1);
+    return first;
+}
+
+const double* IndigoDescriptorTable::getColumn(int column)
+{
+    _checkColumn(column);
+    if (isStringDescriptor(types[column]))
+        throw IndigoError("descriptor table: column %d is not numeric", column);
+    return _numbers[column].ptr();
+}
+
+double* IndigoDescriptorTable::getColumnForWrite(int column)
+{
+    return _numbers[column].ptr();
+}
+
+const char* IndigoDescriptorTable::getString(int column, int row)
+{
+    _checkColumn(column);
+    _checkRow(row);
+    if (!isStringDescriptor(types[column]))
+        throw IndigoError("descriptor table: column %d is not a string one", column);
+
+    int offset = _string_offsets[column][row];
+    if (offset < 0)
+        return "";
+    return _strings[column].ptr() + offset;
+}
+
+const char* IndigoDescriptorTable::getError(int row)
+{
+    _checkRow(row);
+    int offset = _error_offsets[row];
+    if (offset < 0)
+        return "";
+    return _errors.ptr() + offset;
+}
+
+void IndigoDescriptorTable::setString(int column, int row, const char* str)
+{
+    _string_offsets[column][row] = _strings[column].size();
+    _strings[column].concat(str, (int)strlen(str) + 1);
+}
+
+void IndigoDescriptorTable::setError(int row, const char* message)
+{
+    _error_offsets[row] = _errors.size();
+    _errors.concat(message, (int)strlen(message) + 1);
+}
+
+//
+// Parallel descriptor calculation
+//
+
+struct IndigoDescriptorParams
+{
+    MassOptions mass_options;
+    bool add_isotopes;
+    bool add_rsites;
+};
+
+class IndigoDescriptorCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result);
+
+    const Array<int>* types;
+    const IndigoDescriptorParams* params;
+
+    Molecule* molecule;
+    int index;
+};
+
+class IndigoDescriptorResult : public OsCommandResult
+{
+public:
+    virtual void clear()
+    {
+        index = -1;
+        values.clear();
+        strings.clear();
+        error.clear();
+    }
+
+    int index;
+    Array<double> values;
+    ObjArray<Array<char>> strings;
+    Array<char> error;
+};
+
+class IndigoDescriptorDispatcher : public OsCommandDispatcher
+{
+public:
+    IndigoDescriptorDispatcher(IndigoDescriptorTable& table, IndigoDescriptorParams& params, PtrArray<IndigoMolecule>& batch, int first_row)
+        : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _table(table), _params(params), _batch(batch), _first_row(first_row), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<IndigoDescriptorCommand> command(new IndigoDescriptorCommand());
+        command->types = &_table.types;
+        command->params = &_params;
+        return command.release();
+    }
+
+    virtual OsCommandResult* _allocateResult()
+    {
+        return new IndigoDescriptorResult();
+    }
+
+    virtual bool _setupCommand(OsCommand& command_)
+    {
+        if (_next >= _batch.size())
+            return false;
+
+        IndigoDescriptorCommand& command = (IndigoDescriptorCommand&)command_;
+        command.index = _next;
+        command.molecule = &_batch[_next]->mol;
+        _next++;
+        return true;
+    }
+
+    // Results are handled in the dispatcher thread, so the table is never written concurrently
+    virtual void _handleResult(OsCommandResult& result_)
+    {
+        IndigoDescriptorResult& result = (IndigoDescriptorResult&)result_;
+        int row = _first_row + result.index;
+
+        for (int i = 0; i < _table.types.size(); i++)
+        {
+            if (IndigoDescriptorTable::isStringDescriptor(_table.types[i]))
+            {
+                if (result.strings[i].size() > 0)
+                    _table.setString(i, row, result.strings[i].ptr());
+            }
+            else
+                _table.getColumnForWrite(i)[row] = result.values[i];
+        }
+        if (result.error.size() > 0)
+            _table.setError(row, result.error.ptr());
+    }
+
+private:
+    IndigoDescriptorTable& _table;
+    IndigoDescriptorParams& _params;
+    PtrArray<IndigoMolecule>& _batch;
+    int _first_row;
+    int _next;
+};
+
+static double _computeNumericDescriptor(Molecule& mol, int type, MoleculeMass& mass)
+{
+    switch (type)
+    {
+    case DESCRIPTOR_MW:
+        return mass.molecularWeight(mol);
+    case DESCRIPTOR_MONO:
+        return mass.monoisotopicMass(mol);
+    case DESCRIPTOR_MOST_ABUNDANT:
+        return mass.mostAbundantMass(mol);
+    case DESCRIPTOR_NOMINAL:
+        return mass.nominalMass(mol);
+    case DESCRIPTOR_ATOMS:
+        return mol.vertexCount();
+    case DESCRIPTOR_BONDS:
+        return mol.edgeCount();
+    case DESCRIPTOR_HEAVY_ATOMS: {
+        int count = 0;
+        for (auto i : mol.vertices())
+            if (!mol.possibleAtomNumber(i, ELEM_H))
+                count++;
+        return count;
+    }
+    case DESCRIPTOR_HYDROGENS: {
+        int count = 0;
+        for (auto i : mol.vertices())
+        {
+            if (mol.getAtomNumber(i) == ELEM_H)
+                count++;
+            else if (!mol.isPseudoAtom(i) && !mol.isRSite(i))
+                count += mol.getImplicitH(i);
+        }
+        return count;
+    }
+    case DESCRIPTOR_COMPONENTS:
+        return mol.countComponents();
+    case DESCRIPTOR_SSSR:
+        return mol.sssrCount();
+    }
+    throw IndigoError("unknown descriptor type %d", type);
+}
+
+void IndigoDescriptorCommand::execute(OsCommandResult& result_)
+{
+    IndigoDescriptorResult& result = (IndigoDescriptorResult&)result_;
+    result.index = index;
+
+    Molecule& mol = *molecule;
+
+    // Implicit hydrogens are needed by most of the descriptors, and
+    // they are cached by the molecule after the first calculation
+    for (auto i : mol.vertices())
+    {
+        if (!mol.isPseudoAtom(i) && !mol.isRSite(i) && !mol.isTemplateAtom(i))
+            mol.getImplicitH_NoThrow(i, -1);
+    }
+
+    MoleculeMass mass;
+    mass.mass_options = params->mass_options;
+
+    for (int i = 0; i < types->size(); i++)
+    {
+        int type = types->at(i);
+        double value = std::numeric_limits<double>::quiet_NaN();
+        Array<char>& str = result.strings.push();
+
+        try
+        {
+            if (type == DESCRIPTOR_FORMULA)
+            {
+                auto gross = MoleculeGrossFormula::collect(mol, params->add_isotopes);
+                MoleculeGrossFormula::toString_Hill(*gross, str, params->add_rsites);
+                if (str.size() == 0 || str.top() != 0)
+                    str.push(0);
+            }
+            else if (type == DESCRIPTOR_COMPOSITION)
+            {
+                mass.massComposition(mol, str);
+                if (str.size() == 0 || str.top() != 0)
+                    str.push(0);
+            }
+            else
+                value = _computeNumericDescriptor(mol, type, mass);
+        }
+        catch (Exception& e)
+        {
+            str.clear();
+            // The first error is reported for the row
+            if (result.error.size() == 0)
+                result.error.readString(e.message(), true);
+        }
+        result.values.push(value);
+    }
+}
+
+//
+// API
+//
+
+CEXPORT int indigoComputeDescriptors(int source, const char* descriptors, int threads)
+{
+    INDIGO_BEGIN
+    {
+        IndigoObject& obj = self.getObject(source);
+
+        AutoPtr<IndigoDescriptorTable> table(new IndigoDescriptorTable());
+        table->parseDescriptors(descriptors);
+
+        IndigoDescriptorParams params;
+        params.mass_options = self.mass_options;
+        params.add_isotopes = self.gross_formula_options.add_isotopes;
+        params.add_rsites = self.gross_formula_options.add_rsites;
+
+        PtrArray<IndigoMolecule> batch;
+        IndigoItemReader reader(obj);
+        IndigoObject* item;
+
+        while (true)
+        {
+            batch.clear();
+            while (batch.size() < _DESCRIPTORS_BATCH_SIZE && (item = reader.next()) != nullptr)
+                batch.add(IndigoMolecule::cloneFrom(*item));
+
+            if (batch.size() == 0)
+                break;
+
+            int first_row = table->addRows(batch.size());
+            IndigoDescriptorDispatcher dispatcher(table.ref(), params, batch, first_row);
+            dispatcher.run(threads);
+        }
+
+        return self.addObject(table.release());
+    }
+    INDIGO_END(-1);
+}
+
+CEXPORT const double* indigoDescriptorColumn(int table, int column)
+{
+    INDIGO_BEGIN
+    {
+        return IndigoDescriptorTable::cast(self.getObject(table)).getColumn(column);
+    }
+    INDIGO_END(0);
+}
+
+CEXPORT const char* indigoDescriptorString(int table, int column, int row)
+{
+    INDIGO_BEGIN
+    {
+        return IndigoDescriptorTable::cast(self.getObject(table)).getString(column, row);
+    }
+    INDIGO_END(0);
+}
+
+CEXPORT const char* indigoDescriptorError(int table, int row)
+{
+    INDIGO_BEGIN
+    {
+        return IndigoDescriptorTable::cast(self.getObject(table)).getError(row);
+    }
+    INDIGO_END(0);
+}
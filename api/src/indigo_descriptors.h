@@ -0,0 +1,85 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __indigo_descriptors__
+#define __indigo_descriptors__
+
+#include "indigo_internal.h"
+
+// Descriptors that can be computed by indigoComputeDescriptors()
+enum IndigoDescriptorType
+{
+    DESCRIPTOR_MW,
+    DESCRIPTOR_MONO,
+    DESCRIPTOR_MOST_ABUNDANT,
+    DESCRIPTOR_NOMINAL,
+    DESCRIPTOR_FORMULA,
+    DESCRIPTOR_COMPOSITION,
+    DESCRIPTOR_ATOMS,
+    DESCRIPTOR_BONDS,
+    DESCRIPTOR_HEAVY_ATOMS,
+    DESCRIPTOR_HYDROGENS,
+    DESCRIPTOR_COMPONENTS,
+    DESCRIPTOR_SSSR
+};
+
+// Result of indigoComputeDescriptors(): one row per molecule and one column
+// per descriptor. Every column is stored contiguously: numeric columns as
+// arrays of doubles, string columns as zero-terminated strings in one buffer.
+class IndigoDescriptorTable : public IndigoObject
+{
+public:
+    IndigoDescriptorTable();
+    virtual ~IndigoDescriptorTable();
+
+    static IndigoDescriptorTable& cast(IndigoObject& obj);
+    static bool isStringDescriptor(int type);
+
+    void parseDescriptors(const char* descriptors);
+
+    int rowCount() const;
+    int columnCount() const;
+
+    const double* getColumn(int column);
+    double* getColumnForWrite(int column);
+    const char* getString(int column, int row);
+    const char* getError(int row);
+
+    // Appends rows with the space for the numeric values and returns the index of the first row
+    int addRows(int count);
+    void setString(int column, int row, const char* str);
+    void setError(int row, const char* message);
+
+    Array<int> types;
+
+protected:
+    void _checkColumn(int column);
+    void _checkRow(int row);
+
+    int _rows;
+
+    ObjArray<Array<double>> _numbers;
+    // Offsets of the strings in _strings, one per row; -1 for an absent value
+    ObjArray<Array<int>> _string_offsets;
+    ObjArray<Array<char>> _strings;
+
+    Array<int> _error_offsets;
+    Array<char> _errors;
+};
+
+#endif
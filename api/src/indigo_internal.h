@@ -159,6 +159,9 @@ public:
         TGROUP,
         TGROUPS_ITER,
         GROSS_REACTION,
+        TRANSFORM_SET,
+        TRANSFORM_SET_ITER,
+        DESCRIPTOR_TABLE,
         INDIGO_OBJECT_LAST_TYPE // must be the last element in the enum
     };
 
@@ -302,6 +305,8 @@ public:
     bool deconvolution_aromatization;
     bool deco_save_ap_bond_orders;
     bool deco_ignore_errors;
+    bool deco_first_embedding_only;
+    int deco_threads;
 
     int molfile_saving_mode; // MolfileSaver::MODE_***, default is zero
     bool molfile_saving_no_chiral;
@@ -321,6 +326,7 @@ public:
     int layout_max_iterations; // default is zero -- no limit
     bool smart_layout = false;
     float layout_horintervalfactor = 1.4f;
+    int layout_precompute_macrocycles = 0; // largest plain ring size solved in advance for smart layout
 
     int layout_orientation = 0;
 
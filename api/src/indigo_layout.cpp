@@ -17,105 +17,289 @@
  ***************************************************************************/
 
 #include "base_cpp/cancellation_handler.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "indigo_array.h"
 #include "indigo_internal.h"
 #include "indigo_molecule.h"
 #include "indigo_reaction.h"
 #include "layout/molecule_cleaner_2d.h"
 #include "layout/molecule_layout.h"
+#include "layout/molecule_layout_macrocycles.h"
 #include "layout/reaction_layout.h"
 #include "reaction/base_reaction.h"
 #include <algorithm>
 #include <vector>
 
-CEXPORT int indigoLayout(int object){INDIGO_BEGIN{IndigoObject& obj = self.getObject(object);
-int i;
+struct IndigoLayoutParams
+{
+    bool smart_layout;
+    int max_iterations;
+    int orientation;
+    float horintervalfactor;
+    int precompute_macrocycles;
+};
+
+static void _getLayoutParams(Indigo& self, IndigoLayoutParams& params)
+{
+    params.smart_layout = self.smart_layout;
+    params.max_iterations = self.layout_max_iterations;
+    params.orientation = self.layout_orientation;
+    params.horintervalfactor = self.layout_horintervalfactor;
+    params.precompute_macrocycles = self.layout_precompute_macrocycles;
+}
+
+static void _prepareLayout(const IndigoLayoutParams& params)
+{
+    // Fills the shared macrocycle memo once instead of solving
+    // each ring size at its first occurrence
+    if (params.smart_layout && params.precompute_macrocycles > 0)
+        MoleculeLayoutMacrocyclesLattice::precomputeRings(params.precompute_macrocycles);
+}
 
-if (IndigoBaseMolecule::is(obj))
+static void _layoutObject(IndigoObject& obj, const IndigoLayoutParams& params, CancellationHandler* cancellation)
 {
-    BaseMolecule* mol = &obj.getBaseMolecule();
-    Filter f;
-    if (obj.type == IndigoObject::SUBMOLECULE)
+    int i;
+
+    if (IndigoBaseMolecule::is(obj))
     {
-        IndigoSubmolecule& submol = (IndigoSubmolecule&)obj;
-        mol = &submol.getOriginalMolecule();
-        f.initNone(mol->vertexEnd());
-        for (int i = 0; i < submol.vertices.size(); i++)
+        BaseMolecule* mol = &obj.getBaseMolecule();
+        Filter f;
+        if (obj.type == IndigoObject::SUBMOLECULE)
         {
-            f.unhide(submol.vertices[i]);
+            IndigoSubmolecule& submol = (IndigoSubmolecule&)obj;
+            mol = &submol.getOriginalMolecule();
+            f.initNone(mol->vertexEnd());
+            for (int i = 0; i < submol.vertices.size(); i++)
+            {
+                f.unhide(submol.vertices[i]);
+            }
         }
-    }
-    MoleculeLayout ml(*mol, self.smart_layout);
+        MoleculeLayout ml(*mol, params.smart_layout);
 
-    if (obj.type == IndigoObject::SUBMOLECULE)
-    {
-        ml.filter = &f;
-    }
+        if (obj.type == IndigoObject::SUBMOLECULE)
+        {
+            ml.filter = &f;
+        }
 
-    ml.max_iterations = self.layout_max_iterations;
-    ml.bond_length = 1.6f;
-    ml.layout_orientation = (layout_orientation_value)self.layout_orientation;
+        ml.max_iterations = params.max_iterations;
+        ml.bond_length = 1.6f;
+        ml.layout_orientation = (layout_orientation_value)params.orientation;
 
-    TimeoutCancellationHandler cancellation(self.cancellation_timeout);
-    ml.setCancellationHandler(&cancellation);
+        ml.setCancellationHandler(cancellation);
 
-    ml.make();
+        ml.make();
 
-    if (obj.type != IndigoObject::SUBMOLECULE)
+        if (obj.type != IndigoObject::SUBMOLECULE)
+        {
+            // Not for submolecule yet
+            mol->clearBondDirections();
+            try
+            {
+                mol->stereocenters.markBonds();
+                mol->allene_stereo.markBonds();
+            }
+            catch (Exception e)
+            {
+            }
+            for (i = 1; i <= mol->rgroups.getRGroupCount(); i++)
+            {
+                RGroup& rgp = mol->rgroups.getRGroup(i);
+
+                for (int j = rgp.fragments.begin(); j != rgp.fragments.end(); j = rgp.fragments.next(j))
+                {
+                    rgp.fragments[j]->clearBondDirections();
+                    try
+                    {
+                        rgp.fragments[j]->stereocenters.markBonds();
+                        rgp.fragments[j]->allene_stereo.markBonds();
+                    }
+                    catch (Exception e)
+                    {
+                    }
+                }
+            }
+        }
+    }
+    else if (IndigoBaseReaction::is(obj))
     {
-        // Not for submolecule yet
-        mol->clearBondDirections();
+        BaseReaction& rxn = obj.getBaseReaction();
+        ReactionLayout rl(rxn, params.smart_layout);
+        rl.max_iterations = params.max_iterations;
+        rl.layout_orientation = (layout_orientation_value)params.orientation;
+        rl.bond_length = 1.6f;
+        rl.horizontal_interval_factor = params.horintervalfactor;
+
+        rl.make();
         try
         {
-            mol->stereocenters.markBonds();
-            mol->allene_stereo.markBonds();
+            rxn.markStereocenterBonds();
         }
         catch (Exception e)
         {
         }
-        for (i = 1; i <= mol->rgroups.getRGroupCount(); i++)
-        {
-            RGroup& rgp = mol->rgroups.getRGroup(i);
+    }
+    else
+    {
+        throw IndigoError("The object provided is neither a molecule, nor a reaction");
+    }
+}
 
-            for (int j = rgp.fragments.begin(); j != rgp.fragments.end(); j = rgp.fragments.next(j))
-            {
-                rgp.fragments[j]->clearBondDirections();
-                try
-                {
-                    rgp.fragments[j]->stereocenters.markBonds();
-                    rgp.fragments[j]->allene_stereo.markBonds();
-                }
-                catch (Exception e)
-                {
-                }
-            }
-        }
+CEXPORT int indigoLayout(int object)
+{
+    INDIGO_BEGIN
+    {
+        IndigoObject& obj = self.getObject(object);
+        IndigoLayoutParams params;
+        _getLayoutParams(self, params);
+
+        _prepareLayout(params);
+
+        TimeoutCancellationHandler cancellation(self.cancellation_timeout);
+        _layoutObject(obj, params, &cancellation);
+        return 0;
     }
+    INDIGO_END(-1)
 }
-else if (IndigoBaseReaction::is(obj))
+
+//
+// Parallel batch layout
+//
+
+// Number of objects that are read from the source and laid out at once
+static const int _LAYOUT_BATCH_SIZE = 1000;
+
+class IndigoLayoutCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result);
+
+    const IndigoLayoutParams* params;
+    int timeout;
+    IndigoObject* object;
+    int index;
+};
+
+class IndigoLayoutResult : public OsCommandResult
 {
-    BaseReaction& rxn = obj.getBaseReaction();
-    ReactionLayout rl(rxn, self.smart_layout);
-    rl.max_iterations = self.layout_max_iterations;
-    rl.layout_orientation = (layout_orientation_value)self.layout_orientation;
-    rl.bond_length = 1.6f;
-    rl.horizontal_interval_factor = self.layout_horintervalfactor;
-
-    rl.make();
+public:
+    virtual void clear()
+    {
+        index = -1;
+        error.clear();
+    }
+
+    int index;
+    Array<char> error;
+};
+
+class IndigoLayoutDispatcher : public OsCommandDispatcher
+{
+public:
+    IndigoLayoutDispatcher(const IndigoLayoutParams& params, int timeout, PtrArray<IndigoObject>& batch)
+        : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _params(params), _timeout(timeout), _batch(batch), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<IndigoLayoutCommand> command(new IndigoLayoutCommand());
+        command->params = &_params;
+        command->timeout = _timeout;
+        return command.release();
+    }
+
+    virtual OsCommandResult* _allocateResult()
+    {
+        return new IndigoLayoutResult();
+    }
+
+    virtual bool _setupCommand(OsCommand& command_)
+    {
+        if (_next >= _batch.size())
+            return false;
+
+        IndigoLayoutCommand& command = (IndigoLayoutCommand&)command_;
+        command.index = _next;
+        command.object = _batch[_next];
+        _next++;
+        return true;
+    }
+
+    // Results are handled in the dispatcher thread
+    virtual void _handleResult(OsCommandResult& result_)
+    {
+        IndigoLayoutResult& result = (IndigoLayoutResult&)result_;
+        if (result.error.size() > 0)
+            _batch[result.index]->getProperties().insert("layout-error", result.error.ptr());
+    }
+
+private:
+    const IndigoLayoutParams& _params;
+    int _timeout;
+    PtrArray<IndigoObject>& _batch;
+    int _next;
+};
+
+void IndigoLayoutCommand::execute(OsCommandResult& result_)
+{
+    IndigoLayoutResult& result = (IndigoLayoutResult&)result_;
+    result.index = index;
+
+    // Both the layout itself and the algorithms that use the thread-local handler
+    // (macrocycles, embedding enumeration) are stopped when the limit is reached
+    AutoCancellationHandler cancellation(timeout > 0 ? new TimeoutCancellationHandler(timeout) : nullptr);
     try
     {
-        rxn.markStereocenterBonds();
+        _layoutObject(*object, *params, getCancellationHandler());
     }
-    catch (Exception e)
+    catch (Exception& e)
     {
+        // The object keeps its original coordinates
+        result.error.readString(e.message(), true);
     }
 }
-else
+
+CEXPORT int indigoLayoutBatch(int objects, int threads, int per_item_timeout_ms)
 {
-    throw IndigoError("The object provided is neither a molecule, nor a reaction");
-}
-return 0;
-}
-INDIGO_END(-1)
+    INDIGO_BEGIN
+    {
+        IndigoObject& obj = self.getObject(objects);
+        IndigoLayoutParams params;
+        _getLayoutParams(self, params);
+
+        int timeout = per_item_timeout_ms > 0 ? per_item_timeout_ms : self.cancellation_timeout;
+        _prepareLayout(params);
+
+        AutoPtr<IndigoArray> out(new IndigoArray());
+        PtrArray<IndigoObject> batch;
+        IndigoItemReader reader(obj);
+        IndigoObject* item;
+
+        while (true)
+        {
+            batch.clear();
+            while (batch.size() < _LAYOUT_BATCH_SIZE && (item = reader.next()) != nullptr)
+                batch.add(item->clone());
+
+            if (batch.size() == 0)
+                break;
+
+            for (int i = 0; i < batch.size(); i++)
+                if (!IndigoBaseMolecule::is(*batch[i]) && !IndigoBaseReaction::is(*batch[i]))
+                    throw IndigoError("indigoLayoutBatch(): %s is neither a molecule, nor a reaction", batch[i]->debugInfo());
+
+            IndigoLayoutDispatcher dispatcher(params, timeout, batch);
+            dispatcher.run(threads);
+
+            // Objects are moved to the output in the input order
+            for (int i = 0; i < batch.size(); i++)
+                out->objects.add(batch.release(i));
+        }
+
+        return self.addObject(out.release());
+    }
+    INDIGO_END(-1)
 }
 
 CEXPORT int indigoClean2d(int object)
@@ -179,3 +363,24 @@ CEXPORT int indigoClean2d(int object)
     }
     INDIGO_END(-1)
 }
+
+CEXPORT int indigoClean2dIncremental(int molecule, int natoms, int* atoms)
+{
+    INDIGO_BEGIN
+    {
+        BaseMolecule& mol = self.getObject(molecule).getBaseMolecule();
+
+        QS_DEF(Array<int>, dirty);
+        dirty.clear();
+        for (int i = 0; i < natoms; i++)
+        {
+            if (atoms[i] < 0 || atoms[i] >= mol.vertexEnd() || !mol.hasVertex(atoms[i]))
+                throw IndigoError("indigoClean2dIncremental(): invalid atom index %d", atoms[i]);
+            dirty.push(atoms[i]);
+        }
+
+        MoleculeCleaner2d::cleanIncremental(mol, dirty);
+        return 0;
+    }
+    INDIGO_END(-1)
+}
@@ -19,6 +19,7 @@
 #include "base_cpp/output.h"
 #include "base_cpp/scanner.h"
 #include "indigo_array.h"
+#include "indigo_descriptors.h"
 #include "indigo_internal.h"
 #include "indigo_io.h"
 #include "indigo_loaders.h"
@@ -577,6 +578,9 @@ CEXPORT int indigoCount(int item)
         if (obj.type == IndigoObject::MULTILINE_SMILES_LOADER)
             return ((IndigoMultilineSmilesLoader&)obj).count();
 
+        if (obj.type == IndigoObject::DESCRIPTOR_TABLE)
+            return ((IndigoDescriptorTable&)obj).rowCount();
+
         throw IndigoError("indigoCount(): can not handle %s", obj.debugInfo());
     }
     INDIGO_END(-1);
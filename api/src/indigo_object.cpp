@@ -122,6 +122,9 @@ IndigoObjectTypes::IndigoObjectTypes()
     emplace(IndigoObject::TGROUP, "TGroup");
     emplace(IndigoObject::TGROUPS_ITER, "TGroupsIterator");
     emplace(IndigoObject::GROSS_REACTION, "GrossReaction");
+    emplace(IndigoObject::TRANSFORM_SET, "TransformSet");
+    emplace(IndigoObject::TRANSFORM_SET_ITER, "TransformSetIterator");
+    emplace(IndigoObject::DESCRIPTOR_TABLE, "DescriptorTable");
 
     if (size() != IndigoObject::INDIGO_OBJECT_LAST_TYPE - 1)
     {
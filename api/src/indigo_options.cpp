@@ -17,6 +17,7 @@
  ***************************************************************************/
 
 #include "indigo_internal.h"
+#include "layout/molecule_layout_macrocycles.h"
 #include "molecule/molfile_saver.h"
 
 static void setStrValue(const char* source, char* dest, int len)
@@ -204,6 +205,20 @@ static void indigoGetMaxEmbeddings(int& value)
     value = self.max_embeddings;
 }
 
+static void indigoSetLayoutPrecomputeMacrocycles(int value)
+{
+    Indigo& self = indigoGetInstance();
+    if (value < 0 || value > MoleculeLayoutMacrocyclesLattice::MAX_PRECOMPUTED_RING_SIZE)
+        throw IndigoError("Precomputed macrocycle size must be between 0 and %d.", MoleculeLayoutMacrocyclesLattice::MAX_PRECOMPUTED_RING_SIZE);
+    self.layout_precompute_macrocycles = value;
+}
+
+static void indigoGetLayoutPrecomputeMacrocycles(int& value)
+{
+    Indigo& self = indigoGetInstance();
+    value = self.layout_precompute_macrocycles;
+}
+
 static void indigoSetStereoOption(const char* option)
 {
     Indigo& self = indigoGetInstance();
@@ -262,6 +277,8 @@ _IndigoBasicOptionsHandlersSetter::_IndigoBasicOptionsHandlersSetter()
     mgr.setOptionHandlerBool("deconvolution-aromatization", SETTER_GETTER_BOOL_OPTION(indigo.deconvolution_aromatization));
     mgr.setOptionHandlerBool("deco-save-ap-bond-orders", SETTER_GETTER_BOOL_OPTION(indigo.deco_save_ap_bond_orders));
     mgr.setOptionHandlerBool("deco-ignore-errors", SETTER_GETTER_BOOL_OPTION(indigo.deco_ignore_errors));
+    mgr.setOptionHandlerBool("deco-first-embedding-only", SETTER_GETTER_BOOL_OPTION(indigo.deco_first_embedding_only));
+    mgr.setOptionHandlerInt("deco-threads", SETTER_GETTER_INT_OPTION(indigo.deco_threads));
     mgr.setOptionHandlerString("molfile-saving-mode", indigoSetMolfileSavingMode, indigoGetMolfileSavingMode);
     mgr.setOptionHandlerInt("molfile-saving-no-chiral", SETTER_GETTER_INT_OPTION(indigo.molfile_saving_no_chiral));
     mgr.setOptionHandlerInt("molfile-saving-chiral-flag", SETTER_GETTER_INT_OPTION(indigo.molfile_saving_chiral_flag));
@@ -288,6 +305,7 @@ _IndigoBasicOptionsHandlersSetter::_IndigoBasicOptionsHandlersSetter()
     mgr.setOptionHandlerInt("max-embeddings", indigoSetMaxEmbeddings, indigoGetMaxEmbeddings);
 
     mgr.setOptionHandlerInt("layout-max-iterations", SETTER_GETTER_INT_OPTION(indigo.layout_max_iterations));
+    mgr.setOptionHandlerInt("layout-precompute-macrocycles", indigoSetLayoutPrecomputeMacrocycles, indigoGetLayoutPrecomputeMacrocycles);
 
     mgr.setOptionHandlerFloat("layout-horintervalfactor", indigoSetLayoutHorIntervalFactor, indigoGetLayoutHorIntervalFactor);
 
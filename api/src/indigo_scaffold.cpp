@@ -17,12 +17,19 @@
  ***************************************************************************/
 
 #include "indigo_scaffold.h"
+#include "base_c/nano.h"
+#include "base_cpp/cancellation_handler.h"
+#include "base_cpp/os_thread_wrapper.h"
 #include "base_cpp/scanner.h"
 #include "indigo_array.h"
 #include "indigo_molecule.h"
 #include "molecule/molecule_exact_matcher.h"
 #include "molecule/molecule_scaffold_detection.h"
 
+// Maximum number of alternative scaffolds that are kept for every
+// group of molecules during the tree reduction
+static const int _SCAFFOLD_TREE_CANDIDATES = 10;
+
 IndigoScaffold::IndigoScaffold() : IndigoObject(SCAFFOLD)
 {
 }
@@ -31,6 +38,407 @@ IndigoScaffold::~IndigoScaffold()
 {
 }
 
+//
+// Tree reduction: the molecules are split into chunks which are reduced to
+// scaffolds in parallel, and then the scaffolds are merged pairwise, level
+// by level. Every node keeps the scaffolds that are common to all of its molecules.
+//
+
+struct IndigoScaffoldTreeNode
+{
+    ObjArray<Molecule> candidates;
+    int covered;
+};
+
+// Scaffold search over a set of molecules; the result goes to the output node
+struct IndigoScaffoldTreeTask
+{
+    int output;
+    Array<Molecule*> molecules;
+};
+
+struct IndigoScaffoldTreeParams
+{
+    bool approximate;
+    int max_iterations;
+    // Overall time budget in milliseconds, 0 if not limited
+    int timeout;
+    qword start_time;
+
+    // Milliseconds left from the time budget, -1 if it is not limited
+    int remaining() const
+    {
+        if (timeout <= 0)
+            return -1;
+        int elapsed = (int)(nanoHowManySeconds(nanoClock() - start_time) * 1000);
+        return elapsed >= timeout ? 0 : timeout - elapsed;
+    }
+};
+
+class IndigoScaffoldTreeCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result);
+    virtual void clear()
+    {
+        molecules.clear();
+    }
+
+    const IndigoScaffoldTreeParams* params;
+
+    ObjArray<Molecule> molecules;
+    int output;
+
+private:
+    static int _checkTimeout(const int* processed, const int* total, const void* info, void* userdata);
+
+    int _processed;
+};
+
+class IndigoScaffoldTreeResult : public OsCommandResult
+{
+public:
+    virtual void clear()
+    {
+        output = -1;
+        timed_out = false;
+        covered = -1;
+        candidates.clear();
+        error.clear();
+    }
+
+    int output;
+    bool timed_out;
+    // Number of the molecules the scaffolds are common for, -1 if for all of them
+    int covered;
+    ObjArray<Molecule> candidates;
+    Array<char> error;
+};
+
+// Called after each molecule of the set; stops the search when the time budget is exhausted
+int IndigoScaffoldTreeCommand::_checkTimeout(const int* processed, const int* total, const void*, void* userdata)
+{
+    IndigoScaffoldTreeCommand& self = *(IndigoScaffoldTreeCommand*)userdata;
+    if (*processed + 1 < *total && self.params->remaining() == 0)
+    {
+        self._processed = *processed + 1;
+        return 0;
+    }
+    return 1;
+}
+
+void IndigoScaffoldTreeCommand::execute(OsCommandResult& result_)
+{
+    IndigoScaffoldTreeResult& result = (IndigoScaffoldTreeResult&)result_;
+    result.output = output;
+
+    int remaining = params->remaining();
+    if (remaining == 0)
+    {
+        result.timed_out = true;
+        return;
+    }
+
+    try
+    {
+        // Without a time budget the handler of the session is kept
+        std::unique_ptr<AutoCancellationHandler> cancellation;
+        if (remaining > 0)
+            cancellation.reset(new AutoCancellationHandler(new TimeoutCancellationHandler(remaining)));
+
+        ObjArray<QueryMolecule> basket;
+        QueryMolecule scaffold;
+        MoleculeScaffoldDetection msd(&molecules);
+        msd.basketStructures = &basket;
+        msd.cbEmbedding = _checkTimeout;
+        msd.embeddingUserdata = this;
+        _processed = -1;
+        if (params->max_iterations > 0)
+            msd.maxIterations = params->max_iterations;
+
+        try
+        {
+            if (params->approximate)
+                msd.extractApproximateScaffold(scaffold);
+            else
+                msd.extractExactScaffold(scaffold);
+        }
+        catch (MoleculeScaffoldDetection::Error&)
+        {
+            // The molecules have nothing in common
+            return;
+        }
+
+        for (int i = 0; i < basket.size(); i++)
+            MoleculeScaffoldDetection::makeMolecule(result.candidates.push(), basket[i]);
+
+        if (_processed >= 0)
+        {
+            result.timed_out = true;
+            result.covered = _processed;
+        }
+    }
+    catch (Exception& e)
+    {
+        result.candidates.clear();
+        if (params->remaining() == 0)
+            result.timed_out = true;
+        else
+            result.error.readString(e.message(), true);
+    }
+}
+
+class IndigoScaffoldTreeDispatcher : public OsCommandDispatcher
+{
+public:
+    IndigoScaffoldTreeDispatcher(IndigoScaffoldTreeParams& params, ObjArray<IndigoScaffoldTreeTask>& tasks, ObjArray<ObjArray<Molecule>>& merged,
+                                 Array<int>& covered, Array<int>& timed_out, ObjArray<Array<char>>& errors)
+        : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _params(params), _tasks(tasks), _merged(merged), _covered(covered), _timed_out(timed_out),
+          _errors(errors), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<IndigoScaffoldTreeCommand> command(new IndigoScaffoldTreeCommand());
+        command->params = &_params;
+        return command.release();
+    }
+
+    virtual OsCommandResult* _allocateResult()
+    {
+        return new IndigoScaffoldTreeResult();
+    }
+
+    // Commands are set up in the dispatcher thread, so the molecules are cloned here
+    virtual bool _setupCommand(OsCommand& command_)
+    {
+        if (_next >= _tasks.size())
+            return false;
+
+        IndigoScaffoldTreeCommand& command = (IndigoScaffoldTreeCommand&)command_;
+        IndigoScaffoldTreeTask& task = _tasks[_next++];
+
+        command.output = task.output;
+        command.molecules.clear();
+        for (int i = 0; i < task.molecules.size(); i++)
+            command.molecules.push().clone(*task.molecules[i], 0, 0);
+        return true;
+    }
+
+    virtual void _handleResult(OsCommandResult& result_)
+    {
+        IndigoScaffoldTreeResult& result = (IndigoScaffoldTreeResult&)result_;
+        int idx = result.output;
+
+        if (result.timed_out)
+            _timed_out[idx] = 1;
+        if (result.covered >= 0)
+            _covered[idx] = result.covered;
+        if (result.error.size() > 0 && _errors[idx].size() == 0)
+            _errors[idx].copy(result.error);
+
+        ObjArray<Molecule>& merged = _merged[idx];
+        for (int i = 0; i < result.candidates.size(); i++)
+            merged.push().clone(result.candidates[i], 0, 0);
+    }
+
+private:
+    IndigoScaffoldTreeParams& _params;
+    ObjArray<IndigoScaffoldTreeTask>& _tasks;
+    ObjArray<ObjArray<Molecule>>& _merged;
+    Array<int>& _covered;
+    Array<int>& _timed_out;
+    ObjArray<Array<char>>& _errors;
+    int _next;
+};
+
+// The same order as the scaffold basket uses: more rings first, then more bonds
+static int _compareScaffolds(Molecule& m1, Molecule& m2, void*)
+{
+    int result = (m2.edgeCount() - m2.vertexCount()) - (m1.edgeCount() - m1.vertexCount());
+    if (result == 0 || m1.edgeCount() == 0 || m2.edgeCount() == 0)
+        result = m2.edgeCount() - m1.edgeCount();
+    return result;
+}
+
+static int _compareBySize(Molecule& m1, Molecule& m2, void*)
+{
+    if (m1.edgeCount() != m2.edgeCount())
+        return m2.edgeCount() - m1.edgeCount();
+    return m2.vertexCount() - m1.vertexCount();
+}
+
+// Keeps only the scaffolds that are not substructures of the other ones
+static void _pruneScaffolds(ObjArray<Molecule>& candidates, IndigoScaffoldTreeNode& node)
+{
+    SubstructureMcs sub_mcs;
+    sub_mcs.cbMatchEdge = MoleculeScaffoldDetection::matchBonds;
+    sub_mcs.cbMatchVertex = MoleculeScaffoldDetection::matchAtoms;
+
+    candidates.qsort(_compareBySize, 0);
+
+    node.candidates.clear();
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        bool dominated = false;
+        for (int j = 0; j < node.candidates.size() && !dominated; j++)
+        {
+            sub_mcs.setGraphs(candidates[i], node.candidates[j]);
+            dominated = sub_mcs.searchSubstructure(0);
+        }
+        if (!dominated)
+            node.candidates.push().clone(candidates[i], 0, 0);
+    }
+
+    node.candidates.qsort(_compareScaffolds, 0);
+    while (node.candidates.size() > _SCAFFOLD_TREE_CANDIDATES)
+        node.candidates.pop();
+}
+
+// Runs the tasks of one level and replaces the source nodes with the merged ones.
+// Returns false if the time budget was exhausted. The scaffolds found by then are
+// kept, and the source nodes are left unmerged if nothing was found for them.
+static bool _runScaffoldTreeLevel(PtrArray<IndigoScaffoldTreeNode>& nodes, ObjArray<IndigoScaffoldTreeTask>& tasks, Array<int>& covered,
+                                  Array<int>& sources, IndigoScaffoldTreeParams& params, int threads)
+{
+    int outputs = covered.size();
+    ObjArray<ObjArray<Molecule>> merged;
+    ObjArray<Array<char>> errors;
+    Array<int> timed_out;
+
+    for (int i = 0; i < outputs; i++)
+    {
+        merged.push();
+        errors.push();
+    }
+    timed_out.clear_resize(outputs);
+    timed_out.zerofill();
+
+    IndigoScaffoldTreeDispatcher dispatcher(params, tasks, merged, covered, timed_out, errors);
+    dispatcher.run(threads);
+
+    for (int i = 0; i < outputs; i++)
+        if (errors[i].size() > 0)
+            throw IndigoError("indigoExtractCommonScaffold(): %s", errors[i].ptr());
+
+    bool completed = true;
+    PtrArray<IndigoScaffoldTreeNode> next;
+    Array<int> used;
+    used.clear_resize(nodes.size());
+    used.zerofill();
+
+    for (int i = 0; i < outputs; i++)
+    {
+        if (timed_out[i])
+            completed = false;
+
+        if (merged[i].size() == 0)
+        {
+            if (timed_out[i])
+                continue;
+            throw IndigoError("indigoExtractCommonScaffold(): there are no scaffolds found");
+        }
+
+        IndigoScaffoldTreeNode& node = next.add(new IndigoScaffoldTreeNode());
+        _pruneScaffolds(merged[i], node);
+        node.covered = covered[i];
+
+        for (int j = 2 * i; j < 2 * i + 2; j++)
+            if (sources[j] >= 0)
+                used[sources[j]] = 1;
+    }
+
+    // The odd node and the nodes that have not been merged in time go to the next level as is
+    for (int i = 0; i < nodes.size(); i++)
+        if (!used[i])
+            next.add(nodes.release(i));
+
+    nodes.clear();
+    for (int i = 0; i < next.size(); i++)
+        nodes.add(next.release(i));
+    return completed;
+}
+
+static void _extractScaffoldTree(ObjArray<Molecule>& mol_set, IndigoScaffoldTreeParams& params, int threads, IndigoScaffold& scaf)
+{
+    PtrArray<IndigoScaffoldTreeNode> nodes;
+    ObjArray<IndigoScaffoldTreeTask> tasks;
+    Array<int> covered;
+    Array<int> sources;
+
+    // Similar molecules are reduced together
+    mol_set.qsort(_compareBySize, 0);
+    while (mol_set.size() > 0 && mol_set.top().vertexCount() == 0)
+        mol_set.pop();
+    if (mol_set.size() == 0)
+        throw IndigoError("indigoExtractCommonScaffold(): no molecules given");
+
+    // Every chunk is reduced with the sequential algorithm that skips
+    // the MCS search for the molecules containing the current scaffold
+    int chunks = 2 * (threads < 0 ? osGetProcessorsCount() : __max(threads, 1));
+    int chunk_size = __max((mol_set.size() + chunks - 1) / chunks, 2);
+
+    for (int first = 0; first < mol_set.size(); first += chunk_size)
+    {
+        IndigoScaffoldTreeTask& task = tasks.push();
+        task.output = covered.size();
+        for (int i = first; i < mol_set.size() && i < first + chunk_size; i++)
+            task.molecules.push(&mol_set[i]);
+        covered.push(task.molecules.size());
+        sources.push(-1);
+        sources.push(-1);
+    }
+
+    bool completed = _runScaffoldTreeLevel(nodes, tasks, covered, sources, params, threads);
+
+    while (nodes.size() > 1 && completed)
+    {
+        tasks.clear();
+        covered.clear();
+        sources.clear();
+
+        for (int p = 0; p + 1 < nodes.size(); p += 2)
+        {
+            IndigoScaffoldTreeNode& first = *nodes[p];
+            IndigoScaffoldTreeNode& second = *nodes[p + 1];
+
+            for (int i = 0; i < first.candidates.size(); i++)
+                for (int j = 0; j < second.candidates.size(); j++)
+                {
+                    IndigoScaffoldTreeTask& task = tasks.push();
+                    task.output = covered.size();
+                    task.molecules.push(&first.candidates[i]);
+                    task.molecules.push(&second.candidates[j]);
+                }
+            covered.push(first.covered + second.covered);
+            sources.push(p);
+            sources.push(p + 1);
+        }
+
+        completed = _runScaffoldTreeLevel(nodes, tasks, covered, sources, params, threads);
+    }
+
+    if (nodes.size() == 0)
+        throw IndigoError("indigoExtractCommonScaffold(): time budget of %d ms is exhausted", params.timeout);
+
+    // When the time budget is exhausted, the scaffold of the largest group of molecules is the best one
+    int best = 0;
+    for (int i = 1; i < nodes.size(); i++)
+    {
+        if (nodes[i]->covered > nodes[best]->covered ||
+            (nodes[i]->covered == nodes[best]->covered && _compareScaffolds(nodes[i]->candidates[0], nodes[best]->candidates[0], 0) < 0))
+            best = i;
+    }
+
+    IndigoScaffoldTreeNode& result = *nodes[best];
+    scaf.all_scaffolds.clear();
+    for (int i = 0; i < result.candidates.size(); i++)
+        MoleculeScaffoldDetection::clone(scaf.all_scaffolds.push(), result.candidates[i]);
+    MoleculeScaffoldDetection::clone(scaf.max_scaffold, result.candidates[0]);
+}
+
 CEXPORT int indigoExtractCommonScaffold(int structures, const char* options)
 {
     INDIGO_BEGIN
@@ -56,6 +464,9 @@ CEXPORT int indigoExtractCommonScaffold(int structures, const char* options)
 
         bool approximate = false;
         int max_iterations = 0;
+        bool tree = false;
+        int threads = 0;
+        int timeout = 0;
 
         if (options != 0)
         {
@@ -75,12 +486,47 @@ CEXPORT int indigoExtractCommonScaffold(int structures, const char* options)
                     throw IndigoError("indigoExtractCommonScaffold: unknown option %s\n", word.ptr());
 
                 scanner.skipSpace();
-                if (!scanner.isEOF())
+                if (!scanner.isEOF() && (isdigit(scanner.lookNext()) || scanner.lookNext() == '-'))
                 {
                     max_iterations = scanner.readInt();
                 }
+
+                while (true)
+                {
+                    scanner.skipSpace();
+                    if (scanner.isEOF())
+                        break;
+                    scanner.readWord(word, 0);
+                    scanner.skipSpace();
+
+                    if (strcasecmp(word.ptr(), "THREADS") == 0)
+                    {
+                        tree = true;
+                        threads = scanner.readInt();
+                    }
+                    else if (strcasecmp(word.ptr(), "TIMEOUT") == 0)
+                    {
+                        tree = true;
+                        timeout = scanner.readInt();
+                    }
+                    else
+                        throw IndigoError("indigoExtractCommonScaffold: unknown option %s\n", word.ptr());
+                }
             }
         }
+
+        if (tree)
+        {
+            IndigoScaffoldTreeParams params;
+            params.approximate = approximate;
+            params.max_iterations = max_iterations;
+            params.timeout = timeout;
+            params.start_time = nanoClock();
+
+            _extractScaffoldTree(mol_set, params, threads, scaf.ref());
+            return self.addObject(scaf.release());
+        }
+
         if (max_iterations > 0)
             msd.maxIterations = max_iterations;
 
@@ -17,20 +17,187 @@
  ***************************************************************************/
 
 #include "indigo_tautomer_enumerator.h"
+#include "base_cpp/scanner.h"
 #include "indigo_molecule.h"
 
-CEXPORT int indigoIterateTautomers(int molecule, const char* options){INDIGO_BEGIN{Molecule& mol = self.getObject(molecule).getMolecule();
+struct IndigoTautomerOptions
+{
+    TautomerMethod method;
+    // Bounded enumeration is used if any of the limits is given
+    bool bounded;
+    int max_queue;
+    int max_tautomers;
+};
+
+// Options: "[INCHI|RSMARTS] [QUEUE <n>] [LIMIT <n>]"
+//   QUEUE: maximum number of pending tautomers kept in memory
+//   LIMIT: maximum number of tautomers to enumerate
+// The method is matched by prefix, as before QUEUE and LIMIT were added;
+// the words other than QUEUE and LIMIT are ignored.
+static void _indigoParseTautomerOptions(const char* options, IndigoTautomerOptions& params)
+{
+    params.method = RSMARTS;
+    params.bounded = false;
+    params.max_queue = 0;
+    params.max_tautomers = 0;
+
+    if (options == 0)
+        return;
+
+    if (strncasecmp(options, "INCHI", 5) == 0)
+        params.method = INCHI;
+
+    BufferScanner scanner(options);
+    QS_DEF(Array<char>, word);
+
+    while (true)
+    {
+        scanner.skipSpace();
+        if (scanner.isEOF())
+            break;
+
+        scanner.readWord(word, 0);
 
-TautomerMethod method;
-if (strncasecmp(options, "INCHI", 5) == 0)
-    method = INCHI;
-else if (strncasecmp(options, "RSMARTS", 7) == 0)
-    method = RSMARTS;
-else
-    method = RSMARTS;
-return self.addObject(new IndigoTautomerIter(mol, method));
+        int* limit = 0;
+        if (strcasecmp(word.ptr(), "QUEUE") == 0)
+            limit = &params.max_queue;
+        else if (strcasecmp(word.ptr(), "LIMIT") == 0)
+            limit = &params.max_tautomers;
+        else
+            continue;
+
+        scanner.skipSpace();
+        if (scanner.isEOF())
+            throw IndigoError("tautomer enumeration: %s value is missing", word.ptr());
+        int value = scanner.readInt();
+        if (value < 0)
+            throw IndigoError("tautomer enumeration: %s value can not be negative", word.ptr());
+        *limit = value;
+        params.bounded = true;
+    }
+
+    if (params.bounded && params.method != RSMARTS)
+        throw IndigoError("tautomer enumeration: QUEUE and LIMIT options are supported only for RSMARTS method");
+}
+
+// The canonical tautomer is picked by the stream enumerator, which has only the RSMARTS rules
+static void _indigoCheckCanonicalTautomerMethod(const IndigoTautomerOptions& params)
+{
+    if (params.method != RSMARTS)
+        throw IndigoError("canonical tautomer: only RSMARTS method is supported");
 }
-INDIGO_END(-1)
+
+static void _indigoSetupTautomerStream(TautomerStreamEnumerator& enumerator, const IndigoTautomerOptions& params)
+{
+    enumerator.max_queue = params.max_queue;
+    enumerator.max_tautomers = params.max_tautomers;
+}
+
+CEXPORT int indigoIterateTautomers(int molecule, const char* options)
+{
+    INDIGO_BEGIN
+    {
+        Molecule& mol = self.getObject(molecule).getMolecule();
+
+        IndigoTautomerOptions params;
+        _indigoParseTautomerOptions(options, params);
+
+        if (params.bounded)
+        {
+            AutoPtr<IndigoTautomerStreamIter> iter(new IndigoTautomerStreamIter(mol));
+            _indigoSetupTautomerStream(iter->enumerator, params);
+            return self.addObject(iter.release());
+        }
+        return self.addObject(new IndigoTautomerIter(mol, params.method));
+    }
+    INDIGO_END(-1);
+}
+
+CEXPORT int indigoCanonicalTautomer(int molecule, const char* options)
+{
+    INDIGO_BEGIN
+    {
+        Molecule& mol = self.getObject(molecule).getMolecule();
+
+        IndigoTautomerOptions params;
+        _indigoParseTautomerOptions(options, params);
+        _indigoCheckCanonicalTautomerMethod(params);
+
+        TautomerStreamEnumerator enumerator(mol);
+        _indigoSetupTautomerStream(enumerator, params);
+
+        AutoPtr<IndigoMolecule> result(new IndigoMolecule());
+        QS_DEF(Array<char>, smiles);
+        enumerator.getCanonicalTautomer(result->mol, smiles);
+        return self.addObject(result.release());
+    }
+    INDIGO_END(-1);
+}
+
+CEXPORT const char* indigoTautomerHash(int molecule, const char* options)
+{
+    INDIGO_BEGIN
+    {
+        Molecule& mol = self.getObject(molecule).getMolecule();
+
+        IndigoTautomerOptions params;
+        _indigoParseTautomerOptions(options, params);
+        _indigoCheckCanonicalTautomerMethod(params);
+
+        TautomerStreamEnumerator enumerator(mol);
+        _indigoSetupTautomerStream(enumerator, params);
+
+        QS_DEF(Molecule, canonical);
+        QS_DEF(Array<char>, smiles);
+        qword hash = enumerator.getCanonicalTautomer(canonical, smiles);
+
+        auto& tmp = self.getThreadTmpData();
+        tmp.string.clear();
+        ArrayOutput output(tmp.string);
+        output.printf("%016llx", (unsigned long long)hash);
+        tmp.string.push(0);
+        return tmp.string.ptr();
+    }
+    INDIGO_END(0);
+}
+
+IndigoTautomerStreamIter::IndigoTautomerStreamIter(Molecule& molecule)
+    : IndigoObject(TAUTOMER_ITER), enumerator(molecule), _index(0), _has_next(false), _fetched(false)
+{
+    enumerator.aromatized = molecule.isAromatized();
+}
+
+IndigoTautomerStreamIter::~IndigoTautomerStreamIter()
+{
+}
+
+const char* IndigoTautomerStreamIter::debugInfo()
+{
+    return "<tautomer stream iterator>";
+}
+
+int IndigoTautomerStreamIter::getIndex()
+{
+    return _index;
+}
+
+bool IndigoTautomerStreamIter::hasNext()
+{
+    if (!_fetched)
+    {
+        _has_next = enumerator.next(_tautomer);
+        _fetched = true;
+    }
+    return _has_next;
+}
+
+IndigoObject* IndigoTautomerStreamIter::next()
+{
+    if (!hasNext())
+        return NULL;
+
+    _fetched = false;
+    return new IndigoMoleculeTautomer(_tautomer, ++_index);
 }
 
 IndigoTautomerIter::IndigoTautomerIter(Molecule& molecule, TautomerMethod method) : IndigoObject(TAUTOMER_ITER), _enumerator(molecule, method), _complete(false)
@@ -77,6 +244,11 @@ IndigoMoleculeTautomer::IndigoMoleculeTautomer(TautomerEnumerator& enumerator, i
     enumerator.constructMolecule(_molInstance, index);
 }
 
+IndigoMoleculeTautomer::IndigoMoleculeTautomer(Molecule& tautomer, int index) : IndigoObject(TAUTOMER_MOLECULE), _index(index)
+{
+    _molInstance.clone(tautomer, NULL, NULL);
+}
+
 const char* IndigoMoleculeTautomer::debugInfo()
 {
     return "<molecule tautomer>";
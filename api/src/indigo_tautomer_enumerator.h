@@ -27,6 +27,7 @@ class IndigoMoleculeTautomer : public IndigoObject
 {
 public:
     IndigoMoleculeTautomer(TautomerEnumerator& enumerator, int index);
+    IndigoMoleculeTautomer(Molecule& tautomer, int index);
     virtual ~IndigoMoleculeTautomer();
 
     virtual int getIndex();
@@ -66,4 +67,27 @@ protected:
     bool _complete;
 };
 
+// Iterator over the tautomers enumerated with bounded memory
+class IndigoTautomerStreamIter : public IndigoObject
+{
+public:
+    IndigoTautomerStreamIter(Molecule& molecule);
+    virtual ~IndigoTautomerStreamIter();
+
+    virtual int getIndex();
+
+    virtual IndigoObject* next();
+    virtual bool hasNext();
+
+    virtual const char* debugInfo();
+
+    TautomerStreamEnumerator enumerator;
+
+protected:
+    Molecule _tautomer;
+    int _index;
+    bool _has_next;
+    bool _fetched;
+};
+
 #endif /* __indigo_tautomer_enumerator__ */
@@ -0,0 +1,296 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "indigo_transform_set.h"
+#include "base_cpp/cancellation_handler.h"
+#include "base_cpp/os_thread_wrapper.h"
+#include "indigo_array.h"
+#include "indigo_molecule.h"
+#include "reaction/query_reaction.h"
+
+// Number of molecules that are read from the source and transformed at once
+static const int _TRANSFORM_SET_BATCH_SIZE = 1000;
+
+IndigoTransformSet::IndigoTransformSet() : IndigoObject(TRANSFORM_SET)
+{
+}
+
+IndigoTransformSet::~IndigoTransformSet()
+{
+}
+
+IndigoTransformSet& IndigoTransformSet::cast(IndigoObject& obj)
+{
+    if (obj.type == IndigoObject::TRANSFORM_SET)
+        return (IndigoTransformSet&)obj;
+    throw IndigoError("%s is not a transform set", obj.debugInfo());
+}
+
+//
+// Parallel transformation of a batch
+//
+
+struct IndigoTransformSetParams
+{
+    AromaticityOptions arom_options;
+    bool layout_flag;
+    bool smart_layout;
+    layout_orientation_value layout_orientation;
+    int timeout;
+};
+
+class IndigoTransformSetCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result);
+
+    // Each command has its own copy of the transformations,
+    // so the query reactions are never shared between the threads
+    ReactionTransformationSet transformations;
+    IndigoTransformSetParams* params;
+
+    Molecule* molecule;
+    int index;
+};
+
+class IndigoTransformSetResult : public OsCommandResult
+{
+public:
+    virtual void clear()
+    {
+        index = -1;
+        error.clear();
+    }
+
+    int index;
+    Array<char> error;
+};
+
+class IndigoTransformSetDispatcher : public OsCommandDispatcher
+{
+public:
+    IndigoTransformSetDispatcher(ReactionTransformationSet& transformations, IndigoTransformSetParams& params, PtrArray<IndigoMolecule>& batch,
+                                 ObjArray<Array<char>>& errors)
+        : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _transformations(transformations), _params(params), _batch(batch), _errors(errors), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<IndigoTransformSetCommand> command(new IndigoTransformSetCommand());
+        command->transformations.clone(_transformations);
+        command->params = &_params;
+        return command.release();
+    }
+
+    virtual OsCommandResult* _allocateResult()
+    {
+        return new IndigoTransformSetResult();
+    }
+
+    virtual bool _setupCommand(OsCommand& command_)
+    {
+        if (_next >= _batch.size())
+            return false;
+
+        IndigoTransformSetCommand& command = (IndigoTransformSetCommand&)command_;
+        command.index = _next;
+        command.molecule = &_batch[_next]->mol;
+        _next++;
+        return true;
+    }
+
+    virtual void _handleResult(OsCommandResult& result_)
+    {
+        IndigoTransformSetResult& result = (IndigoTransformSetResult&)result_;
+        if (result.error.size() > 0)
+            _errors[result.index].copy(result.error);
+    }
+
+private:
+    ReactionTransformationSet& _transformations;
+    IndigoTransformSetParams& _params;
+    PtrArray<IndigoMolecule>& _batch;
+    ObjArray<Array<char>>& _errors;
+    int _next;
+};
+
+void IndigoTransformSetCommand::execute(OsCommandResult& result_)
+{
+    IndigoTransformSetResult& result = (IndigoTransformSetResult&)result_;
+    result.index = index;
+
+    try
+    {
+        TimeoutCancellationHandler cancellation(params->timeout);
+
+        ReactionTransformation rt;
+        rt.arom_options = params->arom_options;
+        rt.layout_flag = params->layout_flag;
+        rt.smart_layout = params->smart_layout;
+        rt.layout_orientation = params->layout_orientation;
+        rt.cancellation = &cancellation;
+
+        transformations.apply(*molecule, rt);
+    }
+    catch (Exception& e)
+    {
+        result.error.readString(e.message(), true);
+    }
+}
+
+//
+// IndigoTransformSetIter
+//
+
+IndigoTransformSetIter::IndigoTransformSetIter(IndigoTransformSet& set, IndigoObject& source, int threads)
+    : IndigoObject(TRANSFORM_SET_ITER), _set(set), _source(source), _threads(threads), _batch_pos(0), _batch_offset(0)
+{
+}
+
+IndigoTransformSetIter::~IndigoTransformSetIter()
+{
+}
+
+void IndigoTransformSetIter::_readBatch()
+{
+    _batch_offset += _batch.size();
+    _batch.clear();
+    _errors.clear();
+    _batch_pos = 0;
+
+    IndigoObject* item;
+    while (_batch.size() < _TRANSFORM_SET_BATCH_SIZE && (item = _source.next()) != nullptr)
+    {
+        _batch.add(IndigoMolecule::cloneFrom(*item));
+        _errors.push();
+    }
+
+    if (_batch.size() == 0)
+        return;
+
+    Indigo& self = indigoGetInstance();
+
+    IndigoTransformSetParams params;
+    params.arom_options = self.arom_options;
+    params.layout_flag = self.rpe_params.transform_is_layout;
+    params.smart_layout = self.smart_layout;
+    params.layout_orientation = (layout_orientation_value)self.layout_orientation;
+    params.timeout = self.cancellation_timeout;
+
+    IndigoTransformSetDispatcher dispatcher(_set.transformations, params, _batch, _errors);
+    dispatcher.run(_threads);
+}
+
+bool IndigoTransformSetIter::hasNext()
+{
+    if (_batch_pos < _batch.size())
+        return true;
+
+    _readBatch();
+    return _batch.size() > 0;
+}
+
+IndigoObject* IndigoTransformSetIter::next()
+{
+    if (!hasNext())
+        return 0;
+
+    int idx = _batch_pos++;
+    if (_errors[idx].size() > 0)
+        throw IndigoError("transform set: record #%d: %s", _batch_offset + idx, _errors[idx].ptr());
+
+    return _batch.release(idx);
+}
+
+int IndigoTransformSetIter::getIndex()
+{
+    return _batch_offset + _batch_pos - 1;
+}
+
+//
+// API
+//
+
+CEXPORT int indigoCreateTransformSet(int reactions)
+{
+    INDIGO_BEGIN
+    {
+        IndigoObject& obj = self.getObject(reactions);
+        AutoPtr<IndigoTransformSet> set(new IndigoTransformSet());
+
+        ReactionTransformationSet& transformations = set->transformations;
+        transformations.arom_options = self.arom_options;
+
+        if (IndigoArray::is(obj))
+        {
+            IndigoArray& arr = IndigoArray::cast(obj);
+            for (int i = 0; i < arr.objects.size(); i++)
+                transformations.add(arr.objects[i]->getQueryReaction());
+        }
+        else
+            transformations.add(obj.getQueryReaction());
+
+        return self.addObject(set.release());
+    }
+    INDIGO_END(-1);
+}
+
+CEXPORT int indigoApplyTransformSet(int transform_set, int monomers)
+{
+    INDIGO_BEGIN
+    {
+        IndigoTransformSet& set = IndigoTransformSet::cast(self.getObject(transform_set));
+        IndigoObject& obj = self.getObject(monomers);
+
+        TimeoutCancellationHandler cancellation(self.cancellation_timeout);
+
+        ReactionTransformation rt;
+        rt.arom_options = self.arom_options;
+        rt.layout_flag = self.rpe_params.transform_is_layout;
+        rt.smart_layout = self.smart_layout;
+        rt.layout_orientation = (layout_orientation_value)self.layout_orientation;
+        rt.cancellation = &cancellation;
+
+        int applied = 0;
+        if (IndigoArray::is(obj))
+        {
+            IndigoArray& arr = IndigoArray::cast(obj);
+            for (int i = 0; i < arr.objects.size(); i++)
+                applied += set.transformations.apply(arr.objects[i]->getMolecule(), rt);
+        }
+        else
+            applied = set.transformations.apply(obj.getMolecule(), rt);
+
+        return applied;
+    }
+    INDIGO_END(-1);
+}
+
+CEXPORT int indigoIterateTransformSet(int transform_set, int monomers, int threads)
+{
+    INDIGO_BEGIN
+    {
+        IndigoTransformSet& set = IndigoTransformSet::cast(self.getObject(transform_set));
+        IndigoObject& source = self.getObject(monomers);
+
+        return self.addObject(new IndigoTransformSetIter(set, source, threads));
+    }
+    INDIGO_END(-1);
+}
@@ -0,0 +1,65 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __indigo_transform_set__
+#define __indigo_transform_set__
+
+#include "indigo_array.h"
+#include "indigo_internal.h"
+#include "reaction/reaction_transformation_set.h"
+
+class IndigoMolecule;
+
+class IndigoTransformSet : public IndigoObject
+{
+public:
+    IndigoTransformSet();
+    virtual ~IndigoTransformSet();
+
+    static IndigoTransformSet& cast(IndigoObject& obj);
+
+    ReactionTransformationSet transformations;
+};
+
+// Iterates over the transformed copies of the source molecules.
+// Molecules are read from the source by batches, every batch is transformed
+// in parallel, and the results are returned in the input order.
+class IndigoTransformSetIter : public IndigoObject
+{
+public:
+    IndigoTransformSetIter(IndigoTransformSet& set, IndigoObject& source, int threads);
+    virtual ~IndigoTransformSetIter();
+
+    virtual IndigoObject* next();
+    virtual bool hasNext();
+    virtual int getIndex();
+
+protected:
+    void _readBatch();
+
+    IndigoTransformSet& _set;
+    IndigoItemReader _source;
+    int _threads;
+
+    PtrArray<IndigoMolecule> _batch;
+    ObjArray<Array<char>> _errors;
+    int _batch_pos;
+    int _batch_offset;
+};
+
+#endif
@@ -24,6 +24,491 @@ void testTransform()
     indigoFree(transformation);
 }
 
+void testTransformSet()
+{
+    int i;
+    int reactions = indigoCreateArray();
+    int molecules = indigoCreateArray();
+    int set, iter, item;
+    const char* smarts[] = {"[*;+:1]-[*;-:2]>>[*:1]=[*:2]", "[#7:1](=[#8:2])=[#8:3]>>[#7+:1](-[#8-:2])=[#8:3]", "[Cl:1]-[#6:2]>>[I:1]-[#6:2]"};
+    const char* smiles[] = {"[O-][C+]1CCCC1[N+]([O-])=O", "CCO", "ClC1CCCC1N(=O)=O"};
+
+    for (i = 0; i < 3; i++)
+    {
+        int r = indigoLoadReactionSmartsFromString(smarts[i]);
+        int m = indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(reactions, r);
+        indigoArrayAdd(molecules, m);
+        indigoFree(r);
+        indigoFree(m);
+    }
+
+    set = indigoCreateTransformSet(reactions);
+    iter = indigoIterateTransformSet(set, molecules, 2);
+    while ((item = indigoNext(iter)))
+    {
+        printf("Transformed #%d: %s\n", indigoIndex(iter), indigoCanonicalSmiles(item));
+        indigoFree(item);
+    }
+    indigoFree(iter);
+
+    item = indigoLoadMoleculeFromString(smiles[2]);
+    if (indigoApplyTransformSet(set, item) != 2)
+    {
+        printf("Transform set was not applied: %s\n", indigoSmiles(item));
+        exit(-1);
+    }
+    indigoFree(item);
+
+    indigoFree(set);
+    indigoFree(molecules);
+    indigoFree(reactions);
+}
+
+static void checkTautomerHash(const char* first, const char* second)
+{
+    int m1 = indigoLoadMoleculeFromString(first);
+    int m2 = indigoLoadMoleculeFromString(second);
+    char hash[32];
+
+    strcpy(hash, indigoTautomerHash(m1, ""));
+    if (strcmp(hash, indigoTautomerHash(m2, "")) != 0)
+    {
+        printf("Tautomer hashes differ: %s (%s) != %s (%s)\n", hash, first, indigoTautomerHash(m2, ""), second);
+        exit(-1);
+    }
+
+    indigoFree(m2);
+    indigoFree(m1);
+}
+
+void testTautomers()
+{
+    int keto = indigoLoadMoleculeFromString("CC(=O)CC(=O)C");
+    int enol = indigoLoadMoleculeFromString("CC(O)=CC(=O)C");
+    int iter, item, count = 0;
+
+    iter = indigoIterateTautomers(keto, "RSMARTS QUEUE 2 LIMIT 3");
+    while ((item = indigoNext(iter)))
+    {
+        int clone = indigoClone(item);
+        printf("Tautomer #%d: %s\n", indigoIndex(item), indigoSmiles(clone));
+        indigoFree(clone);
+        indigoFree(item);
+        count++;
+    }
+    indigoFree(iter);
+    if (count != 3)
+    {
+        printf("Bounded tautomer enumeration returned %d tautomers\n", count);
+        exit(-1);
+    }
+
+    checkTautomerHash("CC(=O)CC(=O)C", "CC(O)=CC(=O)C");
+    checkTautomerHash("CC(=O)C", "CC(O)=C");
+    checkTautomerHash("Oc1ccccn1", "O=c1cccc[nH]1");
+
+    item = indigoCanonicalTautomer(enol, "");
+    printf("Canonical tautomer: %s\n", indigoCanonicalSmiles(item));
+    indigoFree(item);
+
+    // A part of the tautomers does not give a tautomer-invariant result
+    indigoSetErrorHandler(0, 0);
+    if (indigoTautomerHash(enol, "LIMIT 2") != 0 || strstr(indigoGetLastError(), "truncated") == 0)
+    {
+        printf("Truncated tautomer enumeration was not reported\n");
+        exit(-1);
+    }
+    if (indigoCanonicalTautomer(enol, "INCHI") != -1)
+    {
+        printf("Canonical tautomer was picked by INCHI method\n");
+        exit(-1);
+    }
+    // The method is matched by prefix, and INCHI does not support the limits
+    if (indigoIterateTautomers(keto, "INCHI-foo LIMIT 2") != -1)
+    {
+        printf("INCHI method was not matched by prefix\n");
+        exit(-1);
+    }
+    indigoSetErrorHandler(onError, 0);
+
+    indigoFree(enol);
+    indigoFree(keto);
+
+    // The representative is aromatized even if the basic aromaticity model keeps it kekulized
+    keto = indigoLoadMoleculeFromString("O=c1cccc[nH]1");
+    item = indigoCanonicalTautomer(keto, "");
+    if (strcmp(indigoCanonicalSmiles(item), "O=c1cccc[nH]1") != 0)
+    {
+        printf("Unexpected canonical tautomer of 2-pyridone: %s\n", indigoCanonicalSmiles(item));
+        exit(-1);
+    }
+    indigoFree(item);
+    indigoFree(keto);
+}
+
+static void decompose(int scaffold, int molecules, char* result)
+{
+    int deco = indigoDecomposeMolecules(scaffold, molecules);
+    int iter, item, mol;
+
+    mol = indigoDecomposedMoleculeScaffold(deco);
+    strcpy(result, indigoSmiles(mol));
+    indigoFree(mol);
+
+    iter = indigoIterateDecomposedMolecules(deco);
+    while ((item = indigoNext(iter)))
+    {
+        mol = indigoDecomposedMoleculeWithRGroups(item);
+        strcat(result, " ");
+        strcat(result, indigoSmiles(mol));
+        indigoFree(mol);
+        indigoFree(item);
+    }
+    indigoFree(iter);
+    indigoFree(deco);
+}
+
+static int countScaffoldRSites(int scaffold, int molecules)
+{
+    int deco = indigoDecomposeMolecules(scaffold, molecules);
+    int mol = indigoDecomposedMoleculeScaffold(deco);
+    int count = indigoCountRSites(mol);
+
+    indigoFree(mol);
+    indigoFree(deco);
+    return count;
+}
+
+void testDecomposition()
+{
+    int i;
+    int scaffold = indigoLoadQueryMoleculeFromString("c1ccc(N)cc1");
+    int molecules = indigoCreateArray();
+    const char* smiles[] = {"Oc1ccc(NC)cc1", "Clc1cc(N)ccc1", "CCc1ccc(N(C)C)cc1O", "Nc1ccc(cc1)C(=O)O", "c1ccc(N)c(Br)c1"};
+    char serial[4096], parallel[4096], first_only[4096];
+
+    for (i = 0; i < 5; i++)
+    {
+        int m = indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(molecules, m);
+        indigoFree(m);
+    }
+
+    decompose(scaffold, molecules, serial);
+
+    indigoSetOptionInt("deco-threads", 2);
+    decompose(scaffold, molecules, parallel);
+
+    indigoSetOptionBool("deco-first-embedding-only", 1);
+    decompose(scaffold, molecules, first_only);
+
+    indigoSetOptionInt("deco-threads", 0);
+    indigoSetOptionBool("deco-first-embedding-only", 0);
+
+    printf("Decomposition: %s\n", serial);
+    if (strcmp(serial, parallel) != 0)
+    {
+        printf("Parallel decomposition differs: %s\n", parallel);
+        exit(-1);
+    }
+    printf("First embedding only: %s\n", first_only);
+    if (strcmp(serial, first_only) != 0)
+    {
+        printf("First embedding decomposition differs for a scaffold with one embedding per molecule\n");
+        exit(-1);
+    }
+
+    indigoFree(molecules);
+    indigoFree(scaffold);
+
+    // With a symmetric scaffold the substituents written at different ring atoms share
+    // one R-site only if all the embeddings are searched
+    scaffold = indigoLoadQueryMoleculeFromString("c1ccccc1");
+    molecules = indigoCreateArray();
+    smiles[0] = "c1ccc(O)cc1";
+    smiles[1] = "Clc1ccccc1";
+    smiles[2] = "c1cc(Br)ccc1";
+    for (i = 0; i < 3; i++)
+    {
+        int m = indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(molecules, m);
+        indigoFree(m);
+    }
+
+    if (countScaffoldRSites(scaffold, molecules) != 1)
+    {
+        printf("Substituents of a symmetric scaffold are not merged into one R-site\n");
+        exit(-1);
+    }
+    indigoSetOptionBool("deco-first-embedding-only", 1);
+    if (countScaffoldRSites(scaffold, molecules) != 3)
+    {
+        printf("First embedding only decomposition searched the scaffold automorphisms\n");
+        exit(-1);
+    }
+    indigoSetOptionBool("deco-first-embedding-only", 0);
+
+    indigoFree(molecules);
+    indigoFree(scaffold);
+}
+
+void testDescriptors()
+{
+    int i;
+    int molecules = indigoCreateArray();
+    const char* smiles[] = {"CCO", "c1ccccc1C(=O)O", "[Na+].[Cl-]", "C1CC1C1CCCC1"};
+    int table;
+    const double* mw;
+    const double* components;
+
+    for (i = 0; i < 4; i++)
+    {
+        int m = indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(molecules, m);
+        indigoFree(m);
+    }
+
+    table = indigoComputeDescriptors(molecules, "mw; formula;components", 2);
+    if (indigoCount(table) != 4)
+    {
+        printf("Descriptor table has %d rows instead of 4\n", indigoCount(table));
+        exit(-1);
+    }
+
+    mw = indigoDescriptorColumn(table, 0);
+    components = indigoDescriptorColumn(table, 2);
+    for (i = 0; i < 4; i++)
+    {
+        int m = indigoAt(molecules, i);
+        int gf = indigoGrossFormula(m);
+        double diff = mw[i] - indigoMolecularWeight(m);
+
+        printf("Descriptors: %s %s %.3f %d\n", smiles[i], indigoDescriptorString(table, 1, i), mw[i], (int)components[i]);
+        if (diff > 1e-6 || diff < -1e-6 || strcmp(indigoDescriptorString(table, 1, i), indigoToString(gf)) != 0 ||
+            (int)components[i] != indigoCountComponents(m) || strlen(indigoDescriptorError(table, i)) > 0)
+        {
+            printf("Batch descriptors differ for %s\n", smiles[i]);
+            exit(-1);
+        }
+        indigoFree(gf);
+        indigoFree(m);
+    }
+
+    indigoFree(table);
+    indigoFree(molecules);
+}
+
+void testLayoutBatch()
+{
+    int i;
+    int objects = indigoCreateArray();
+    const char* smiles[] = {"CCO", "C1CCCCCCCCCCCCCCCCCC1", "CC(=O)O.OCC>>CC(=O)OCC", "c1ccc2ccccc2c1"};
+    int result;
+
+    for (i = 0; i < 4; i++)
+    {
+        int obj = i == 2 ? indigoLoadReactionFromString(smiles[i]) : indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(objects, obj);
+        indigoFree(obj);
+    }
+
+    indigoSetOption("molfile-saving-skip-date", "true");
+    result = indigoLayoutBatch(objects, 2, 10000);
+    if (indigoCount(result) != 4)
+    {
+        printf("Layout batch returned %d objects instead of 4\n", indigoCount(result));
+        exit(-1);
+    }
+
+    // Results come in the input order and match the sequential layout
+    for (i = 0; i < 4; i++)
+    {
+        int element = indigoAt(objects, i);
+        int expected = indigoClone(element);
+        int obj = indigoAt(result, i);
+        const char* format = i == 2 ? "rxnfile" : "molfile";
+        char* actual;
+
+        indigoLayout(expected);
+        actual = strdup(i == 2 ? indigoRxnfile(obj) : indigoMolfile(obj));
+        if (indigoHasProperty(obj, "layout-error") || strcmp(actual, i == 2 ? indigoRxnfile(expected) : indigoMolfile(expected)) != 0)
+        {
+            printf("Batch layout %s differs for %s\n", format, smiles[i]);
+            exit(-1);
+        }
+        free(actual);
+        indigoFree(obj);
+        indigoFree(expected);
+        indigoFree(element);
+    }
+
+    indigoFree(result);
+    indigoFree(objects);
+}
+
+void testMacrocycleLayout()
+{
+    const char* smiles = "C1CCCCCCCCCCCC/C=C/CCCC1";
+    int first = indigoLoadMoleculeFromString(smiles);
+    int second = indigoLoadMoleculeFromString(smiles);
+    char* expected;
+
+    // The second layout is taken from the solved macrocycle memo
+    indigoSetOption("smart-layout", "true");
+    indigoLayout(first);
+    expected = strdup(indigoMolfile(first));
+    indigoSetOptionInt("layout-precompute-macrocycles", 20);
+    indigoLayout(second);
+    if (strcmp(expected, indigoMolfile(second)) != 0)
+    {
+        printf("Repeated macrocycle layout differs\n");
+        exit(-1);
+    }
+
+    // A plain ring is served from the rings solved by the precomputation.
+    // Cycloalkanes are taken from the layout patterns, so an azacycle is used.
+    indigoFree(second);
+    second = indigoLoadMoleculeFromString("N1CCCCCCCCCCCCCCCCC1");
+    indigoDbgResetProfiling(0);
+    indigoLayout(second);
+    if (indigoDbgProfilingGetCounter("layout.macrocycle-memo-hits", 0) == 0)
+    {
+        printf("Precomputed macrocycle is not taken from the memo\n");
+        exit(-1);
+    }
+
+    // Every ring up to the size is solved, so the size is limited
+    indigoSetErrorHandler(0, 0);
+    if (indigoSetOptionInt("layout-precompute-macrocycles", 1000) != -1)
+    {
+        printf("Too large precomputed macrocycle size is accepted\n");
+        exit(-1);
+    }
+    indigoSetErrorHandler(onError, 0);
+    indigoSetOptionInt("layout-precompute-macrocycles", 0);
+    indigoSetOption("smart-layout", "false");
+
+    free(expected);
+    indigoFree(second);
+    indigoFree(first);
+}
+
+static float squaredDistance(int mol, int first, int second)
+{
+    int atoms[2];
+    float dx, dy;
+    float* xyz;
+
+    atoms[0] = indigoGetAtom(mol, first);
+    atoms[1] = indigoGetAtom(mol, second);
+    xyz = indigoXYZ(atoms[0]);
+    dx = xyz[0];
+    dy = xyz[1];
+    xyz = indigoXYZ(atoms[1]);
+    dx -= xyz[0];
+    dy -= xyz[1];
+    indigoFree(atoms[1]);
+    indigoFree(atoms[0]);
+    return dx * dx + dy * dy;
+}
+
+static int isCloseTo(float value, float expected)
+{
+    return value > expected * 0.9f && value < expected * 1.1f;
+}
+
+void testClean2dIncremental()
+{
+    int mol = indigoLoadMoleculeFromString("CCCCCCCCCCCCCCCCCCCC");
+    int edited[] = {1};
+    int atom, far_atom;
+    float before[3];
+    float bond, angle;
+    float* xyz;
+
+    indigoLayout(mol);
+    // Squared bond length and squared distance between the ends of a bond angle
+    bond = squaredDistance(mol, 0, 1);
+    angle = squaredDistance(mol, 0, 2);
+    far_atom = indigoGetAtom(mol, 19);
+    memcpy(before, indigoXYZ(far_atom), sizeof(before));
+
+    atom = indigoGetAtom(mol, 1);
+    xyz = indigoXYZ(atom);
+    indigoSetXYZ(atom, xyz[0] + 0.5f, xyz[1] - 0.5f, 0);
+
+    if (isCloseTo(squaredDistance(mol, 0, 1), bond))
+    {
+        printf("The edit did not distort the bonds\n");
+        exit(-1);
+    }
+
+    if (indigoClean2dIncremental(mol, 1, edited) != 0)
+    {
+        printf("Incremental clean failed: %s\n", indigoGetLastError());
+        exit(-1);
+    }
+    // Bonds and the angle at the edited atom are restored
+    if (!isCloseTo(squaredDistance(mol, 0, 1), bond) || !isCloseTo(squaredDistance(mol, 1, 2), bond) || !isCloseTo(squaredDistance(mol, 0, 2), angle))
+    {
+        printf("Incremental clean did not restore the geometry around the edited atom\n");
+        exit(-1);
+    }
+    // Atoms far from the edited one are not moved
+    xyz = indigoXYZ(far_atom);
+    if (xyz[0] != before[0] || xyz[1] != before[1])
+    {
+        printf("Incremental clean moved a distant atom\n");
+        exit(-1);
+    }
+
+    indigoFree(far_atom);
+    indigoFree(atom);
+    indigoFree(mol);
+}
+
+// Scaffolds are query molecules, so they are loaded back as molecules to get canonical SMILES
+static void scaffoldCanonicalSmiles(int scaffold, char* result)
+{
+    int mol = indigoLoadMoleculeFromString(indigoSmiles(scaffold));
+
+    strcpy(result, indigoCanonicalSmiles(mol));
+    indigoFree(mol);
+}
+
+void testScaffoldTree()
+{
+    int i;
+    int molecules = indigoCreateArray();
+    const char* smiles[] = {"Oc1ccc(NC)cc1", "Clc1cc(N)ccc1CC", "CCc1ccc(N(C)C)cc1O", "Nc1ccc(cc1)C(=O)O", "c1ccc(N)c(Br)c1", "Nc1ccc(C)cc1C"};
+    int serial, tree;
+    char serial_smiles[1024], tree_smiles[1024];
+
+    for (i = 0; i < 6; i++)
+    {
+        int m = indigoLoadMoleculeFromString(smiles[i]);
+        indigoArrayAdd(molecules, m);
+        indigoFree(m);
+    }
+
+    serial = indigoExtractCommonScaffold(molecules, "EXACT");
+    tree = indigoExtractCommonScaffold(molecules, "EXACT THREADS 2");
+
+    scaffoldCanonicalSmiles(serial, serial_smiles);
+    scaffoldCanonicalSmiles(tree, tree_smiles);
+    printf("Scaffold: %s\n", tree_smiles);
+    if (strcmp(serial_smiles, "Nc1ccccc1") != 0 || strcmp(tree_smiles, serial_smiles) != 0)
+    {
+        printf("Tree reduction scaffold differs: %s != %s\n", tree_smiles, serial_smiles);
+        exit(-1);
+    }
+
+    indigoFree(tree);
+    indigoFree(serial);
+    indigoFree(molecules);
+}
+
 int main(void)
 {
     int m;
@@ -53,6 +538,14 @@ int main(void)
     indigoFree(m);
 
     testTransform();
+    testTransformSet();
+    testTautomers();
+    testDecomposition();
+    testDescriptors();
+    testLayoutBatch();
+    testMacrocycleLayout();
+    testClean2dIncremental();
+    testScaffoldTree();
 
     r = indigoLoadReactionFromString("C.CC>>CC.C");
     gf = indigoGrossFormula(r);
@@ -381,7 +381,11 @@ BINGO_END("", "")
 CEXPORT const char* bingoImportGetPropertyValue(int idx){
     BINGO_BEGIN{if (self.import_properties.get() == 0) throw BingoError("bingo import list has not been parsed yet");
 const char* property_name = self.import_properties.ref().at(idx);
-if (self.sdf_loader.get())
+if (self.sdf_import_dispatcher.get())
+{
+    return self.sdf_import_dispatcher->getProperty(property_name);
+}
+else if (self.sdf_loader.get())
 {
     return self.sdf_loader->properties.at(property_name);
 }
@@ -405,21 +409,41 @@ return 1;
 BINGO_END(-1, -1)
 }
 
+CEXPORT int bingoSDFImportOpenParallel(const char* file_name, int nthreads, int validate)
+{
+    BINGO_BEGIN
+    {
+        bingoSDFImportClose();
+
+        if (validate && self.bingo_context == 0)
+            throw BingoError("context not set");
+
+        self.file_scanner.create(file_name);
+        self.sdf_import_dispatcher.reset(new SdfImportDispatcher(self.file_scanner.ref(), nthreads, validate ? self.bingo_context : 0));
+        return 1;
+    }
+    BINGO_END(-1, -1)
+}
+
 CEXPORT int bingoSDFImportClose()
 {
     BINGO_BEGIN
     {
+        self.sdf_import_dispatcher.reset(0);
         self.sdf_loader.free();
         self.file_scanner.free();
     }
     BINGO_END(0, -1);
 }
 
-CEXPORT int bingoSDFImportEOF(){BINGO_BEGIN{return self.sdf_loader->isEOF() ? 1 : 0;
+CEXPORT int bingoSDFImportEOF(){BINGO_BEGIN{if (self.sdf_import_dispatcher.get()) return self.sdf_import_dispatcher->isEOF() ? 1 : 0;
+return self.sdf_loader->isEOF() ? 1 : 0;
 }
 BINGO_END(0, -1)
 }
-CEXPORT const char* bingoSDFImportGetNext(){BINGO_BEGIN{profTimerStart(t, "sdf_loader.readNext");
+CEXPORT const char* bingoSDFImportGetNext(){BINGO_BEGIN{if (self.sdf_import_dispatcher.get()) return self.sdf_import_dispatcher->readNext();
+
+profTimerStart(t, "sdf_loader.readNext");
 self.sdf_loader->readNext();
 self.sdf_loader->data.push(0);
 return self.sdf_loader->data.ptr();
@@ -427,7 +451,8 @@ return self.sdf_loader->data.ptr();
 BINGO_END("", 0)
 }
 
-CEXPORT const char* bingoSDFImportGetProperty(const char* param_name){BINGO_BEGIN{return self.sdf_loader->properties.at(param_name);
+CEXPORT const char* bingoSDFImportGetProperty(const char* param_name){BINGO_BEGIN{if (self.sdf_import_dispatcher.get()) return self.sdf_import_dispatcher->getProperty(param_name);
+return self.sdf_loader->properties.at(param_name);
 }
 BINGO_END("", 0)
 }
@@ -54,6 +54,13 @@ CEXPORT const char* bingoImportGetPropertyValue(int idx);
  * SDF import
  */
 CEXPORT int bingoSDFImportOpen(const char* file_name);
+/*
+ * The same with the records parsed in nthreads worker threads (-1 for
+ * automatic selection) and returned in the file order. If validate is not
+ * zero, molfiles are checked with the current context settings, and
+ * bingoSDFImportGetNext fails for the invalid ones.
+ */
+CEXPORT int bingoSDFImportOpenParallel(const char* file_name, int nthreads, int validate);
 CEXPORT int bingoSDFImportClose();
 CEXPORT int bingoSDFImportEOF();
 CEXPORT const char* bingoSDFImportGetNext();
@@ -110,6 +117,9 @@ CEXPORT int mangoSetupMatch(const char* search_type, const char* query, const ch
 CEXPORT int mangoSimilarityGetBitMinMaxBoundsArray(int count, int* target_ones, int** min_bound_ptr, int** max_bound_ptr);
 
 CEXPORT int mangoSimilarityGetScore(float* score);
+// Returns the similarity score of a target by the number of its fingerprint
+// ones and the number of the ones common with the query
+CEXPORT int mangoSimilarityGetScoreFromBits(int target_ones, int common_ones, float* score);
 CEXPORT int mangoSimilaritySetMinMaxBounds(float min_bound, float max_bound);
 // Return value:
 //   1 if the query is a substructure of the taret
@@ -125,6 +135,17 @@ CEXPORT int mangoMatchTarget(const char* target, int target_buf_len);
 //  -2 if some other thing is bad ("sound" error)
 CEXPORT int mangoMatchTargetBinary(const char* target_bin, int target_bin_len, const char* target_xyz, int target_xyz_len);
 
+// Sets the number of decoded targets kept by the process-wide target cache.
+// Zero disables the cache.
+CEXPORT int mangoSetTargetCacheSize(int size);
+// Matches the cached target with the given id. Sets found to 0 and returns 0
+// if the target is not cached or the search type does not use the cache.
+// Return value is the same as for mangoMatchTargetBinary.
+CEXPORT int mangoMatchCachedTarget(qword target_id, int* found);
+// Same as mangoMatchTargetBinary without coordinates, but also puts the
+// decoded target into the cache under the given id
+CEXPORT int mangoMatchTargetBinaryCached(qword target_id, const char* target_bin, int target_bin_len);
+
 CEXPORT int mangoLoadTargetBinaryXyz(const char* target_xyz, int target_xyz_len);
 CEXPORT int mangoSetHightlightingMode(int enable);
 CEXPORT const char* mangoGetHightlightedMolecule();
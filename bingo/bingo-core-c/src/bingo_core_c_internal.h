@@ -76,6 +76,7 @@ namespace indigo
             Obj<FileScanner> file_scanner;
             Obj<SdfLoader> sdf_loader;
             Obj<RdfLoader> rdf_loader;
+            AutoPtr<SdfImportDispatcher> sdf_import_dispatcher;
 
             AutoPtr<GZipScanner> gz_scanner;
             Scanner* smiles_scanner;
@@ -23,6 +23,7 @@
 #include "ringo_core_c_parallel.h"
 
 #include "base_cpp/profiling.h"
+#include "gzip/gzip_scanner.h"
 #include "molecule/cmf_saver.h"
 #include "reaction/crf_saver.h"
 
@@ -197,3 +198,378 @@ void IndexingCommandResult::clear()
     error_ids.clear();
     error_messages.clear();
 }
+
+//
+// SdfImportRecords
+//
+void SdfImportRecords::clear()
+{
+    data.clear();
+    errors.clear();
+    property_names.clear();
+    property_values.clear();
+    property_ends.clear();
+}
+
+int SdfImportRecords::count()
+{
+    return property_ends.size();
+}
+
+void SdfImportRecords::add(const Array<char>& record, PropertiesMap& properties, const char* error)
+{
+    data.add(record);
+    errors.add(error);
+    for (auto i : properties.elements())
+    {
+        property_names.add(properties.key(i));
+        property_values.add(properties.value(i));
+    }
+    property_ends.push(property_names.count());
+}
+
+void SdfImportRecords::append(SdfImportRecords& other)
+{
+    int first = property_names.count();
+
+    for (int i = 0; i < other.count(); i++)
+    {
+        data.add(other.data.get(i), other.data.getSize(i));
+        errors.add(other.errors.get(i), other.errors.getSize(i));
+        property_ends.push(first + other.property_ends[i]);
+    }
+    for (int i = 0; i < other.property_names.count(); i++)
+    {
+        property_names.add(other.property_names.get(i), other.property_names.getSize(i));
+        property_values.add(other.property_values.get(i), other.property_values.getSize(i));
+    }
+}
+
+//
+// SdfImportCommand
+//
+void SdfImportCommand::clear()
+{
+    text.clear();
+    validation_context = 0;
+}
+
+void SdfImportCommand::execute(OsCommandResult& result_)
+{
+    SdfImportCommandResult& result = (SdfImportCommandResult&)result_;
+    QS_DEF(Array<char>, record);
+    QS_DEF(Molecule, mol);
+    PropertiesMap no_properties;
+
+    // SdfLoader reads two bytes to detect gzipped input
+    if (text.size() < 2)
+        text.push('\n');
+
+    BufferScanner scanner(text);
+    SdfLoader loader(scanner);
+
+    while (!loader.isEOF())
+    {
+        try
+        {
+            loader.readNext();
+        }
+        catch (Exception& e)
+        {
+            // The next record is read from the same position as SdfLoader does
+            record.clear();
+            record.push(0);
+            result.records.add(record, no_properties, e.message());
+            continue;
+        }
+
+        record.copy(loader.data);
+        record.push(0);
+
+        if (validation_context != 0)
+        {
+            TRY_READ_TARGET_MOL
+            {
+                BufferScanner mol_scanner(loader.data);
+                MoleculeAutoLoader mol_loader(mol_scanner);
+                validation_context->setLoaderSettings(mol_loader);
+                mol_loader.loadMolecule(mol);
+            }
+            CATCH_READ_TARGET_MOL({
+                result.records.add(record, loader.properties, e.message());
+                continue;
+            });
+        }
+
+        result.records.add(record, loader.properties, "");
+    }
+}
+
+//
+// SdfImportCommandResult
+//
+void SdfImportCommandResult::clear()
+{
+    records.clear();
+}
+
+//
+// SdfImportDispatcher
+//
+SdfImportDispatcher::SdfImportDispatcher(Scanner& scanner, int nthreads, BingoContext* validation_context)
+    : OsCommandDispatcher(HANDLING_ORDER_SERIAL, false)
+{
+    // Detect if the input is gzipped the same way as SdfLoader
+    byte id[2];
+    long long pos = scanner.tell();
+
+    scanner.readCharsFix(2, (char*)id);
+    scanner.seek(pos, SEEK_SET);
+
+    if (id[0] == 0x1f && id[1] == 0x8b)
+    {
+        _gzip_scanner.reset(new GZipScanner(scanner));
+        _scanner = _gzip_scanner.get();
+    }
+    else
+        _scanner = &scanner;
+
+    _nthreads = nthreads;
+    if (nthreads < 0)
+        nthreads = 3 * osGetProcessorsCount() / 2 + 1;
+    _commands_per_run = __max(nthreads, 1) * COMMANDS_PER_THREAD;
+    _commands_left = 0;
+    _finished = false;
+    _validation_context = validation_context;
+    _block_pos = 0;
+    _line_start = 0;
+    _next_record = 0;
+    _property_begin = _property_end = 0;
+}
+
+bool SdfImportDispatcher::isEOF()
+{
+    while (_next_record == _records.count() && !_finished)
+        _readRecords();
+
+    return _next_record == _records.count() && _split_error.size() == 0;
+}
+
+const char* SdfImportDispatcher::readNext()
+{
+    if (isEOF())
+        throw BingoError("SDF import: end of stream");
+
+    _property_begin = _property_end = 0;
+
+    if (_next_record == _records.count())
+    {
+        // Only the splitting error is left, it is reported once
+        Array<char> message;
+        message.copy(_split_error);
+        _split_error.clear();
+        throw BingoError("SDF import: %s", message.ptr());
+    }
+
+    int idx = _next_record++;
+
+    _property_begin = idx > 0 ? _records.property_ends[idx - 1] : 0;
+    _property_end = _records.property_ends[idx];
+
+    if (_records.errors.getSize(idx) > 1)
+        throw BingoError("SDF import: %s", (const char*)_records.errors.get(idx));
+
+    return (const char*)_records.data.get(idx);
+}
+
+const char* SdfImportDispatcher::getProperty(const char* name)
+{
+    // Records have a few properties, and only some of them are requested
+    for (int i = _property_begin; i < _property_end; i++)
+        if (strcmp((const char*)_records.property_names.get(i), name) == 0)
+            return (const char*)_records.property_values.get(i);
+
+    throw BingoError("SDF import: property '%s' not found", name);
+}
+
+void SdfImportDispatcher::_readRecords()
+{
+    profTimerStart(t, "sdf_import.readRecords");
+
+    _records.clear();
+    _next_record = 0;
+    _commands_left = _commands_per_run;
+
+    try
+    {
+        run(_nthreads);
+    }
+    catch (Exception&)
+    {
+        // The records after an unexpected error are not read
+        _finished = true;
+        throw;
+    }
+}
+
+OsCommand* SdfImportDispatcher::_allocateCommand()
+{
+    return new SdfImportCommand();
+}
+
+OsCommandResult* SdfImportDispatcher::_allocateResult()
+{
+    return new SdfImportCommandResult();
+}
+
+bool SdfImportDispatcher::_setupCommand(OsCommand& cmd)
+{
+    if (_finished || _commands_left == 0)
+        return false;
+
+    profTimerStart(t, "sdf_import.setupCommand");
+
+    SdfImportCommand& command = (SdfImportCommand&)cmd;
+    command.validation_context = _validation_context;
+
+    // Exceptions are not expected by the dispatcher here, so the
+    // error is reported after the records that are read before it
+    int records_end = 0;
+    try
+    {
+        for (int i = 0; i < RECORDS_PER_COMMAND; i++)
+        {
+            if (!_splitRecord(command.text))
+                break;
+            records_end = command.text.size();
+        }
+        if (_lookNext() < 0)
+            _finished = true;
+    }
+    catch (Exception& e)
+    {
+        command.text.resize(records_end);
+        _split_error.readString(e.message(), true);
+        _finished = true;
+    }
+
+    _commands_left--;
+    return command.text.size() > 0;
+}
+
+void SdfImportDispatcher::_handleResult(OsCommandResult& res)
+{
+    profTimerStart(t, "sdf_import.handleResult");
+    SdfImportCommandResult& result = (SdfImportCommandResult&)res;
+    _records.append(result.records);
+}
+
+// Appends the next record to text without parsing it, following the
+// record boundaries of SdfLoader: molfile lines up to a "$$$$" line or
+// a line starting with '>', then data items up to a "$$$$" line. Value
+// lines of a data item are never taken for the end of the record.
+bool SdfImportDispatcher::_splitRecord(Array<char>& text)
+{
+    int start = text.size();
+
+    // Space characters before the record are a part of its data
+    while (_lookNext() >= 0 && isspace(_lookNext()))
+        text.push(_block[_block_pos++]);
+
+    if (_lookNext() < 0)
+    {
+        text.resize(start);
+        return false;
+    }
+
+    int data_size = text.size() - start;
+    bool in_items = false;
+
+    while (_lookNext() >= 0)
+    {
+        int len = _readLine(text);
+        const char* line = text.ptr() + _line_start;
+
+        if (len >= 4 && strncmp(line, "$$$$", 4) == 0)
+            break;
+
+        if (!in_items)
+        {
+            if (len == 0 || line[0] != '>')
+            {
+                data_size += len + 1;
+                if (data_size > MAX_DATA_SIZE)
+                    throw Exception("data size exceeded the acceptable size %d bytes, Please check for correct file format", MAX_DATA_SIZE);
+                continue;
+            }
+            in_items = true;
+        }
+
+        // Data header "> <name>" is followed by the value lines up to an empty line
+        const char* open = (const char*)memchr(line, '<', len);
+        const char* close = open != 0 ? (const char*)memchr(open + 1, '>', line + len - open - 1) : 0;
+
+        if (close != 0 && close > open + 1 && _lookNext() >= 0)
+        {
+            len = _readLine(text);
+            while (len > 0 && _lookNext() >= 0)
+                len = _readLine(text);
+        }
+    }
+    return true;
+}
+
+// Appends the next line to text as is and returns its length without
+// the line end, which is detected the same way as in Scanner::readLine
+int SdfImportDispatcher::_readLine(Array<char>& text)
+{
+    _line_start = text.size();
+
+    while (_lookNext() >= 0)
+    {
+        const char* block = _block.ptr() + _block_pos;
+        int n = _block.size() - _block_pos;
+        int i = 0;
+
+        while (i < n && block[i] != '\n' && block[i] != '\r')
+            i++;
+
+        text.concat(block, i);
+        _block_pos += i;
+        if (i == n)
+            continue;
+
+        int len = text.size() - _line_start;
+        char c = _block[_block_pos++];
+
+        text.push(c);
+        if (c == '\r' && _lookNext() == '\n')
+            text.push(_block[_block_pos++]);
+        return len;
+    }
+    return text.size() - _line_start;
+}
+
+bool SdfImportDispatcher::_readBlock()
+{
+    _block.clear();
+    _block_pos = 0;
+
+    if (_gzip_scanner.get() != 0)
+    {
+        // Length of the uncompressed data is unknown
+        while (_block.size() < BLOCK_SIZE && !_scanner->isEOF())
+            _block.push(_scanner->readChar());
+    }
+    else
+    {
+        long long left = _scanner->length() - _scanner->tell();
+
+        if (left > 0)
+        {
+            _block.resize((int)__min(left, (long long)BLOCK_SIZE));
+            _scanner->read(_block.size(), _block.ptr());
+        }
+    }
+    return _block.size() > 0;
+}
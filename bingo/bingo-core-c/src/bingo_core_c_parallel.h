@@ -19,10 +19,14 @@
 #ifndef __bingo_core_c_parallel_h___
 #define __bingo_core_c_parallel_h___
 
+#include "base_cpp/auto_ptr.h"
 #include "base_cpp/chunk_storage.h"
 #include "base_cpp/os_thread_wrapper.h"
+#include "base_cpp/properties_map.h"
+#include "core/bingo_context.h"
+#include "core/bingo_index.h"
 
-// Helper classes for parallelized indexing
+// Helper classes for parallelized indexing and import
 
 namespace indigo
 {
@@ -102,6 +106,118 @@ namespace indigo
             OsLock _lock_for_exclusive_access;
         };
 
+        // Parsed records of an SDF file: the text of each record, its
+        // properties and an error message (empty if the record is correct)
+        class SdfImportRecords
+        {
+        public:
+            void clear();
+            int count();
+
+            void add(const Array<char>& record, PropertiesMap& properties, const char* error);
+            void append(SdfImportRecords& other);
+
+            ChunkStorage data;
+            ChunkStorage errors;
+            ChunkStorage property_names;
+            ChunkStorage property_values;
+            // Index of the property after the last property of each record
+            Array<int> property_ends;
+        };
+
+        // This command contains the text of several SDF records
+        class SdfImportCommand : public OsCommand
+        {
+        public:
+            virtual void execute(OsCommandResult& result);
+            virtual void clear();
+
+            Array<char> text;
+
+            // If not null, molfiles are loaded with the settings of this
+            // context to check them
+            BingoContext* validation_context;
+        };
+
+        class SdfImportCommandResult : public OsCommandResult
+        {
+        public:
+            virtual void clear();
+
+            SdfImportRecords records;
+        };
+
+        // Reader of an SDF file for import. The calling thread splits the
+        // file into the records, and the worker threads parse them into the
+        // text and properties (and optionally check the molfiles). Results of
+        // a number of commands are collected in the file order at once, and
+        // then returned one by one like SdfLoader does.
+        class SdfImportDispatcher : public OsCommandDispatcher
+        {
+        public:
+            // Parameters:
+            //    nthreads - number of worker threads, -1 for automatic
+            //       selection and 0 for parsing in the calling thread
+            //    validation_context - context to check molfiles with, or null
+            SdfImportDispatcher(Scanner& scanner, int nthreads, BingoContext* validation_context);
+
+            bool isEOF();
+            // Returns the text of the next record. Throws an error if the
+            // record can not be imported.
+            const char* readNext();
+            // Returns a property of the current record
+            const char* getProperty(const char* name);
+
+        private:
+            enum
+            {
+                RECORDS_PER_COMMAND = 100,
+                COMMANDS_PER_THREAD = 4,
+                BLOCK_SIZE = 65536,
+                // The same limit as in SdfLoader
+                MAX_DATA_SIZE = 10485760
+            };
+
+            virtual OsCommand* _allocateCommand();
+            virtual OsCommandResult* _allocateResult();
+
+            virtual bool _setupCommand(OsCommand& command);
+            virtual void _handleResult(OsCommandResult& result);
+
+            void _readRecords();
+            bool _splitRecord(Array<char>& text);
+            int _readLine(Array<char>& text);
+            bool _readBlock();
+
+            inline int _lookNext()
+            {
+                if (_block_pos == _block.size() && !_readBlock())
+                    return -1;
+                return (byte)_block[_block_pos];
+            }
+
+            Scanner* _scanner;
+            AutoPtr<Scanner> _gzip_scanner;
+            int _nthreads;
+            int _commands_per_run;
+            int _commands_left;
+            bool _finished;
+            BingoContext* _validation_context;
+
+            // Error of splitting the file, reported after the records before it
+            Array<char> _split_error;
+            // The input is split in blocks without virtual calls per character
+            Array<char> _block;
+            int _block_pos;
+            int _line_start;
+
+            SdfImportRecords _records;
+            int _next_record;
+            // Properties of the current record
+            int _property_begin;
+            int _property_end;
+        };
+
     } // namespace bingo_core
 } // namespace indigo
 
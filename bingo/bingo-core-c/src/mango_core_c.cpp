@@ -19,6 +19,7 @@
 #include "bingo_core_c_internal.h"
 
 #include "base_cpp/profiling.h"
+#include "core/mango_target_cache.h"
 #include "molecule/canonical_smiles_saver.h"
 #include "molecule/cmf_saver.h"
 #include "molecule/cml_saver.h"
@@ -294,6 +295,14 @@ MangoSimilarity& similarity = self.mango_context->similarity;
 BINGO_END(-2, 1)
 }
 
+CEXPORT int mangoSimilarityGetScoreFromBits(int target_ones, int common_ones, float* score){
+    BINGO_BEGIN{if (self.mango_search_type != BingoCore::_SIMILARITY) throw BingoError("Undefined search type");
+MangoSimilarity& similarity = self.mango_context->similarity;
+*score = similarity.getScore(target_ones, common_ones);
+}
+BINGO_END(1, -2)
+}
+
 CEXPORT int mangoSimilaritySetMinMaxBounds(float min_bound, float max_bound){
     BINGO_BEGIN{if (self.mango_search_type != BingoCore::_SIMILARITY) throw BingoError("Undefined search type");
 MangoSimilarity& similarity = self.mango_context->similarity;
@@ -388,7 +397,7 @@ CEXPORT int mangoMatchTargetBinary(const char* target_bin, int target_bin_len, c
             if (self.mango_search_type == BingoCore::_SUBSTRUCTRE)
             {
                 MangoSubstructure& substructure = self.mango_context->substructure;
-                return substructure.matchBinary(scanner, xyz_scanner) ? 1 : 0;
+                return substructure.matchBinary(target_bin, target_bin_len, xyz_scanner) ? 1 : 0;
             }
             else if (self.mango_search_type == BingoCore::_TAUTOMER)
             {
@@ -413,6 +422,61 @@ CEXPORT int mangoMatchTargetBinary(const char* target_bin, int target_bin_len, c
     BINGO_END(-2, -2)
 }
 
+CEXPORT int mangoSetTargetCacheSize(int size)
+{
+    BINGO_BEGIN
+    {
+        MangoTargetCache::getInstance().setMaxSize(size);
+    }
+    BINGO_END(1, -2)
+}
+
+CEXPORT int mangoMatchCachedTarget(qword target_id, int* found)
+{
+    profTimerStart(t0, "match.match_cached_target");
+
+    BINGO_BEGIN_TIMEOUT
+    {
+        if (self.mango_search_type == BingoCore::_UNDEF)
+            throw BingoError("Undefined search type");
+
+        *found = 0;
+
+        if (self.mango_search_type != BingoCore::_SUBSTRUCTRE)
+            return 0;
+
+        TRY_READ_TARGET_MOL
+        {
+            MangoSubstructure& substructure = self.mango_context->substructure;
+            bool target_found;
+            bool res = substructure.matchCachedTarget(target_id, target_found);
+            *found = target_found ? 1 : 0;
+            return res ? 1 : 0;
+        }
+        CATCH_READ_TARGET_MOL(self.warning.readString(e.message(), 1); return -1;);
+    }
+    BINGO_END(-2, -2)
+}
+
+CEXPORT int mangoMatchTargetBinaryCached(qword target_id, const char* target_bin, int target_bin_len)
+{
+    if (BingoCore::getInstance().mango_search_type != BingoCore::_SUBSTRUCTRE)
+        return mangoMatchTargetBinary(target_bin, target_bin_len, 0, 0);
+
+    profTimerStart(t0, "match.match_target_binary");
+
+    BINGO_BEGIN_TIMEOUT
+    {
+        TRY_READ_TARGET_MOL
+        {
+            MangoSubstructure& substructure = self.mango_context->substructure;
+            return substructure.matchBinaryCached(target_id, target_bin, target_bin_len) ? 1 : 0;
+        }
+        CATCH_READ_TARGET_MOL(self.warning.readString(e.message(), 1); return -1;);
+    }
+    BINGO_END(-2, -2)
+}
+
 CEXPORT int mangoLoadTargetBinaryXyz(const char* target_xyz, int target_xyz_len)
 {
     profTimerStart(t0, "match.match_target_binary");
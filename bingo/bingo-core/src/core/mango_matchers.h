@@ -53,6 +53,13 @@ public:
 
     bool matchBinary(const Array<char>& target_buf, const Array<char>* xyz_buf);
     bool matchBinary(Scanner& scanner, Scanner* xyz_scanner);
+    bool matchBinary(const char* target_bin, int target_bin_len, Scanner* xyz_scanner);
+
+    // Matching of database targets through the process-wide cache of decoded
+    // targets. Coordinates are not cached, so these are for queries that do
+    // not need them.
+    bool matchCachedTarget(qword target_id, bool& found);
+    bool matchBinaryCached(qword target_id, const char* target_bin, int target_bin_len);
 
     void loadBinaryTargetXyz(Scanner& xyz_scanner);
 
@@ -100,6 +107,8 @@ protected:
     void _initQuery(QueryMolecule& query_in, QueryMolecule& query_out);
     void _initSmartsQuery(QueryMolecule& query_in, QueryMolecule& query_out);
     void _initTarget(bool from_database);
+    void _loadBinaryTarget(Scanner* xyz_scanner);
+    int _getTargetCacheFlags();
 
     void _correctQueryStereo(QueryMolecule& query);
 };
@@ -206,6 +215,8 @@ public:
     int getUpperBound(int target_ones);
 
     bool match(int ones_target, int ones_common);
+    // Similarity score for the given numbers of target and common ones
+    float getScore(int ones_target, int ones_common);
     bool matchBinary(Scanner& scanner);
 
     const byte* getQueryFingerprint();
@@ -135,6 +135,12 @@ float MangoSimilarity::_similarity(int ones1, int ones2, int ones_common, Metric
     return (float)numerator / denominator;
 }
 
+float MangoSimilarity::getScore(int ones_target, int ones_common)
+{
+    float numerator, denominator;
+    return _similarity(_query_ones, ones_target, ones_common, metrics, numerator, denominator);
+}
+
 float MangoSimilarity::getSimilarityScore()
 {
     return (float)_numerator_value / _denominator_value;
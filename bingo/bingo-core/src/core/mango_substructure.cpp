@@ -23,6 +23,7 @@
 #include "core/bingo_error.h"
 #include "core/mango_index.h"
 #include "core/mango_matchers.h"
+#include "core/mango_target_cache.h"
 #include "layout/molecule_layout.h"
 #include "molecule/molecule_auto_loader.h"
 #include "molecule/molecule_substructure_matcher.h"
@@ -300,14 +301,12 @@ bool MangoSubstructure::needCoords()
 
 bool MangoSubstructure::matchBinary(const Array<char>& target_buf, const Array<char>* xyz_buf)
 {
-    BufferScanner scanner(target_buf);
-
     if (xyz_buf == 0)
-        return matchBinary(scanner, 0);
+        return matchBinary(target_buf.ptr(), target_buf.size(), 0);
 
     BufferScanner xyz_scanner(*xyz_buf);
 
-    return matchBinary(scanner, &xyz_scanner);
+    return matchBinary(target_buf.ptr(), target_buf.size(), &xyz_scanner);
 }
 
 bool MangoSubstructure::matchBinary(Scanner& scanner, Scanner* xyz_scanner)
@@ -318,18 +317,98 @@ bool MangoSubstructure::matchBinary(Scanner& scanner, Scanner* xyz_scanner)
 
     cmf_loader.free();
     cmf_loader.create(_context.cmf_dict, scanner);
+    _loadBinaryTarget(xyz_scanner);
+
+    profTimerStop(tcmf);
+
+    profTimerStart(tinit, "match.init_target");
+    _initTarget(true);
+    profTimerStop(tinit);
+
+    return matchLoadedTarget();
+}
+
+bool MangoSubstructure::matchBinary(const char* target_bin, int target_bin_len, Scanner* xyz_scanner)
+{
+    _validateQueryExtraData();
+
+    profTimerStart(tcmf, "match.cmf");
+
+    cmf_loader.free();
+    cmf_loader.create(_context.cmf_dict, target_bin, target_bin_len);
+    _loadBinaryTarget(xyz_scanner);
+
+    profTimerStop(tcmf);
+
+    profTimerStart(tinit, "match.init_target");
+    _initTarget(true);
+    profTimerStop(tinit);
 
+    return matchLoadedTarget();
+}
+
+void MangoSubstructure::_loadBinaryTarget(Scanner* xyz_scanner)
+{
     if (!_query_has_stereocare_bonds)
         cmf_loader->skip_cistrans = true;
     if (!_query_has_stereocenters)
         cmf_loader->skip_stereocenters = true;
+    // S-groups of the target are only saved with the highlighting
+    if (!preserve_bonds_on_highlighting)
+        cmf_loader->skip_sgroups = true;
 
     cmf_loader->loadMolecule(_target);
     if (xyz_scanner != 0)
         cmf_loader->loadXyz(*xyz_scanner);
+}
+
+int MangoSubstructure::_getTargetCacheFlags()
+{
+    int flags = 0;
+    if (!_query_has_stereocare_bonds)
+        flags |= 1;
+    if (!_query_has_stereocenters)
+        flags |= 2;
+    if (!preserve_bonds_on_highlighting)
+        flags |= 4;
+    return flags;
+}
+
+bool MangoSubstructure::matchCachedTarget(qword target_id, bool& found)
+{
+    _validateQueryExtraData();
+
+    profTimerStart(tcache, "match.cached_target");
+    found = MangoTargetCache::getInstance().get(target_id, _getTargetCacheFlags(), _target);
+    profTimerStop(tcache);
+
+    if (!found)
+        return false;
+
+    // The target was not decoded here, so there is nothing to load coordinates from
+    cmf_loader.free();
+
+    profTimerStart(tinit, "match.init_target");
+    _initTarget(true);
+    profTimerStop(tinit);
+
+    return matchLoadedTarget();
+}
+
+bool MangoSubstructure::matchBinaryCached(qword target_id, const char* target_bin, int target_bin_len)
+{
+    _validateQueryExtraData();
+
+    profTimerStart(tcmf, "match.cmf");
+
+    cmf_loader.free();
+    cmf_loader.create(_context.cmf_dict, target_bin, target_bin_len);
+    _loadBinaryTarget(0);
 
     profTimerStop(tcmf);
 
+    MangoTargetCache::getInstance().put(target_id, _getTargetCacheFlags(), _target);
+
     profTimerStart(tinit, "match.init_target");
     _initTarget(true);
     profTimerStop(tinit);
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "core/mango_target_cache.h"
+#include "base_cpp/profiling.h"
+
+IMPL_ERROR(MangoTargetCache, "mango target cache");
+
+MangoTargetCache::MangoTargetCache() : _maxSize(0), _first(-1), _last(-1)
+{
+}
+
+MangoTargetCache& MangoTargetCache::getInstance()
+{
+    static MangoTargetCache instance;
+    return instance;
+}
+
+void MangoTargetCache::setMaxSize(int max_size)
+{
+    OsLocker locker(_lock);
+
+    if (max_size < 0)
+        throw Error("invalid cache size %d", max_size);
+
+    if (max_size >= _entries.size())
+    {
+        _maxSize = max_size;
+        return;
+    }
+
+    // Entries are addressed by their position, so shrinking starts over
+    _entries.clear();
+    _index.clear();
+    _first = _last = -1;
+    _maxSize = max_size;
+}
+
+int MangoTargetCache::getMaxSize()
+{
+    OsLocker locker(_lock);
+    return _maxSize;
+}
+
+bool MangoTargetCache::get(qword key, int flags, Molecule& mol)
+{
+    OsLocker locker(_lock);
+
+    int* idx = _index.at2(key);
+    if (idx == 0 || _entries[*idx].flags != flags)
+    {
+        profIncCounter("mango_target_cache.miss", 1);
+        return false;
+    }
+
+    _unlink(*idx);
+    _linkFirst(*idx);
+
+    mol.clone_KeepIndices(_entries[*idx].mol);
+    profIncCounter("mango_target_cache.hit", 1);
+    return true;
+}
+
+void MangoTargetCache::put(qword key, int flags, Molecule& mol)
+{
+    OsLocker locker(_lock);
+
+    if (_maxSize == 0)
+        return;
+
+    int idx;
+    int* existing = _index.at2(key);
+
+    if (existing != 0)
+    {
+        idx = *existing;
+        _unlink(idx);
+    }
+    else if (_entries.size() < _maxSize)
+    {
+        idx = _entries.size();
+        _entries.push();
+        _index.insert(key, idx);
+    }
+    else
+    {
+        // Reuse the least recently used entry
+        idx = _last;
+        _unlink(idx);
+        _index.remove(_entries[idx].key);
+        _index.insert(key, idx);
+    }
+
+    Entry& entry = _entries[idx];
+    entry.key = key;
+    // Not matched by any lookup until the copy is complete
+    entry.flags = -1;
+    _linkFirst(idx);
+
+    entry.mol.clone_KeepIndices(mol);
+    entry.flags = flags;
+}
+
+void MangoTargetCache::clear()
+{
+    OsLocker locker(_lock);
+
+    _entries.clear();
+    _index.clear();
+    _first = _last = -1;
+}
+
+void MangoTargetCache::_unlink(int idx)
+{
+    Entry& entry = _entries[idx];
+
+    if (entry.prev != -1)
+        _entries[entry.prev].next = entry.next;
+    else
+        _first = entry.next;
+
+    if (entry.next != -1)
+        _entries[entry.next].prev = entry.prev;
+    else
+        _last = entry.prev;
+
+    entry.prev = entry.next = -1;
+}
+
+void MangoTargetCache::_linkFirst(int idx)
+{
+    Entry& entry = _entries[idx];
+
+    entry.prev = -1;
+    entry.next = _first;
+
+    if (_first != -1)
+        _entries[_first].prev = idx;
+    else
+        _last = idx;
+
+    _first = idx;
+}
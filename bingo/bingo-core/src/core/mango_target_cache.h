@@ -0,0 +1,74 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __mango_target_cache__
+#define __mango_target_cache__
+
+#include "base_cpp/obj_array.h"
+#include "base_cpp/os_sync_wrapper.h"
+#include "base_cpp/red_black.h"
+#include "molecule/molecule.h"
+
+using namespace indigo;
+
+// Bounded LRU cache of decoded database targets shared by all the sessions
+// of the process. Targets are identified by a key chosen by the caller, and
+// the flags describe how the target was decoded (e.g. skipped stereo), so
+// a target decoded differently is not returned.
+class MangoTargetCache
+{
+public:
+    static MangoTargetCache& getInstance();
+
+    // Zero disables the cache and drops the cached targets
+    void setMaxSize(int max_size);
+    int getMaxSize();
+
+    // Copies the cached target into mol and returns true if it is present
+    bool get(qword key, int flags, Molecule& mol);
+    void put(qword key, int flags, Molecule& mol);
+
+    void clear();
+
+    DECL_ERROR;
+
+protected:
+    MangoTargetCache();
+
+    struct Entry
+    {
+        qword key;
+        int flags;
+        int prev;
+        int next;
+        Molecule mol;
+    };
+
+    void _unlink(int idx);
+    void _linkFirst(int idx);
+
+    OsLock _lock;
+    int _maxSize;
+    // Most and least recently used entries
+    int _first;
+    int _last;
+    ObjArray<Entry> _entries;
+    RedBlackMap<qword, int> _index;
+};
+
+#endif
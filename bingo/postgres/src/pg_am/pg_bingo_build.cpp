@@ -8,6 +8,7 @@ extern "C"
 #include "fmgr.h"
 #include "postgres.h"
 #include "storage/bufmgr.h"
+#include "utils/guc.h"
 #include "utils/rel.h"
 #include "utils/relcache.h"
 
@@ -27,7 +28,7 @@ extern "C"
 
 enum
 {
-    BINGO_AM_STRATEGIES = 7,
+    BINGO_AM_STRATEGIES = 8,
     BINGO_AM_SUPPORT = 7
 };
 
@@ -39,6 +40,8 @@ extern "C"
     PG_MODULE_MAGIC;
 #endif
 
+    PGDLLEXPORT void _PG_init(void);
+
 #if PG_VERSION_NUM / 100 >= 906
     BINGO_FUNCTION_EXPORT(bingo_handler);
 
@@ -47,6 +50,9 @@ extern "C"
 #if PG_VERSION_NUM / 100 >= 1000
     CEXPORT bool bingo_insert(Relation, Datum*, bool*, ItemPointer, Relation, IndexUniqueCheck, struct IndexInfo*);
     CEXPORT void bingo_costestimate101(struct PlannerInfo*, struct IndexPath*, double, Cost*, Cost*, Selectivity*, double*, double*);
+    CEXPORT Size bingo_estimateparallelscan(void);
+    CEXPORT void bingo_initparallelscan(void*);
+    CEXPORT void bingo_parallelrescan(IndexScanDesc);
 #else
     CEXPORT bool bingo_insert(Relation, Datum*, bool*, ItemPointer, Relation, IndexUniqueCheck);
     CEXPORT void bingo_costestimate96(struct PlannerInfo*, struct IndexPath*, double, Cost*, Cost*, Selectivity*, double*);
@@ -67,6 +73,22 @@ extern "C"
 #endif
 }
 
+int bingo_target_cache_size = 0;
+int bingo_estimate_sections = 4;
+
+/*
+ * Module initialization: defines the configuration parameters
+ */
+void _PG_init(void)
+{
+    DefineCustomIntVariable("bingo.target_cache_size", "Number of decoded structures cached by a session for substructure matching.",
+                            "Zero disables the cache. Each backend keeps its own cache.", &bingo_target_cache_size, 0, 0, INT_MAX, PGC_USERSET, 0, NULL,
+                            NULL, NULL);
+    DefineCustomIntVariable("bingo.estimate_sections", "Number of index sections screened by the planner to estimate the costs of a search.",
+                            "Zero disables the screening at the planning time, and the generic costs are used.", &bingo_estimate_sections, 4, 0, INT_MAX,
+                            PGC_USERSET, 0, NULL, NULL, NULL);
+}
+
 #if PG_VERSION_NUM / 100 >= 906
 /*
  * Bingo handler function: return IndexAmRoutine with access method parameters
@@ -100,10 +122,16 @@ Datum bingo_handler(PG_FUNCTION_ARGS)
 
 #if PG_VERSION_NUM / 100 >= 1000
     amroutine->amcostestimate = bingo_costestimate101;
-    amroutine->amcanparallel = false;
-    amroutine->amestimateparallelscan = NULL;
-    amroutine->aminitparallelscan = NULL;
-    amroutine->amparallelrescan = NULL;
+    amroutine->amcanparallel = true;
+    /*
+     * Ordering by similarity. The keys are not optional: the index skips the
+     * NULL and the invalid structures, so the ordering needs a similarity
+     * condition that excludes them anyway
+     */
+    amroutine->amcanorderbyop = true;
+    amroutine->amestimateparallelscan = bingo_estimateparallelscan;
+    amroutine->aminitparallelscan = bingo_initparallelscan;
+    amroutine->amparallelrescan = bingo_parallelrescan;
 #else
     amroutine->amcostestimate = bingo_costestimate96;
 #endif
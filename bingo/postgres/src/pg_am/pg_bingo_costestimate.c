@@ -8,10 +8,19 @@
 
 #if PG_VERSION_NUM / 100 >= 902
 #include "optimizer/predtest.h"
+#include "utils/lsyscache.h"
 #include "utils/selfuncs.h"
 #include "utils/spccache.h"
 #endif
 
+#if PG_VERSION_NUM / 100 >= 1000
+#include "executor/executor.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/var.h"
+#include "utils/datum.h"
+#endif
+
 /*
 #include "access/sysattr.h"
 #include "catalog/index.h"
@@ -539,6 +548,157 @@ static void genericcostestimate92(PlannerInfo* root, IndexPath* path, double loo
 }
 #endif
 
+#if PG_VERSION_NUM / 100 >= 902
+/*
+ * The index screens every section with the query fingerprint and then
+ * matches the structures passed the screening. If the query can be screened,
+ * bingo.estimate_sections sections are screened at the planning time (see
+ * pg_bingo_search.cpp) and the selectivity and the costs are taken from that.
+ * Otherwise the generic costs are kept.
+ */
+extern int bingo_estimate_screening(Oid index_oid, double index_pages, int strategy, Datum query, double* fraction, double* structures, int* sections,
+                                    int* query_bits);
+
+/*
+ * Cost of matching one structure in cpu_operator_cost units
+ */
+#define BINGO_MATCH_COST_FACTOR 400.0
+
+/*
+ * Strategy of the similarity condition (BingoPgCommon::MOL_SIM)
+ */
+#define BINGO_MOL_SIM_STRATEGY 7
+
+#if PG_VERSION_NUM / 100 >= 1000
+static bool bingo_contains_param_walker(Node* node, void* context)
+{
+    if (node == NULL)
+        return false;
+    if (IsA(node, Param) || IsA(node, SubLink) || IsA(node, SubPlan))
+        return true;
+    return expression_tree_walker(node, bingo_contains_param_walker, context);
+}
+#endif
+
+/*
+ * Returns the query value if it does not depend on the other relations or
+ * parameters. The query is usually a row constructor, which is not folded
+ * to a constant by the planner, so it is evaluated here.
+ */
+static bool bingo_get_query_value(Node* node, Datum* value)
+{
+    if (IsA(node, Const))
+    {
+        Const* query_const = (Const*)node;
+        if (query_const->constisnull)
+            return false;
+        *value = query_const->constvalue;
+        return true;
+    }
+#if PG_VERSION_NUM / 100 >= 1000
+    if (contain_var_clause(node) || contain_volatile_functions(node) || bingo_contains_param_walker(node, NULL))
+        return false;
+    {
+        EState* estate;
+        ExprState* expr_state;
+        MemoryContext old_context;
+        Datum result;
+        bool isnull;
+        int16 typlen;
+        bool typbyval;
+
+        estate = CreateExecutorState();
+        old_context = MemoryContextSwitchTo(estate->es_query_cxt);
+        expr_state = ExecInitExpr((Expr*)node, NULL);
+        MemoryContextSwitchTo(old_context);
+
+        result = ExecEvalExprSwitchContext(expr_state, GetPerTupleExprContext(estate), &isnull);
+        if (!isnull)
+        {
+            /*
+             * Copy the value out of the executor memory
+             */
+            get_typlenbyval(exprType(node), &typlen, &typbyval);
+            *value = datumCopy(result, typbyval, typlen);
+        }
+        FreeExecutorState(estate);
+        return !isnull;
+    }
+#else
+    return false;
+#endif
+}
+
+static bool bingo_is_sim_condition(IndexPath* path)
+{
+    RestrictInfo* rinfo;
+
+    if (list_length(path->indexquals) != 1)
+        return false;
+    rinfo = (RestrictInfo*)linitial(path->indexquals);
+    if (!IsA(rinfo->clause, OpExpr))
+        return false;
+    return get_op_opfamily_strategy(((OpExpr*)rinfo->clause)->opno, path->indexinfo->opfamily[0]) == BINGO_MOL_SIM_STRATEGY;
+}
+
+static void bingo_screening_costestimate(PlannerInfo* root, IndexPath* path, Cost* indexStartupCost, Cost* indexTotalCost, Selectivity* indexSelectivity)
+{
+    IndexOptInfo* index = path->indexinfo;
+    RestrictInfo* rinfo;
+    OpExpr* clause;
+    Datum query;
+    int strategy;
+    double fraction, structures, candidates, candidate_pages;
+    int sections, query_bits;
+    double spc_random_page_cost, spc_seq_page_cost;
+
+    if (path->indexquals == NIL)
+        return;
+    /*
+     * The search is defined by the first scan key
+     */
+    rinfo = (RestrictInfo*)linitial(path->indexquals);
+    if (!IsA(rinfo->clause, OpExpr) || list_length(((OpExpr*)rinfo->clause)->args) != 2)
+        return;
+    clause = (OpExpr*)rinfo->clause;
+
+    strategy = get_op_opfamily_strategy(clause->opno, index->opfamily[0]);
+    if (strategy == 0)
+        return;
+    if (!bingo_get_query_value((Node*)lsecond(clause->args), &query))
+        return;
+    if (!bingo_estimate_screening(index->indexoid, (double)index->pages, strategy, query, &fraction, &structures, &sections, &query_bits))
+        return;
+
+    /*
+     * The screening passes a superset of the matches
+     */
+    candidates = fraction * structures;
+    if (candidates < 1.0)
+        candidates = 1.0;
+    if (structures >= 1.0)
+        *indexSelectivity = candidates / structures;
+    if (*indexSelectivity > 1.0)
+        *indexSelectivity = 1.0;
+
+    get_tablespace_page_costs(index->reltablespace, &spc_random_page_cost, &spc_seq_page_cost);
+
+    /*
+     * Every section reads its bitset and a fingerprint block per query bit,
+     * and every candidate reads its compressed structure to match it
+     */
+    candidate_pages = candidates;
+    if (candidate_pages > index->pages)
+        candidate_pages = index->pages;
+
+    *indexStartupCost += (query_bits + 1) * spc_seq_page_cost;
+    *indexTotalCost = *indexStartupCost;
+    *indexTotalCost += (double)sections * (query_bits + 1) * spc_seq_page_cost;
+    *indexTotalCost += candidate_pages * spc_random_page_cost;
+    *indexTotalCost += candidates * BINGO_MATCH_COST_FACTOR * cpu_operator_cost;
+}
+#endif
+
 #if PG_VERSION_NUM / 100 >= 904
 PGDLLEXPORT PG_FUNCTION_INFO_V1(bingo_costestimate);
 #else
@@ -559,6 +719,7 @@ Datum bingo_costestimate(PG_FUNCTION_ARGS)
     double* indexCorrelation = (double*)PG_GETARG_POINTER(6);
 
     genericcostestimate92(root, path, loop_count, 1.0, indexStartupCost, indexTotalCost, indexSelectivity, indexCorrelation);
+    bingo_screening_costestimate(root, path, indexStartupCost, indexTotalCost, indexSelectivity);
 #else
 
     struct PlannerInfo* root;
@@ -629,6 +790,7 @@ void bingo_costestimate96(struct PlannerInfo* root, struct IndexPath* path, doub
                           Selectivity* indexSelectivity, double* indexCorrelation)
 {
     genericcostestimate92(root, path, loop_count, 1.0, indexStartupCost, indexTotalCost, indexSelectivity, indexCorrelation);
+    bingo_screening_costestimate(root, path, indexStartupCost, indexTotalCost, indexSelectivity);
 }
 
 void bingo_costestimate101(struct PlannerInfo* root, struct IndexPath* path, double loop_count, Cost* indexStartupCost, Cost* indexTotalCost,
@@ -636,8 +798,22 @@ void bingo_costestimate101(struct PlannerInfo* root, struct IndexPath* path, dou
 {
 
     genericcostestimate92(root, path, loop_count, 1.0, indexStartupCost, indexTotalCost, indexSelectivity, indexCorrelation);
+    bingo_screening_costestimate(root, path, indexStartupCost, indexTotalCost, indexSelectivity);
 
-    *indexPages = 1;
+    /*
+     * Similarity ordering needs exactly one similarity condition
+     */
+    if (path->indexorderbys != NIL && !bingo_is_sim_condition(path))
+    {
+        *indexStartupCost += disable_cost;
+        *indexTotalCost += disable_cost;
+    }
+
+    /*
+     * The planner takes the number of parallel workers from the index pages,
+     * and the whole index is scanned for any query
+     */
+    *indexPages = path->indexinfo->pages;
 }
 /*
 Datum
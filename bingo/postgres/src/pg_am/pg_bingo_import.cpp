@@ -443,7 +443,13 @@ public:
     {
         _parseColumns = true;
         setFunctionName("importSDF");
-        bingo_res = bingoSDFImportOpen(fname);
+        /*
+         * Records are parsed in parallel with the NTHREADS config value.
+         * Molfiles are not checked here, invalid ones are handled by the index
+         */
+        int nthreads = -1;
+        bingoGetConfigInt("nthreads", &nthreads);
+        bingo_res = bingoSDFImportOpenParallel(fname, nthreads, 0);
         CORE_HANDLE_ERROR(bingo_res, 1, "importSDF", bingoGetError());
     }
     virtual ~BingoImportSdfHandler()
@@ -2,17 +2,20 @@
 
 extern "C"
 {
+#include "access/genam.h"
 #include "access/relscan.h"
 #include "access/skey.h"
 #include "fmgr.h"
 #include "miscadmin.h"
 #include "postgres.h"
+#include "storage/lock.h"
 #include "utils/rel.h"
 #include "utils/relcache.h"
 }
 
 #include "bingo_pg_fix_post.h"
 
+#include "base_cpp/array.h"
 #include "base_cpp/tlscont.h"
 #include "bingo_pg_common.h"
 #include "bingo_pg_search.h"
@@ -124,6 +127,12 @@ Datum bingo_rescan(PG_FUNCTION_ARGS)
         {
             memmove(scan->keyData, scankey, scan->numberOfKeys * sizeof(ScanKeyData));
         }
+#if PG_VERSION_NUM / 100 >= 1000
+        if (orderbys && scan->numberOfOrderBys > 0)
+        {
+            memmove(scan->orderByData, orderbys, scan->numberOfOrderBys * sizeof(ScanKeyData));
+        }
+#endif
 
         so = (BingoPgSearch*)scan->opaque;
         if (so != NULL)
@@ -230,6 +239,18 @@ Datum bingo_gettuple(PG_FUNCTION_ARGS)
          * Fetch to the next item
          */
         result = search_engine->next(scan, &scan->xs_ctup.t_self);
+#if PG_VERSION_NUM / 100 >= 1000
+        /*
+         * Ordered scan returns the exact distance of every structure
+         */
+        float distance = 0;
+        if (result && scan->numberOfOrderBys > 0 && search_engine->getOrderDistance(distance))
+        {
+            scan->xs_orderbyvals[0] = Float4GetDatum(distance);
+            scan->xs_orderbynulls[0] = false;
+            scan->xs_recheckorderby = false;
+        }
+#endif
     }
     PG_BINGO_HANDLE(delete search_engine; scan->opaque = NULL);
     /*
@@ -241,3 +262,105 @@ Datum bingo_gettuple(PG_FUNCTION_ARGS)
     PG_RETURN_BOOL(result);
 #endif
 }
+
+/*
+ * Estimates the fingerprint screening of a query for the planner. The last
+ * estimation is kept for the same index size, since the planner asks for
+ * every possible path. Returns 0 if the query can not be estimated this way.
+ *
+ * The estimation screens bingo.estimate_sections sections spread over the
+ * index, reading their bitsets and a fingerprint block per query bit, so
+ * planning a query costs about as much as scanning that many sections.
+ * Zero sections disables the estimation.
+ */
+CEXPORT int bingo_estimate_screening(Oid index_oid, double index_pages, int strategy, Datum query, double* fraction, double* structures, int* sections,
+                                     int* query_bits)
+{
+    static Oid last_index = InvalidOid;
+    static double last_index_pages = 0;
+    static int last_strategy = 0;
+    static int last_result = 0;
+    static double last_fraction = 0, last_structures = 0;
+    static int last_query_bits = 0;
+    static int last_sections = 0;
+    static int last_estimate_sections = 0;
+    static indigo::Array<char> last_query;
+
+    if (bingo_estimate_sections <= 0)
+        return 0;
+
+    struct varlena* query_data = PG_DETOAST_DATUM_PACKED(query);
+    const char* query_buf = VARDATA_ANY(query_data);
+    int query_len = VARSIZE_ANY_EXHDR(query_data);
+
+    if (index_oid != last_index || index_pages != last_index_pages || strategy != last_strategy || bingo_estimate_sections != last_estimate_sections ||
+        query_len != last_query.size() || memcmp(query_buf, last_query.ptr(), query_len) != 0)
+    {
+        last_result = 0;
+        Relation index = index_open(index_oid, AccessShareLock);
+        IndexScanDesc scan = RelationGetIndexScan(index, 1, 0);
+        memset(scan->keyData, 0, sizeof(ScanKeyData));
+        scan->keyData[0].sk_attno = 1;
+        scan->keyData[0].sk_strategy = strategy;
+        scan->keyData[0].sk_argument = query;
+
+        BingoPgSearch* so = 0;
+        try
+        {
+            BingoPgWrapper rel_namespace;
+            BingoPgCommon::appendPath(rel_namespace.getRelNameSpace(index->rd_id));
+
+            so = new BingoPgSearch(index);
+            last_result = so->estimateScreening(scan, bingo_estimate_sections, last_fraction, last_structures, last_query_bits) ? 1 : 0;
+            last_sections = so->getIndex().getSectionNumber();
+        }
+        catch (indigo::Exception& e)
+        {
+            /*
+             * The query errors are reported by the scan itself
+             */
+            elog(DEBUG1, "bingo: estimate: can not estimate the query: %s", e.message());
+        }
+        catch (...)
+        {
+            elog(DEBUG1, "bingo: estimate: can not estimate the query");
+        }
+        delete so;
+
+        IndexScanEnd(scan);
+        index_close(index, AccessShareLock);
+
+        last_index = index_oid;
+        last_index_pages = index_pages;
+        last_strategy = strategy;
+        last_estimate_sections = bingo_estimate_sections;
+        last_query.copy(query_buf, query_len);
+    }
+
+    *fraction = last_fraction;
+    *structures = last_structures;
+    *sections = last_sections;
+    *query_bits = last_query_bits;
+    return last_result;
+}
+
+#if PG_VERSION_NUM / 100 >= 1000
+/*
+ * Parallel scan support: the processes share the next section to screen
+ */
+CEXPORT Size bingo_estimateparallelscan(void)
+{
+    return BingoPgSearchEngine::getParallelScanSize();
+}
+
+CEXPORT void bingo_initparallelscan(void* target)
+{
+    BingoPgSearchEngine::initParallelScan(target);
+}
+
+CEXPORT void bingo_parallelrescan(IndexScanDesc scan)
+{
+    ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+    BingoPgSearchEngine::resetParallelScan(OffsetToPointer((void*)parallel_scan, parallel_scan->ps_offset));
+}
+#endif
@@ -273,6 +273,31 @@ void BingoPgBufferCacheFp::andWithBitset(BingoPgExternalBitset& ext_bitset)
     }
 }
 
+void BingoPgBufferCacheFp::addToCounters(BingoPgVerticalCounter& ones, BingoPgVerticalCounter& misses, const BingoPgExternalBitset& mask)
+{
+    if (_write)
+    {
+        ones.add(_cache.getWords(), _cache.wordsInUse(), mask.getWords(), false);
+        misses.add(_cache.getWords(), _cache.wordsInUse(), mask.getWords(), true);
+    }
+    else
+    {
+        /*
+         * Read data for a buffer
+         */
+        _buffer.readBuffer(_index, _blockId, BINGO_PG_READ);
+        int data_len;
+        void* data = _buffer.getIndexData(data_len);
+        _cache.deserialize(data, data_len, true);
+        /*
+         * Count the bits and the misses from the same read
+         */
+        ones.add(_cache.getWords(), _cache.wordsInUse(), mask.getWords(), false);
+        misses.add(_cache.getWords(), _cache.wordsInUse(), mask.getWords(), true);
+        _buffer.changeAccess(BINGO_PG_NOLOCK);
+    }
+}
+
 void BingoPgBufferCacheFp::getCopy(BingoPgExternalBitset& other)
 {
     if (_write)
@@ -14,6 +14,7 @@ extern "C"
 #include "base_cpp/exception.h"
 #include "bingo_pg_buffer.h"
 #include "bingo_pg_ext_bitset.h"
+#include "bingo_pg_vertical_counter.h"
 #include "bingo_postgres.h"
 /*
  * Class for data buffers handling
@@ -100,6 +101,10 @@ public:
      * Main bit processing
      */
     void andWithBitset(BingoPgExternalBitset& ext_bitset);
+    /*
+     * Adds the bits and the missing bits to the counters of the structures in the mask
+     */
+    void addToCounters(BingoPgVerticalCounter& ones, BingoPgVerticalCounter& misses, const BingoPgExternalBitset& mask);
 
     void getCopy(BingoPgExternalBitset& other);
 
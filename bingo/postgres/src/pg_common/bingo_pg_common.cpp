@@ -52,6 +52,7 @@ void BingoPgCommon::getSearchTypeString(int type, indigo::Array<char>& result, b
             result.readString("SUB", true);
             break;
         case (MOL_SIM):
+        case (MOL_SIM_ORDER):
             result.readString("SIM", true);
             break;
         case (MOL_SMARTS):
@@ -109,6 +109,25 @@ public:
 
     qword shiftOne(int shiftNumber);
 
+    // Word access for word-parallel processing. The words starting from
+    // wordsInUse() are zero; call updateWordsInUse() after changing words.
+    qword* getWords()
+    {
+        return _words;
+    }
+    const qword* getWords() const
+    {
+        return _words;
+    }
+    int wordsInUse() const
+    {
+        return (int)*_lastWordPtr;
+    }
+    void updateWordsInUse()
+    {
+        _recalculateWordsInUse();
+    }
+
 private:
     BingoPgExternalBitset(const BingoPgExternalBitset&); // no implicit copy
 
@@ -42,6 +42,16 @@ BingoPgSection::BingoPgSection(BingoPgIndex& bingo_idx, int idx_strategy, int of
         _sectionInfoBuffer.changeAccess(BINGO_PG_NOLOCK);
         _sectionInfo.n_blocks_for_map = bingo_idx.getMapSize();
         _sectionInfo.n_blocks_for_fp = bingo_idx.getFpSize();
+        /*
+         * Initialize the summary if it fits into the meta page
+         */
+        int fp_bytes = (_sectionInfo.n_blocks_for_fp + 7) / 8;
+        if (sizeof(BingoSectionInfoData) + sizeof(BingoSectionSummaryData) + fp_bytes <= SECTION_SUMMARY_MAX_SIZE)
+        {
+            _hasSummary = true;
+            _orFingerprint.resize(fp_bytes);
+            _orFingerprint.zerofill();
+        }
         /*
          * Initialize existing structures fingerprint
          */
@@ -67,6 +77,7 @@ BingoPgSection::BingoPgSection(BingoPgIndex& bingo_idx, int idx_strategy, int of
         int data_len;
         BingoSectionInfoData* data = (BingoSectionInfoData*)_sectionInfoBuffer.getIndexData(data_len);
         _sectionInfo = *data;
+        _readSummary((const char*)data, data_len);
         _sectionInfoBuffer.changeAccess(BINGO_PG_NOLOCK);
 
         _existStructures.reset(new BingoPgBufferCacheFp(offset + 1, _index, false));
@@ -131,16 +142,25 @@ BingoPgSection::~BingoPgSection()
     _sectionInfo.section_size = getPagesCount();
     if (_idxStrategy == BingoPgIndex::BUILDING_STRATEGY)
     {
+        QS_DEF(Array<char>, info_buf);
+        info_buf.copy((const char*)&_sectionInfo, sizeof(_sectionInfo));
+        _writeSummary(info_buf);
         _sectionInfoBuffer.changeAccess(BINGO_PG_WRITE);
-        _sectionInfoBuffer.formIndexTuple(&_sectionInfo, sizeof(_sectionInfo));
+        _sectionInfoBuffer.formIndexTuple(info_buf.ptr(), info_buf.sizeInBytes());
         _sectionInfoBuffer.changeAccess(BINGO_PG_NOLOCK);
     }
     else if (_idxStrategy == BingoPgIndex::UPDATING_STRATEGY)
     {
+        QS_DEF(Array<char>, info_buf);
+        info_buf.copy((const char*)&_sectionInfo, sizeof(_sectionInfo));
+        _writeSummary(info_buf);
         _sectionInfoBuffer.changeAccess(BINGO_PG_WRITE);
         int data_len;
-        BingoSectionInfoData* data = (BingoSectionInfoData*)_sectionInfoBuffer.getIndexData(data_len);
-        *data = _sectionInfo;
+        char* data = (char*)_sectionInfoBuffer.getIndexData(data_len);
+        /*
+         * The summary size is checked while reading
+         */
+        memcpy(data, info_buf.ptr(), info_buf.sizeInBytes());
         _sectionInfoBuffer.changeAccess(BINGO_PG_NOLOCK);
     }
 }
@@ -155,6 +175,10 @@ void BingoPgSection::clear()
     _sectionInfo.last_cmf = -1;
     _sectionInfo.last_xyz = -1;
     _sectionInfo.has_removed = 0;
+    _hasSummary = false;
+    _summary.min_bits_count = 0;
+    _summary.max_bits_count = 0;
+    _orFingerprint.clear();
     _sectionInfoBuffer.clear();
     _existStructures.reset(0);
     _buffersMap.clear();
@@ -182,6 +206,8 @@ void BingoPgSection::addStructure(BingoPgFpData& item_data)
         int bit_idx = item_data.getBit(idx);
         BingoPgBufferCacheFp& buffer_fp = getFpBufferCache(bit_idx);
         buffer_fp.setBit(current_str, true);
+        if (_hasSummary)
+            _orFingerprint[bit_idx >> 3] |= (byte)(1 << (bit_idx & 7));
     }
 
     int map_buf_idx = current_str / BINGO_MOLS_PER_MAPBLOCK;
@@ -206,6 +232,17 @@ void BingoPgSection::addStructure(BingoPgFpData& item_data)
      * Set bits number
      */
     _setBitsCountData(item_data.getBitsCount());
+    /*
+     * Update bits count range
+     */
+    if (_hasSummary)
+    {
+        int bits_count = item_data.getBitsCount();
+        if (current_str == 0 || bits_count < _summary.min_bits_count)
+            _summary.min_bits_count = bits_count;
+        if (current_str == 0 || bits_count > _summary.max_bits_count)
+            _summary.max_bits_count = bits_count;
+    }
     /*
      * Set structure index
      */
@@ -405,6 +442,30 @@ void BingoPgSection::_setBitsCountData(unsigned short bits_count)
     bits_buffer.changeAccess(BINGO_PG_NOLOCK);
 }
 
+void BingoPgSection::_readSummary(const char* data, int data_len)
+{
+    int fp_bytes = (_sectionInfo.n_blocks_for_fp + 7) / 8;
+    int summary_len = sizeof(BingoSectionInfoData) + sizeof(BingoSectionSummaryData) + fp_bytes;
+    /*
+     * The older sections have the section info only
+     */
+    if (data_len < summary_len)
+        return;
+
+    const char* summary_data = data + sizeof(BingoSectionInfoData);
+    memcpy(&_summary, summary_data, sizeof(_summary));
+    _orFingerprint.copy((const byte*)summary_data + sizeof(_summary), fp_bytes);
+    _hasSummary = true;
+}
+
+void BingoPgSection::_writeSummary(indigo::Array<char>& buf)
+{
+    if (!_hasSummary)
+        return;
+    buf.concat((const char*)&_summary, sizeof(_summary));
+    buf.concat((const char*)_orFingerprint.ptr(), _orFingerprint.size());
+}
+
 BingoPgBufferCacheBin* BingoPgSection::_getBufferBin(int idx)
 {
     BingoPgBufferCacheBin* elem = _buffersBin.at(idx);
@@ -17,7 +17,7 @@ class BingoPgExternalBitset;
 /*
  * Class for handling bingo postgres section
  * Section consists of:
- *    section meta info (1 block) |
+ *    section meta info and summary (1 block) |
  *    section removed bitset (1 block) |
  *    bits count buffers (16 blocks) |
  *    map buffers (64k / 500) |
@@ -31,7 +31,8 @@ public:
     {
         SECTION_META_PAGES = 2,
         SECTION_BITSNUMBER_PAGES = 16,
-        SECTION_BITS_PER_BLOCK = 4000 /* 4000 * sizeof(unsigned short) < 8K*/
+        SECTION_BITS_PER_BLOCK = 4000, /* 4000 * sizeof(unsigned short) < 8K*/
+        SECTION_SUMMARY_MAX_SIZE = 4000
     };
     BingoPgSection(BingoPgIndex& bingo_idx, int idx_strategy, int offset);
     ~BingoPgSection();
@@ -71,6 +72,23 @@ public:
         return _sectionInfo;
     };
 
+    /*
+     * Summary of the section structures for skipping the whole section:
+     * the range of the bits count and the OR of the fingerprints
+     */
+    bool hasSummary() const
+    {
+        return _hasSummary;
+    }
+    const BingoSectionSummaryData& getSummary() const
+    {
+        return _summary;
+    }
+    const indigo::Array<byte>& getOrFingerprint() const
+    {
+        return _orFingerprint;
+    }
+
     DECL_ERROR;
 
 private:
@@ -80,6 +98,8 @@ private:
     void _setXyzData(indigo::Array<char>& xyz_buf, int map_buf_idx, int map_idx);
     void _setBinData(indigo::Array<char>& buf, int& last_buf, ItemPointerData& item_data);
     void _setBitsCountData(unsigned short bits_count);
+    void _readSummary(const char* data, int data_len);
+    void _writeSummary(indigo::Array<char>& buf);
 
     BingoPgBufferCacheBin* _getBufferBin(int idx);
 
@@ -88,6 +108,9 @@ private:
     int _idxStrategy;
 
     BingoSectionInfoData _sectionInfo;
+    bool _hasSummary;
+    BingoSectionSummaryData _summary;
+    indigo::Array<byte> _orFingerprint;
     BingoPgBuffer _sectionInfoBuffer;
     indigo::AutoPtr<BingoPgBufferCacheFp> _existStructures;
 
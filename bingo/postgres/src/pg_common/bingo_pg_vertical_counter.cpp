@@ -0,0 +1,103 @@
+#include "bingo_pg_fix_pre.h"
+
+#include "bingo_pg_fix_post.h"
+
+#include "bingo_pg_vertical_counter.h"
+
+BingoPgVerticalCounter::BingoPgVerticalCounter() : _wordsNumber(0), _planesNumber(0)
+{
+}
+
+void BingoPgVerticalCounter::init(int nbits, int max_value)
+{
+    _wordsNumber = (nbits + 63) >> 6;
+    _planesNumber = 1;
+    while (_planesNumber < 31 && (max_value >> _planesNumber) != 0)
+        ++_planesNumber;
+
+    _planes.clear_resize(_wordsNumber * _planesNumber);
+    _planes.zerofill();
+}
+
+void BingoPgVerticalCounter::assign(const int* values, int count)
+{
+    int max_value = (1 << _planesNumber) - 1;
+    _planes.zerofill();
+
+    for (int i = 0; i < count && i < _wordsNumber * 64; ++i)
+    {
+        int value = values[i];
+        if (value <= 0)
+            continue;
+        if (value > max_value)
+            value = max_value;
+
+        qword bit = 1ULL << (i & 63);
+        int word_idx = i >> 6;
+        for (int p = 0; value != 0; ++p, value >>= 1)
+        {
+            if (value & 1)
+                _plane(p)[word_idx] |= bit;
+        }
+    }
+}
+
+void BingoPgVerticalCounter::add(const qword* words, int words_in_use, const qword* mask, bool complement)
+{
+    for (int w = 0; w < _wordsNumber; ++w)
+    {
+        if (mask[w] == 0)
+            continue;
+        qword word = (w < words_in_use) ? words[w] : 0;
+        /*
+         * Ripple the carry through the planes; it usually dies out after one
+         * or two of them
+         */
+        qword carry = (complement ? ~word : word) & mask[w];
+        for (int p = 0; p < _planesNumber && carry != 0; ++p)
+        {
+            qword& plane = _plane(p)[w];
+            qword next = plane & carry;
+            plane ^= carry;
+            carry = next;
+        }
+    }
+}
+
+int BingoPgVerticalCounter::get(int idx) const
+{
+    qword bit = 1ULL << (idx & 63);
+    int word_idx = idx >> 6;
+    int value = 0;
+    for (int p = _planesNumber - 1; p >= 0; --p)
+    {
+        value <<= 1;
+        if (_plane(p)[word_idx] & bit)
+            value |= 1;
+    }
+    return value;
+}
+
+void BingoPgVerticalCounter::clearGreater(const BingoPgVerticalCounter& limits, qword* mask) const
+{
+    for (int w = 0; w < _wordsNumber; ++w)
+    {
+        if (mask[w] == 0)
+            continue;
+        /*
+         * Compare from the most significant plane: a counter is greater at the
+         * first plane where it has 1 and the limit has 0, with all the higher
+         * planes equal
+         */
+        qword greater = 0;
+        qword equal = ~(qword)0;
+        for (int p = _planesNumber - 1; p >= 0 && equal != 0; --p)
+        {
+            qword value = _plane(p)[w];
+            qword limit = limits._plane(p)[w];
+            greater |= equal & value & ~limit;
+            equal &= ~(value ^ limit);
+        }
+        mask[w] &= ~greater;
+    }
+}
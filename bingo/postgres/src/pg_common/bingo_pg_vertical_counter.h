@@ -0,0 +1,69 @@
+#ifndef _BINGO_PG_VERTICAL_COUNTER_H__
+#define _BINGO_PG_VERTICAL_COUNTER_H__
+
+#include "base_c/defs.h"
+#include "base_cpp/array.h"
+
+/*
+ * Bit-sliced (vertical) counters for all the structures of a section.
+ * Plane p keeps bit p of every counter, so the counter of structure i is
+ * spread over bit i of the planes. Adding a bitset to all the counters then
+ * takes a few word-wide AND/XOR operations per 64 structures instead of a
+ * loop over the set bits, and comparing with per-structure limits is done
+ * the same way.
+ */
+class BingoPgVerticalCounter
+{
+public:
+    BingoPgVerticalCounter();
+    ~BingoPgVerticalCounter()
+    {
+    }
+
+    /*
+     * Prepares zero counters for nbits structures, large enough to hold max_value
+     */
+    void init(int nbits, int max_value);
+    /*
+     * Sets the counters to the given values, clamped to the counter range
+     */
+    void assign(const int* values, int count);
+    /*
+     * Adds one to the counters of the structures that are set in mask and set
+     * (or not set if complement is true) in words. words_in_use is the number
+     * of meaningful words, the others are zero.
+     */
+    void add(const qword* words, int words_in_use, const qword* mask, bool complement);
+    /*
+     * Clears the mask bits of the structures whose counter is greater than
+     * the counter in limits. Both counters should be initialized alike.
+     */
+    void clearGreater(const BingoPgVerticalCounter& limits, qword* mask) const;
+    /*
+     * Returns the counter of a structure
+     */
+    int get(int idx) const;
+
+    int getWordsNumber() const
+    {
+        return _wordsNumber;
+    }
+
+private:
+    BingoPgVerticalCounter(const BingoPgVerticalCounter&); // no implicit copy
+
+    inline qword* _plane(int p)
+    {
+        return _planes.ptr() + p * _wordsNumber;
+    }
+    inline const qword* _plane(int p) const
+    {
+        return _planes.ptr() + p * _wordsNumber;
+    }
+
+    int _wordsNumber;
+    int _planesNumber;
+    indigo::Array<qword> _planes;
+};
+
+#endif /* _BINGO_PG_VERTICAL_COUNTER_H__ */
@@ -86,4 +86,27 @@ typedef struct BingoSectionInfoData
     char has_removed;
 } BingoSectionInfoData;
 
+/*
+ * Section summary is stored after the section info. It is followed by the OR
+ * of all the section fingerprints (n_blocks_for_fp bits). The sections built
+ * by the older versions have no summary.
+ */
+typedef struct BingoSectionSummaryData
+{
+    int min_bits_count;
+    int max_bits_count;
+} BingoSectionSummaryData;
+
+/*
+ * Number of decoded targets cached by a backend for substructure matching,
+ * set by bingo.target_cache_size
+ */
+extern int bingo_target_cache_size;
+
+/*
+ * Number of index sections screened for a planner estimation, set by
+ * bingo.estimate_sections
+ */
+extern int bingo_estimate_sections;
+
 #endif /* BINGO_PG_CONTEXT_H */
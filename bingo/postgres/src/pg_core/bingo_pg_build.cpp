@@ -191,6 +191,7 @@ bool BingoPgBuild::insertStructureSingle(PG_OBJECT item_ptr, uintptr_t text_ptr)
 
     _bufferIndex.insertStructure(data_ref);
     fp_engine->insertShadowInfo(data_ref);
+    fp_engine->flushShadowInfo();
 
     elog(DEBUG1, "bingo: insert structure: finish processing the table entry with ctid='(%d,%d)'::tid", block_number, offset_number);
 
@@ -219,23 +220,25 @@ void BingoPgBuild::flush()
     if (_parrallelCache.size() == 0)
         return;
     /*
-     * Process cache structures
+     * Process cache structures. The processed ones are written to the index
+     * in this thread while the threads are processing the others
      */
-    fp_engine->processStructures(_parrallelCache);
-
-    for (int c_idx = 0; c_idx < _parrallelCache.size(); ++c_idx)
-    {
-        profTimerStart(t1, "bingo_pg.insert_idx");
-        BingoPgBuildEngine::StructCache& struct_cache = _parrallelCache[c_idx];
-        if (struct_cache.data.get() == 0)
-        {
-            continue;
-        }
-
-        BingoPgFpData& data_ref = struct_cache.data.ref();
-        _bufferIndex.insertStructure(data_ref);
-        fp_engine->insertShadowInfo(data_ref);
-    }
+    fp_engine->processStructures(_parrallelCache, _insertProcessedCb, this);
+    fp_engine->flushShadowInfo();
 
     _parrallelCache.clear();
 }
+
+void BingoPgBuild::_insertProcessedCb(BingoPgBuildEngine::StructCache& struct_cache, void* context)
+{
+    profTimerStart(t1, "bingo_pg.insert_idx");
+    BingoPgBuild* self = (BingoPgBuild*)context;
+
+    BingoPgFpData& data_ref = struct_cache.data.ref();
+    self->_bufferIndex.insertStructure(data_ref);
+    self->fp_engine->insertShadowInfo(data_ref);
+    /*
+     * Release the data while the rest of the cache is processed
+     */
+    struct_cache.data.free();
+}
@@ -21,9 +21,13 @@ class BingoPgConfig;
 class BingoPgBuild
 {
 public:
+    /*
+     * The processing threads are started for every flush, so the cache should
+     * keep enough commands for all of them
+     */
     enum
     {
-        MAX_CACHE_SIZE = 1000
+        MAX_CACHE_SIZE = 10000
     };
     BingoPgBuild(PG_OBJECT index, const char* schema_name, const char* index_schema, bool new_index);
     ~BingoPgBuild();
@@ -47,6 +51,8 @@ private:
     void _prepareBuilding(const char* schema_name, const char* index_schema);
     void _prepareUpdating();
 
+    static void _insertProcessedCb(BingoPgBuildEngine::StructCache& struct_cache, void* context);
+
     /*
      * Index relation
      */
@@ -18,7 +18,7 @@ extern "C"
 
 using namespace indigo;
 
-BingoPgBuildEngine::BingoPgBuildEngine() : _bufferIndexPtr(0)
+BingoPgBuildEngine::BingoPgBuildEngine() : _bufferIndexPtr(0), _processedCb(0), _processedContext(0)
 {
     _bingoSession = bingoAllocateSessionID();
 }
@@ -92,6 +92,12 @@ int BingoPgBuildEngine::_getNextRecordCb(void* context)
     return 1;
 }
 
+void BingoPgBuildEngine::_structureProcessed(StructCache& struct_cache)
+{
+    if (_processedCb != 0)
+        _processedCb(struct_cache, _processedContext);
+}
+
 void BingoPgBuildEngine::_processErrorCb(int id, void* context)
 {
     BingoPgBuildEngine* engine = (BingoPgBuildEngine*)context;
@@ -47,6 +47,12 @@ public:
         StructCache(const StructCache&); // no implicit copy
     };
 
+    /*
+     * Called in the calling thread for every processed structure, while the
+     * other structures are still processed by the threads
+     */
+    typedef void (*ProcessedCb)(StructCache& struct_cache, void* context);
+
     BingoPgBuildEngine();
     virtual ~BingoPgBuildEngine();
 
@@ -54,7 +60,7 @@ public:
     {
         return true;
     }
-    virtual void processStructures(indigo::ObjArray<StructCache>& struct_caches)
+    virtual void processStructures(indigo::ObjArray<StructCache>& struct_caches, ProcessedCb processed_cb, void* context)
     {
     }
 
@@ -70,9 +76,15 @@ public:
     virtual void prepareShadowInfo(const char* schema_name, const char* index_schema)
     {
     }
+    /*
+     * Shadow info is collected and inserted by several rows at once
+     */
     virtual void insertShadowInfo(BingoPgFpData&)
     {
     }
+    virtual void flushShadowInfo()
+    {
+    }
     virtual void finishShadowProcessing()
     {
     }
@@ -89,6 +101,7 @@ protected:
 
     static int _getNextRecordCb(void* context);
     static void _processErrorCb(int id, void* context);
+    void _structureProcessed(StructCache& struct_cache);
 
     qword _bingoSession;
     BingoPgIndex* _bufferIndexPtr;
@@ -96,6 +109,8 @@ protected:
     indigo::ObjArray<StructCache>* _structCaches;
     int _currentCache;
     int _fpSize;
+    ProcessedCb _processedCb;
+    void* _processedContext;
     indigo::Nullable<int> nThreads;
 };
 
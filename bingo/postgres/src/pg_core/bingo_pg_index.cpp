@@ -5,6 +5,7 @@ extern "C"
 #include "fmgr.h"
 #include "postgres.h"
 #include "storage/bufmgr.h"
+#include "utils/rel.h"
 }
 
 #include "bingo_pg_fix_post.h"
@@ -486,18 +487,41 @@ void BingoPgIndex::andWithBitset(int section_idx, int fp_idx, BingoPgExternalBit
     fp_buffer.andWithBitset(ext_bitset);
 }
 
+void BingoPgIndex::addToCounters(int section_idx, int fp_idx, BingoPgVerticalCounter& ones, BingoPgVerticalCounter& misses, const BingoPgExternalBitset& mask)
+{
+    profTimerStart(t0, "bingo_pg.read_fp_count");
+    BingoPgSection& current_section = _jumpToSection(section_idx);
+    BingoPgBufferCacheFp& fp_buffer = current_section.getFpBufferCache(fp_idx);
+    fp_buffer.addToCounters(ones, misses, mask);
+}
+
 int BingoPgIndex::getSectionStructuresNumber(int section_idx)
 {
     BingoPgSection& current_section = _jumpToSection(section_idx);
     return current_section.getStructuresNumber();
 }
 
+dword BingoPgIndex::getRelFileNode() const
+{
+    return ((Relation)_index)->rd_rel->relfilenode;
+}
+
 const BingoSectionInfoData& BingoPgIndex::getSectionInfo(int section_idx)
 {
     BingoPgSection& current_section = _jumpToSection(section_idx);
     return current_section.getSectionInfo();
 }
 
+bool BingoPgIndex::getSectionSummary(int section_idx, const BingoSectionSummaryData*& summary, const byte*& or_fp)
+{
+    BingoPgSection& current_section = _jumpToSection(section_idx);
+    if (!current_section.hasSummary())
+        return false;
+    summary = &current_section.getSummary();
+    or_fp = current_section.getOrFingerprint().ptr();
+    return true;
+}
+
 void BingoPgIndex::getSectionBitset(int section_idx, BingoPgExternalBitset& section_bitset)
 {
     BingoPgSection& current_section = _jumpToSection(section_idx);
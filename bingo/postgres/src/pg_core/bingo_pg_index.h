@@ -19,6 +19,7 @@ class BingoPgBuildEngine;
 class BingoPgConfig;
 class BingoPgFpData;
 class BingoPgExternalBitset;
+class BingoPgVerticalCounter;
 
 class BingoPgIndex
 {
@@ -93,6 +94,10 @@ public:
     {
         return _index;
     }
+    /*
+     * The index file changes on rebuild, so it identifies the index content
+     */
+    dword getRelFileNode() const;
     INDEX_STRATEGY getIndexStrategy() const
     {
         return _strategy;
@@ -122,9 +127,14 @@ public:
     void readXyzItem(int section_idx, int mol_idx, indigo::Array<char>& xyz_buf);
 
     void andWithBitset(int section_idx, int fp_idx, BingoPgExternalBitset& ext_bitset);
+    void addToCounters(int section_idx, int fp_idx, BingoPgVerticalCounter& ones, BingoPgVerticalCounter& misses, const BingoPgExternalBitset& mask);
 
     int getSectionStructuresNumber(int section_idx);
     const BingoSectionInfoData& getSectionInfo(int section_idx);
+    /*
+     * Returns false if the section has no summary
+     */
+    bool getSectionSummary(int section_idx, const BingoSectionSummaryData*& summary, const byte*& or_fp);
 
     void getSectionBitset(int section_idx, BingoPgExternalBitset& section_bitset);
     void getSectionBitsCount(int section_idx, indigo::Array<int>& bits_count);
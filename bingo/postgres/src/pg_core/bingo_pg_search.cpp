@@ -84,6 +84,15 @@ void BingoPgSearch::prepareRescan(PG_OBJECT scan_desc_ptr)
     }
 }
 
+bool BingoPgSearch::estimateScreening(PG_OBJECT scan_desc_ptr, int max_sections, double& fraction, double& structures, int& query_bits)
+{
+    _indexScanDesc = scan_desc_ptr;
+    if (_initSearch)
+        _initScanSearch();
+
+    return _fpEngine->estimateScreening(max_sections, fraction, structures, query_bits);
+}
+
 void BingoPgSearch::_initScanSearch()
 {
     _initSearch = false;
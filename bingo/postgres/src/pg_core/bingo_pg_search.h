@@ -44,6 +44,18 @@ public:
     }
 
     void prepareRescan(PG_OBJECT scan_desc_ptr);
+    /*
+     * Estimates the fingerprint screening of the scan query on a few sections
+     * (see BingoPgSearchEngine::estimateScreening)
+     */
+    bool estimateScreening(PG_OBJECT scan_desc_ptr, int max_sections, double& fraction, double& structures, int& query_bits);
+    /*
+     * Returns the distance of the last found structure for an ordered scan
+     */
+    bool getOrderDistance(float& distance)
+    {
+        return _fpEngine.get() != 0 && _fpEngine->getOrderDistance(distance);
+    }
 
     DECL_ERROR;
 
@@ -3,9 +3,14 @@
 extern "C"
 {
 #include "access/itup.h"
+#include "access/relscan.h"
 #include "fmgr.h"
 #include "postgres.h"
 #include "storage/bufmgr.h"
+
+#if PG_VERSION_NUM / 100 >= 1000
+#include "port/atomics.h"
+#endif
 }
 
 #include "bingo_pg_fix_post.h"
@@ -26,6 +31,23 @@ extern "C"
 
 using namespace indigo;
 
+#if PG_VERSION_NUM / 100 >= 1000
+/*
+ * Parallel scan state in the dynamic shared memory
+ */
+typedef struct BingoPgParallelScanData
+{
+    /*
+     * Next section to hand out, counted from the block begin
+     */
+    pg_atomic_uint32 next_section;
+    /*
+     * Set by the process that runs the cursor search
+     */
+    pg_atomic_uint32 cursor_taken;
+} BingoPgParallelScanData;
+#endif
+
 void BingoPgFpData::setTidItem(PG_OBJECT item_ptr)
 {
 
@@ -57,7 +79,8 @@ void BingoPgFpData::setXyz(const char* xyz_buf, int xyz_len)
 }
 
 BingoPgSearchEngine::BingoPgSearchEngine()
-    : _fetchFound(false), _currentSection(-1), _currentIdx(-1), _blockBegin(0), _blockEnd(0), _bufferIndexPtr(0), _sectionBitset(BINGO_MOLS_PER_SECTION)
+    : _fetchFound(false), _currentSection(-1), _currentIdx(-1), _blockBegin(0), _blockEnd(0), _bufferIndexPtr(0), _parallelScan(0), _cursorOwner(-1),
+      _sectionBitset(BINGO_MOLS_PER_SECTION)
 {
     _bingoSession = bingoAllocateSessionID();
 }
@@ -94,7 +117,7 @@ bool BingoPgSearchEngine::matchTarget(ItemPointerData& item_data)
     return matchTarget(ItemPointerGetBlockNumber(&item_data), ItemPointerGetOffsetNumber(&item_data));
 }
 
-void BingoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT)
+void BingoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT scan_desc_ptr)
 {
     _bufferIndexPtr = &bingo_idx;
     _currentSection = -1;
@@ -102,12 +125,92 @@ void BingoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT)
     _fetchFound = false;
     _blockBegin = 0;
     _blockEnd = bingo_idx.getSectionNumber();
+    _parallelScan = 0;
+    _cursorOwner = -1;
+
+#if PG_VERSION_NUM / 100 >= 1000
+    /*
+     * Parallel scan shares the sections with the other processes
+     */
+    IndexScanDesc scan_desc = (IndexScanDesc)scan_desc_ptr;
+    if (scan_desc != 0 && scan_desc->parallel_scan != 0)
+        _parallelScan = OffsetToPointer((void*)scan_desc->parallel_scan, scan_desc->parallel_scan->ps_offset);
+#endif
+}
+
+int BingoPgSearchEngine::getParallelScanSize()
+{
+#if PG_VERSION_NUM / 100 >= 1000
+    return sizeof(BingoPgParallelScanData);
+#else
+    return 0;
+#endif
+}
+
+void BingoPgSearchEngine::initParallelScan(PG_OBJECT parallel_scan)
+{
+#if PG_VERSION_NUM / 100 >= 1000
+    BingoPgParallelScanData* scan_data = (BingoPgParallelScanData*)parallel_scan;
+    pg_atomic_init_u32(&scan_data->next_section, 0);
+    pg_atomic_init_u32(&scan_data->cursor_taken, 0);
+#endif
+}
+
+void BingoPgSearchEngine::resetParallelScan(PG_OBJECT parallel_scan)
+{
+#if PG_VERSION_NUM / 100 >= 1000
+    BingoPgParallelScanData* scan_data = (BingoPgParallelScanData*)parallel_scan;
+    pg_atomic_write_u32(&scan_data->next_section, 0);
+    pg_atomic_write_u32(&scan_data->cursor_taken, 0);
+#endif
+}
+
+int BingoPgSearchEngine::_nextSection()
+{
+#if PG_VERSION_NUM / 100 >= 1000
+    if (_parallelScan != 0)
+    {
+        /*
+         * Take the next free section
+         */
+        BingoPgParallelScanData* scan_data = (BingoPgParallelScanData*)_parallelScan;
+        uint32 section_idx = pg_atomic_fetch_add_u32(&scan_data->next_section, 1);
+        if (section_idx >= (uint32)(_blockEnd - _blockBegin))
+            return _blockEnd;
+        return _blockBegin + (int)section_idx;
+    }
+#endif
+    if (_currentSection < 0)
+        return _blockBegin;
+    return _currentSection + 1;
+}
+
+bool BingoPgSearchEngine::_ownCursor()
+{
+    if (_cursorOwner < 0)
+    {
+        _cursorOwner = 1;
+#if PG_VERSION_NUM / 100 >= 1000
+        /*
+         * The cursor can not be shared, so the first process takes all the results
+         */
+        if (_parallelScan != 0)
+        {
+            BingoPgParallelScanData* scan_data = (BingoPgParallelScanData*)_parallelScan;
+            if (pg_atomic_exchange_u32(&scan_data->cursor_taken, 1) != 0)
+                _cursorOwner = 0;
+        }
+#endif
+    }
+    return _cursorOwner == 1;
 }
 
 bool BingoPgSearchEngine::_searchNextCursor(PG_OBJECT result_ptr)
 {
     profTimerStart(t0, "bingo_pg.search_cursor");
     ItemPointerData cmf_item;
+    if (!_ownCursor())
+        return false;
     /*
      * Iterate through the cursor
      */
@@ -155,17 +258,17 @@ bool BingoPgSearchEngine::_searchNextSub(PG_OBJECT result_ptr)
         else
         {
             _fetchFound = false;
-            ++_currentSection;
+            _currentSection = _nextSection();
         }
     }
     profTimerStart(t1, "bingo_pg.search_fp");
 
     if (_currentSection < 0)
-        _currentSection = _blockBegin;
+        _currentSection = _nextSection();
     /*
      * Iterate through the sections bingo_index.readEnd()
      */
-    for (; _currentSection < _blockEnd; ++_currentSection)
+    for (; _currentSection < _blockEnd; _currentSection = _nextSection())
     {
         /*
          * Get section existing structures
@@ -216,6 +319,52 @@ bool BingoPgSearchEngine::_searchNextSub(PG_OBJECT result_ptr)
     return false;
 }
 
+bool BingoPgSearchEngine::_estimateScreeningSub(int max_sections, double& fraction, double& structures, int& query_bits)
+{
+    profTimerStart(t0, "bingo_pg.estimate_sub");
+    BingoPgFpData& query_data = _queryFpData.ref();
+    BingoPgIndex& bingo_index = *_bufferIndexPtr;
+
+    int sections_count = _blockEnd - _blockBegin;
+    if (sections_count <= 0 || max_sections <= 0)
+        return false;
+    int sample_count = __min(max_sections, sections_count);
+
+    query_bits = 0;
+    for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd(); fp_idx = query_data.bitNext(fp_idx))
+        ++query_bits;
+
+    qword total_count = 0;
+    qword screened_count = 0;
+    for (int sample_idx = 0; sample_idx < sample_count; ++sample_idx)
+    {
+        /*
+         * Take the middle sections of equal parts of the index
+         */
+        int section_idx = _blockBegin + (int)(((qword)(2 * sample_idx + 1) * sections_count) / (2 * sample_count));
+        bingo_index.getSectionBitset(section_idx, _sectionBitset);
+        total_count += _sectionBitset.bitsNumber();
+
+        for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd() && _sectionBitset.hasBits(); fp_idx = query_data.bitNext(fp_idx))
+            bingo_index.andWithBitset(section_idx, query_data.getBit(fp_idx), _sectionBitset);
+
+        screened_count += _sectionBitset.bitsNumber();
+    }
+    /*
+     * The section bitset is reused by the search
+     */
+    _currentSection = -1;
+    _currentIdx = -1;
+    _fetchFound = false;
+
+    if (total_count == 0)
+        return false;
+
+    fraction = (double)screened_count / total_count;
+    structures = (double)total_count * sections_count / sample_count;
+    return true;
+}
+
 using namespace indigo;
 
 void BingoPgSearchEngine::_setBingoContext()
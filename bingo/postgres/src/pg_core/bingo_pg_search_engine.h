@@ -141,7 +141,35 @@ public:
 
     void setItemPointer(PG_OBJECT result_ptr);
 
+    /*
+     * Screens up to max_sections sections spread over the index with the
+     * query fingerprint. Returns the fraction of the structures passed the
+     * screening, the estimated number of the structures and the number of
+     * the query fingerprint bits. Returns false if the search type does not
+     * use the fingerprint screening.
+     */
+    virtual bool estimateScreening(int max_sections, double& fraction, double& structures, int& query_bits)
+    {
+        return false;
+    }
+    /*
+     * Returns the distance of the last found structure for an ordered scan
+     */
+    virtual bool getOrderDistance(float& distance)
+    {
+        return false;
+    }
+
     void loadDictionary(BingoPgIndex&);
+
+    /*
+     * Shared state of a parallel index scan. The sections are handed out to
+     * the participating processes one by one, and only one of them runs a
+     * cursor based search
+     */
+    static int getParallelScanSize();
+    static void initParallelScan(PG_OBJECT parallel_scan);
+    static void resetParallelScan(PG_OBJECT parallel_scan);
     //   const char* getDictionary(int& size);
 
 private:
@@ -149,11 +177,20 @@ private:
 protected:
     bool _searchNextCursor(PG_OBJECT result_ptr);
     bool _searchNextSub(PG_OBJECT result_ptr);
+    bool _estimateScreeningSub(int max_sections, double& fraction, double& structures, int& query_bits);
 
     void _setBingoContext();
     bool _fetchForNext();
 
     void _getBlockParameters(indigo::Array<char>& params);
+    /*
+     * Returns the next section to screen or _blockEnd if there are no more
+     */
+    int _nextSection();
+    /*
+     * Returns true if this process should return the cursor search results
+     */
+    bool _ownCursor();
 
     qword _bingoSession;
 
@@ -165,6 +202,8 @@ protected:
     int _blockEnd;
 
     BingoPgIndex* _bufferIndexPtr;
+    PG_OBJECT _parallelScan;
+    int _cursorOwner;
 
     BingoPgExternalBitset _sectionBitset;
     indigo::AutoPtr<BingoPgFpData> _queryFpData;
@@ -25,7 +25,7 @@ extern "C"
 
 using namespace indigo;
 
-MangoPgBuildEngine::MangoPgBuildEngine(BingoPgConfig& bingo_config, const char* rel_name) : BingoPgBuildEngine(), _searchType(-1)
+MangoPgBuildEngine::MangoPgBuildEngine(BingoPgConfig& bingo_config, const char* rel_name) : BingoPgBuildEngine(), _shadowRows(0), _searchType(-1)
 {
     _setBingoContext();
     /*
@@ -92,7 +92,7 @@ bool MangoPgBuildEngine::processStructure(StructCache& struct_cache)
     return true;
 }
 
-void MangoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches)
+void MangoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches, ProcessedCb processed_cb, void* context)
 {
     _setBingoContext();
     int bingo_res;
@@ -100,11 +100,15 @@ void MangoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches)
     _currentCache = 0;
     _structCaches = &struct_caches;
     _fpSize = getFpSize();
+    _processedCb = processed_cb;
+    _processedContext = context;
 
     /*
      * Process target
      */
     bingo_res = bingoIndexProcess(false, _getNextRecordCb, _processResultCb, _processErrorCb, this);
+    _processedCb = 0;
+    _processedContext = 0;
     /*
      * If error on structure, try to parse ids
      */
@@ -143,21 +147,58 @@ void MangoPgBuildEngine::insertShadowInfo(BingoPgFpData& item_data)
 {
     MangoPgFpData& data = (MangoPgFpData&)item_data;
 
-    const char* shadow_rel_name = _shadowRelName.ptr();
-    const char* shadow_hash_name = _shadowHashRelName.ptr();
     ItemPointerData* tid_ptr = &data.getTidItem();
+    QS_DEF(Array<char>, row);
 
-    BingoPgCommon::executeQuery("INSERT INTO %s(b_id,tid_map,mass,fragments,gross,cnt_C,cnt_N,cnt_O,cnt_P,cnt_S,cnt_H) VALUES ("
-                                "'(%d, %d)'::tid, '(%d, %d)'::tid, %f, %d, %s)",
-                                shadow_rel_name, data.getSectionIdx(), data.getStructureIdx(), ItemPointerGetBlockNumber(tid_ptr),
-                                ItemPointerGetOffsetNumber(tid_ptr), data.getMass(), data.getFragmentsCount(), data.getGrossStr());
+    {
+        ArrayOutput output(row);
+        if (_shadowValues.size() > 0)
+            output.writeChar(',');
+        output.printf("('(%d, %d)'::tid, '(%d, %d)'::tid, %f, %d, %s)", data.getSectionIdx(), data.getStructureIdx(), ItemPointerGetBlockNumber(tid_ptr),
+                      ItemPointerGetOffsetNumber(tid_ptr), data.getMass(), data.getFragmentsCount(), data.getGrossStr());
+    }
+    _shadowValues.concat(row);
 
     const RedBlackMap<dword, int>& hashes = data.getHashes();
     for (int h_idx = hashes.begin(); h_idx != hashes.end(); h_idx = hashes.next(h_idx))
     {
-        BingoPgCommon::executeQuery("INSERT INTO %s(b_id, ex_hash, f_count) VALUES ('(%d, %d)'::tid, %d, %d)", shadow_hash_name, data.getSectionIdx(),
-                                    data.getStructureIdx(), hashes.key(h_idx), hashes.value(h_idx));
+        ArrayOutput output(row);
+        if (_shadowHashValues.size() > 0)
+            output.writeChar(',');
+        output.printf("('(%d, %d)'::tid, %d, %d)", data.getSectionIdx(), data.getStructureIdx(), hashes.key(h_idx), hashes.value(h_idx));
+        _shadowHashValues.concat(row);
     }
+
+    if (++_shadowRows >= SHADOW_ROWS_PER_QUERY)
+        flushShadowInfo();
+}
+
+void MangoPgBuildEngine::flushShadowInfo()
+{
+    if (_shadowRows == 0)
+        return;
+
+    QS_DEF(Array<char>, query);
+    {
+        ArrayOutput output(query);
+        output.printf("INSERT INTO %s(b_id,tid_map,mass,fragments,gross,cnt_C,cnt_N,cnt_O,cnt_P,cnt_S,cnt_H) VALUES ", _shadowRelName.ptr());
+        output.write(_shadowValues.ptr(), _shadowValues.size());
+        output.writeChar(0);
+    }
+    BingoPgCommon::executeQuery(query);
+
+    if (_shadowHashValues.size() > 0)
+    {
+        ArrayOutput output(query);
+        output.printf("INSERT INTO %s(b_id, ex_hash, f_count) VALUES ", _shadowHashRelName.ptr());
+        output.write(_shadowHashValues.ptr(), _shadowHashValues.size());
+        output.writeChar(0);
+        BingoPgCommon::executeQuery(query);
+    }
+
+    _shadowValues.clear();
+    _shadowHashValues.clear();
+    _shadowRows = 0;
 }
 
 int MangoPgBuildEngine::getFpSize()
@@ -218,6 +259,7 @@ void MangoPgBuildEngine::prepareShadowInfo(const char* schema_name, const char*
 
 void MangoPgBuildEngine::finishShadowProcessing()
 {
+    flushShadowInfo();
     /*
      * Create shadow indexes
      */
@@ -243,6 +285,7 @@ void MangoPgBuildEngine::_processResultCb(void* context)
         StructCache& struct_cache = struct_caches[cache_idx];
         struct_cache.data.reset(fp_data.release());
         struct_cache.data->setTidItem(&struct_cache.ptr);
+        engine->_structureProcessed(struct_cache);
     }
     else
     {
@@ -27,7 +27,7 @@ public:
     virtual ~MangoPgBuildEngine();
 
     virtual bool processStructure(StructCache& struct_cache);
-    virtual void processStructures(indigo::ObjArray<StructCache>& struct_caches);
+    virtual void processStructures(indigo::ObjArray<StructCache>& struct_caches, ProcessedCb processed_cb, void* context);
 
     virtual int getFpSize();
     virtual int getType() const
@@ -37,11 +37,17 @@ public:
 
     virtual void prepareShadowInfo(const char* schema_name, const char* index_schema);
     virtual void insertShadowInfo(BingoPgFpData&);
+    virtual void flushShadowInfo();
     virtual void finishShadowProcessing();
 
 private:
     MangoPgBuildEngine(const MangoPgBuildEngine&); // no implicit copy
 
+    enum
+    {
+        SHADOW_ROWS_PER_QUERY = 1000
+    };
+
     static void _processResultCb(void* context);
     static bool _readPreparedInfo(int* id, MangoPgFpData& data, int fp_size);
 
@@ -50,6 +56,12 @@ private:
     indigo::Array<char> _relName;
     indigo::Array<char> _shadowRelName;
     indigo::Array<char> _shadowHashRelName;
+    /*
+     * Collected shadow rows to insert
+     */
+    indigo::Array<char> _shadowValues;
+    indigo::Array<char> _shadowHashValues;
+    int _shadowRows;
 
     int _searchType;
 };
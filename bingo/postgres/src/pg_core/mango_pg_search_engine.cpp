@@ -27,6 +27,14 @@ extern "C"
 
 using namespace indigo;
 
+/*
+ * Similarity ordering: the first band width, the minimal band width and the
+ * margin of the screening bounds around a band
+ */
+static const float SIM_ORDER_STEP = 0.1f;
+static const float SIM_ORDER_MIN_STEP = 0.001f;
+static const float SIM_ORDER_EPS = 0.0001f;
+
 void MangoPgFpData::insertHash(dword hash, int c_cnt)
 {
     int* comp_count = _hashes.at2(hash);
@@ -50,7 +58,8 @@ void MangoPgFpData::setGrossStr(const char* gross_str, const char* counter_str)
 
 IMPL_ERROR(MangoPgSearchEngine, "molecule search engine");
 
-MangoPgSearchEngine::MangoPgSearchEngine(BingoPgConfig& bingo_config, const char* rel_name) : BingoPgSearchEngine(), _searchType(-1)
+MangoPgSearchEngine::MangoPgSearchEngine(BingoPgConfig& bingo_config, const char* rel_name)
+    : BingoPgSearchEngine(), _orderIdx(0), _orderMin(0), _orderMax(1), _orderHigh(FLT_MAX), _orderStep(SIM_ORDER_STEP), _orderScore(0), _searchType(-1)
 {
     _setBingoContext();
     /*
@@ -78,7 +87,7 @@ bool MangoPgSearchEngine::matchTarget(int section_idx, int structure_idx)
 
     profTimerStart(t0, "mango_pg.match_target");
 
-    if (_searchType == BingoPgCommon::MOL_SIM || _searchType == BingoPgCommon::MOL_MASS)
+    if (_searchType == BingoPgCommon::MOL_SIM || _searchType == BingoPgCommon::MOL_SIM_ORDER || _searchType == BingoPgCommon::MOL_MASS)
     {
         return true;
     }
@@ -92,19 +101,43 @@ bool MangoPgSearchEngine::matchTarget(int section_idx, int structure_idx)
 
     if (_searchType == BingoPgCommon::MOL_SUB || _searchType == BingoPgCommon::MOL_EXACT || _searchType == BingoPgCommon::MOL_SMARTS)
     {
-        _bufferIndexPtr->readCmfItem(section_idx, structure_idx, mol_buf);
         bingo_res = mangoNeedCoords();
         CORE_HANDLE_ERROR(bingo_res, 0, "molecule search engine: error while getting coordinates flag", bingoGetError());
+        bool need_coords = (bingo_res > 0);
 
-        if (bingo_res > 0)
+        /*
+         * Decoded substructure targets are cached by the index file, so a
+         * rebuilt index does not reuse them. Coordinates are not cached.
+         */
+        bool use_cache = (bingo_target_cache_size > 0 && !need_coords && _searchType != BingoPgCommon::MOL_EXACT);
+        qword target_id = 0;
+        int found = 0;
+
+        if (use_cache)
         {
-            _bufferIndexPtr->readXyzItem(section_idx, structure_idx, xyz_buf);
+            target_id = ((qword)_bufferIndexPtr->getRelFileNode() << 32) | (qword)(section_idx * BINGO_MOLS_PER_SECTION + structure_idx);
+            bingo_res = mangoMatchCachedTarget(target_id, &found);
+            CORE_HANDLE_ERROR_TID(bingo_res, -1, "molecule search engine: error while matching cached target", section_idx, structure_idx, bingoGetError());
+            CORE_RETURN_WARNING_TID(bingo_res, 0, "molecule search engine: error while matching cached target", section_idx, structure_idx, bingoGetWarning());
         }
 
-        //      CORE_HANDLE_WARNING_TID(0, 1, "matching binary target", section_idx, structure_idx, " ");
-        bingo_res = mangoMatchTargetBinary(mol_buf.ptr(), mol_buf.sizeInBytes(), xyz_buf.ptr(), xyz_buf.sizeInBytes());
-        CORE_HANDLE_ERROR_TID(bingo_res, -1, "molecule search engine: error while matching binary target", section_idx, structure_idx, bingoGetError());
-        CORE_RETURN_WARNING_TID(bingo_res, 0, "molecule search engine: error while matching binary target", section_idx, structure_idx, bingoGetWarning());
+        if (!found)
+        {
+            _bufferIndexPtr->readCmfItem(section_idx, structure_idx, mol_buf);
+
+            if (need_coords)
+            {
+                _bufferIndexPtr->readXyzItem(section_idx, structure_idx, xyz_buf);
+            }
+
+            //      CORE_HANDLE_WARNING_TID(0, 1, "matching binary target", section_idx, structure_idx, " ");
+            if (use_cache)
+                bingo_res = mangoMatchTargetBinaryCached(target_id, mol_buf.ptr(), mol_buf.sizeInBytes());
+            else
+                bingo_res = mangoMatchTargetBinary(mol_buf.ptr(), mol_buf.sizeInBytes(), xyz_buf.ptr(), xyz_buf.sizeInBytes());
+            CORE_HANDLE_ERROR_TID(bingo_res, -1, "molecule search engine: error while matching binary target", section_idx, structure_idx, bingoGetError());
+            CORE_RETURN_WARNING_TID(bingo_res, 0, "molecule search engine: error while matching binary target", section_idx, structure_idx, bingoGetWarning());
+        }
 
         result = (bingo_res > 0);
     }
@@ -136,7 +169,24 @@ void MangoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT
 
     IndexScanDesc scan_desc = (IndexScanDesc)scan_desc_ptr;
 
-    if (scan_desc->numberOfKeys >= 1 && scan_desc->numberOfKeys <= 2)
+    int order_bys = 0;
+#if PG_VERSION_NUM / 100 >= 1000
+    order_bys = scan_desc->numberOfOrderBys;
+#endif
+    if (order_bys > 0)
+    {
+        /*
+         * Ordering by similarity. The index skips the NULL and the invalid
+         * structures, so a similarity condition is required to exclude them
+         * from the result in the same way as a sequential scan does
+         */
+        if (scan_desc->numberOfKeys != 1 || scan_desc->keyData[0].sk_strategy != BingoPgCommon::MOL_SIM || order_bys > 1)
+            throw Error("similarity ordering needs exactly one similarity condition on the same index");
+#if PG_VERSION_NUM / 100 >= 1000
+        _searchType = scan_desc->orderByData[0].sk_strategy;
+#endif
+    }
+    else if (scan_desc->numberOfKeys >= 1 && scan_desc->numberOfKeys <= 2)
     {
         _searchType = scan_desc->keyData[0].sk_strategy;
     }
@@ -174,12 +224,19 @@ void MangoPgSearchEngine::prepareQuerySearch(BingoPgIndex& bingo_idx, PG_OBJECT
         _prepareMassSearch(scan_desc);
         break;
     case BingoPgCommon::MOL_SIM:
+    case BingoPgCommon::MOL_SIM_ORDER:
         _prepareSimSearch(scan_desc);
         break;
     default:
         throw Error("unsupported search type %d", _searchType);
         break;
     }
+
+    /*
+     * The cache size can be changed by the session between the queries
+     */
+    int bingo_res = mangoSetTargetCacheSize(bingo_target_cache_size);
+    CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: error while setting target cache size", bingoGetError());
 }
 
 bool MangoPgSearchEngine::searchNext(PG_OBJECT result_ptr)
@@ -199,10 +256,64 @@ bool MangoPgSearchEngine::searchNext(PG_OBJECT result_ptr)
     {
         result = _searchNextSim(result_ptr);
     }
+    else if (_searchType == BingoPgCommon::MOL_SIM_ORDER)
+    {
+        result = _searchNextSimOrder(result_ptr);
+    }
 
     return result;
 }
 
+bool MangoPgSearchEngine::estimateScreening(int max_sections, double& fraction, double& structures, int& query_bits)
+{
+    _setBingoContext();
+    if (_searchType == BingoPgCommon::MOL_SUB || _searchType == BingoPgCommon::MOL_SMARTS)
+        return _estimateScreeningSub(max_sections, fraction, structures, query_bits);
+    return false;
+}
+
+bool MangoPgSearchEngine::_isSimSectionReachable(int section_idx)
+{
+    profTimerStart(t0, "mango_pg.sim_section_bounds");
+    const BingoSectionSummaryData* summary;
+    const byte* or_fp;
+    if (!_bufferIndexPtr->getSectionSummary(section_idx, summary, or_fp))
+        return true;
+
+    BingoPgFpData& query_data = _queryFpData.ref();
+    QS_DEF(Array<int>, bits_range);
+    int *min_bounds, *max_bounds, bingo_res;
+    /*
+     * A structure can not have more common bits than the query bits set in
+     * any structure of the section
+     */
+    int max_common = 0;
+    for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd(); fp_idx = query_data.bitNext(fp_idx))
+    {
+        int fp_block = query_data.getBit(fp_idx);
+        if (or_fp[fp_block >> 3] & (1 << (fp_block & 7)))
+            ++max_common;
+    }
+    /*
+     * Check the bounds for every bits count in the section range
+     */
+    bits_range.clear();
+    for (int bits_count = summary->min_bits_count; bits_count <= summary->max_bits_count; ++bits_count)
+        bits_range.push(bits_count);
+
+    bingo_res = mangoSimilarityGetBitMinMaxBoundsArray(bits_range.size(), bits_range.ptr(), &min_bounds, &max_bounds);
+    CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: error while getting similarity bounds array", bingoGetError());
+
+    for (int i = 0; i < bits_range.size(); ++i)
+    {
+        int low = __max(min_bounds[i], 0);
+        int high = __min(__min(max_common, bits_range[i]), max_bounds[i]);
+        if (low <= high)
+            return true;
+    }
+    return false;
+}
+
 void MangoPgSearchEngine::_errorHandler(const char* message, void*)
 {
     throw Error("Error while searching a molecule: %s", message);
@@ -517,6 +628,32 @@ void MangoPgSearchEngine::_prepareSimSearch(PG_OBJECT scan_desc_ptr)
     }
 
     _getScanQueries(scan_desc->keyData[0].sk_argument, min_bound, max_bound, search_query, search_options);
+
+    if (_searchType == BingoPgCommon::MOL_SIM_ORDER)
+    {
+        /*
+         * The ordering is computed for the query of the condition, and the
+         * bounds of the condition limit the ordered structures
+         */
+#if PG_VERSION_NUM / 100 >= 1000
+        Array<char> order_query;
+        Array<char> order_options;
+        float order_min, order_max;
+        _getScanQueries(scan_desc->orderByData[0].sk_argument, order_min, order_max, order_query, order_options);
+        if (strcmp(order_query.ptr(), search_query.ptr()) != 0 || strcmp(order_options.ptr(), search_options.ptr()) != 0)
+            throw Error("similarity ordering and similarity condition should have the same query and metric");
+#endif
+        if (min_bound > max_bound)
+            throw Error("min bound %f can not be greater then max bound %f", min_bound, max_bound);
+
+        _orderResults.clear();
+        _orderIdx = 0;
+        _orderMin = min_bound;
+        _orderMax = max_bound;
+        _orderHigh = FLT_MAX;
+        _orderStep = SIM_ORDER_STEP;
+        _orderScore = 0;
+    }
     /*
      * Get block parameters and split search options
      */
@@ -527,11 +664,17 @@ void MangoPgSearchEngine::_prepareSimSearch(PG_OBJECT scan_desc_ptr)
     bingo_res = mangoSetupMatch(search_type.ptr(), search_query.ptr(), search_options.ptr());
     CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: can not set sim search context", bingoGetError());
 
-    if (min_bound > max_bound)
-        throw Error("min bound %f can not be greater then max bound %f", min_bound, max_bound);
+    /*
+     * The ordering sets the bounds for every band
+     */
+    if (_searchType == BingoPgCommon::MOL_SIM)
+    {
+        if (min_bound > max_bound)
+            throw Error("min bound %f can not be greater then max bound %f", min_bound, max_bound);
 
-    bingo_res = mangoSimilaritySetMinMaxBounds(min_bound, max_bound);
-    CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: can not get similarity min max bounds", bingoGetError());
+        bingo_res = mangoSimilaritySetMinMaxBounds(min_bound, max_bound);
+        CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: can not get similarity min max bounds", bingoGetError());
+    }
 
     const char* fingerprint_buf;
     int fp_len;
@@ -663,122 +806,24 @@ bool MangoPgSearchEngine::_searchNextSim(PG_OBJECT result_ptr)
         else
         {
             _fetchFound = false;
-            ++_currentSection;
+            _currentSection = _nextSection();
         }
     }
 
     BingoPgFpData& query_data = _queryFpData.ref();
-    BingoPgIndex& bingo_index = *_bufferIndexPtr;
     QS_DEF(Array<int>, bits_count);
-    QS_DEF(Array<int>, common_ones);
-    BingoPgExternalBitset screening_bitset(BINGO_MOLS_PER_SECTION);
-
-    int *min_bounds, *max_bounds, bingo_res;
     /*
      * Read first section
      */
     if (_currentSection < 0)
-        _currentSection = _blockBegin;
+        _currentSection = _nextSection();
     /*
      * Iterate through the sections
      */
-    for (; _currentSection < _blockEnd; ++_currentSection)
+    for (; _currentSection < _blockEnd; _currentSection = _nextSection())
     {
         _currentIdx = -1;
-        /*
-         * Get section existing structures
-         */
-        bingo_index.getSectionBitset(_currentSection, _sectionBitset);
-        int possible_str_count = _sectionBitset.bitsNumber();
-        /*
-         * If there is no bits then screen whole the structures
-         */
-        if (query_data.bitEnd() != 0 && possible_str_count > 0)
-        {
-            /*
-             * Read structures bits count
-             */
-            //         profTimerStart(t5, "mango_pg.get_section_bits");
-            bingo_index.getSectionBitsCount(_currentSection, bits_count);
-            //         profTimerStop(t5);
-            /*
-             * Prepare min max bounds
-             */
-            //         profTimerStart(t3, "mango_pg.get_min_max");
-            bingo_res = mangoSimilarityGetBitMinMaxBoundsArray(bits_count.size(), bits_count.ptr(), &min_bounds, &max_bounds);
-            //         profTimerStop(t3);
-
-            CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: error while getting similarity bounds array", bingoGetError());
-
-            /*
-             * Prepare common bits array
-             */
-            common_ones.resize(bits_count.size());
-            common_ones.zerofill();
-            /*
-             * Iterate through the query bits
-             */
-            int iteration_idx = 0;
-            int fp_count = query_data.bitEnd();
-            for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd() && possible_str_count > 0; fp_idx = query_data.bitNext(fp_idx))
-            {
-                int fp_block = query_data.getBit(fp_idx);
-                /*
-                 * Copy passed structures on each iteration step
-                 */
-                //            profTimerStart(t7, "mango_pg.copy");
-                screening_bitset.copy(_sectionBitset);
-                //            profTimerStop(t7);
-
-                /*
-                 * Get commons in fingerprint buffer
-                 */
-
-                //            profTimerStart(t2, "mango_pg.andwith");
-                bingo_index.andWithBitset(_currentSection, fp_block, screening_bitset);
-                //            profTimerStop(t2);
-
-                //            profTimerStart(t4, "mango_pg.new_common_ones");
-                int screen_idx = screening_bitset.begin();
-                for (; screen_idx != screening_bitset.end() && possible_str_count > 0; screen_idx = screening_bitset.next(screen_idx))
-                {
-                    /*
-                     * Calculate new common ones
-                     */
-                    int& one_counter = common_ones[screen_idx];
-                    ++one_counter;
-                    /*
-                     * If common ones is out of bounds then it is not passed the screening
-                     */
-                    if ((one_counter > max_bounds[screen_idx]) || ((one_counter + fp_count - iteration_idx) < min_bounds[screen_idx]))
-                    {
-                        _sectionBitset.set(screen_idx, false);
-                        --possible_str_count;
-                    }
-                }
-                //            profTimerStop(t4);
-                ++iteration_idx;
-            }
-
-            /*
-             * Screen the last time for all the possible structures
-             */
-            //         profTimerStart(t6, "mango_pg.lst_screen");
-            int screen_idx = _sectionBitset.begin();
-            for (; screen_idx != _sectionBitset.end() && possible_str_count > 0; screen_idx = _sectionBitset.next(screen_idx))
-            {
-                int& one_counter = common_ones[screen_idx];
-                if ((one_counter > max_bounds[screen_idx]) || (one_counter < min_bounds[screen_idx]))
-                {
-                    /*
-                     * Not passed screening
-                     */
-                    _sectionBitset.set(screen_idx, false);
-                    --possible_str_count;
-                }
-            }
-            //         profTimerStop(t6);
-        }
+        _screenSimSection(_currentSection, bits_count);
         /*
          * Return false on empty fingerprint
          */
@@ -810,4 +855,237 @@ bool MangoPgSearchEngine::_searchNextSim(PG_OBJECT result_ptr)
      * No matches or section ends
      */
     return false;
+}
+
+void MangoPgSearchEngine::_screenSimSection(int section_idx, indigo::Array<int>& bits_count)
+{
+    BingoPgFpData& query_data = _queryFpData.ref();
+    BingoPgIndex& bingo_index = *_bufferIndexPtr;
+    QS_DEF(Array<int>, max_limits);
+    QS_DEF(Array<int>, miss_limits);
+
+    int *min_bounds, *max_bounds, bingo_res;
+
+    bits_count.clear();
+    /*
+     * Skip the whole section if no structure can reach the bounds
+     */
+    if (query_data.bitEnd() != 0 && !_isSimSectionReachable(section_idx))
+    {
+        _sectionBitset.clear();
+        return;
+    }
+    /*
+     * Get section existing structures
+     */
+    bingo_index.getSectionBitset(section_idx, _sectionBitset);
+    int possible_str_count = _sectionBitset.bitsNumber();
+    if (possible_str_count == 0)
+        return;
+    /*
+     * Read structures bits count
+     */
+    //   profTimerStart(t5, "mango_pg.get_section_bits");
+    bingo_index.getSectionBitsCount(section_idx, bits_count);
+    //   profTimerStop(t5);
+    /*
+     * If there is no bits then screen whole the structures
+     */
+    if (query_data.bitEnd() == 0)
+        return;
+    /*
+     * Prepare min max bounds
+     */
+    //   profTimerStart(t3, "mango_pg.get_min_max");
+    bingo_res = mangoSimilarityGetBitMinMaxBoundsArray(bits_count.size(), bits_count.ptr(), &min_bounds, &max_bounds);
+    //   profTimerStop(t3);
+
+    CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: error while getting similarity bounds array", bingoGetError());
+
+    /*
+     * Prepare the counters. A structure is screened out when its common
+     * ones exceed the max bound or when its misses exceed the number
+     * of the query bits that may be missed to reach the min bound
+     */
+    int fp_count = query_data.bitEnd();
+    int str_count = bits_count.size();
+    qword* alive_words = _sectionBitset.getWords();
+    max_limits.resize(str_count);
+    miss_limits.resize(str_count);
+    for (int str_idx = 0; str_idx < str_count; ++str_idx)
+    {
+        max_limits[str_idx] = max_bounds[str_idx];
+        miss_limits[str_idx] = fp_count - min_bounds[str_idx];
+        if (max_limits[str_idx] < 0 || miss_limits[str_idx] < 0)
+            alive_words[str_idx >> 6] &= ~(1ULL << (str_idx & 63));
+    }
+    _sectionBitset.updateWordsInUse();
+
+    _commonOnes.init(BINGO_MOLS_PER_SECTION, fp_count);
+    _commonMisses.init(BINGO_MOLS_PER_SECTION, fp_count);
+    _maxCommonOnes.init(BINGO_MOLS_PER_SECTION, fp_count);
+    _maxMisses.init(BINGO_MOLS_PER_SECTION, fp_count);
+    _maxCommonOnes.assign(max_limits.ptr(), str_count);
+    _maxMisses.assign(miss_limits.ptr(), str_count);
+    /*
+     * Iterate through the query bits
+     */
+    int iteration_idx = 0;
+    for (int fp_idx = query_data.bitBegin(); fp_idx != query_data.bitEnd() && _sectionBitset.hasBits(); fp_idx = query_data.bitNext(fp_idx))
+    {
+        int fp_block = query_data.getBit(fp_idx);
+        /*
+         * Count common ones and misses for the passed structures
+         */
+        //      profTimerStart(t2, "mango_pg.add_count");
+        bingo_index.addToCounters(section_idx, fp_block, _commonOnes, _commonMisses, _sectionBitset);
+        //      profTimerStop(t2);
+
+        /*
+         * Screen the structures every few bits
+         */
+        ++iteration_idx;
+        if (iteration_idx % SIM_SCREEN_STEP == 0)
+        {
+            //         profTimerStart(t4, "mango_pg.screen");
+            _commonOnes.clearGreater(_maxCommonOnes, alive_words);
+            _commonMisses.clearGreater(_maxMisses, alive_words);
+            _sectionBitset.updateWordsInUse();
+            //         profTimerStop(t4);
+        }
+    }
+
+    /*
+     * Screen the last time for all the possible structures. All the query
+     * bits are counted, so the misses check is the min bound check
+     */
+    //   profTimerStart(t6, "mango_pg.lst_screen");
+    if (iteration_idx == fp_count)
+    {
+        _commonOnes.clearGreater(_maxCommonOnes, alive_words);
+        _commonMisses.clearGreater(_maxMisses, alive_words);
+        _sectionBitset.updateWordsInUse();
+    }
+    //   profTimerStop(t6);
+}
+
+bool MangoPgSearchEngine::_searchNextSimOrder(PG_OBJECT result_ptr)
+{
+    profTimerStart(t0, "mango_pg.search_sim_order");
+    /*
+     * The order can not be shared, so the first process of a parallel scan
+     * returns all the structures
+     */
+    if (!_ownCursor())
+        return false;
+    /*
+     * Return false on empty fingerprint, as the similarity condition does
+     */
+    if (_queryFpData.ref().bitEnd() == 0)
+        return false;
+
+    while (_orderIdx >= _orderResults.size())
+    {
+        /*
+         * All the bands are returned
+         */
+        if (_orderHigh < 0)
+            return false;
+        _collectSimBand();
+    }
+
+    SimOrderResult& result = _orderResults[_orderIdx++];
+    _currentSection = result.section_idx;
+    _currentIdx = result.structure_idx;
+    _orderScore = result.score;
+    setItemPointer(result_ptr);
+    return true;
+}
+
+void MangoPgSearchEngine::_collectSimBand()
+{
+    profTimerStart(t0, "mango_pg.sim_order_band");
+    QS_DEF(Array<int>, bits_count);
+    int bingo_res;
+
+    float high = _orderHigh;
+    float top = __min(high, _orderMax);
+    float low = __max(top - _orderStep, _orderMin);
+    bool too_many = true;
+
+    while (too_many)
+    {
+        too_many = false;
+        _orderResults.clear();
+        _orderIdx = 0;
+        /*
+         * The bounds only screen the structures, and the band is checked by the
+         * scores. So the bounds are a little wider than the band
+         */
+        bingo_res = mangoSimilaritySetMinMaxBounds(__max(low - SIM_ORDER_EPS, 0.0f), __min(top + SIM_ORDER_EPS, 1.0f));
+        CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: can not get similarity min max bounds", bingoGetError());
+
+        for (int section_idx = _blockBegin; section_idx < _blockEnd && !too_many; ++section_idx)
+        {
+            _screenSimSection(section_idx, bits_count);
+
+            for (int str_idx = _sectionBitset.begin(); str_idx != _sectionBitset.end(); str_idx = _sectionBitset.next(str_idx))
+            {
+                float score;
+                bingo_res = mangoSimilarityGetScoreFromBits(bits_count[str_idx], _commonOnes.get(str_idx), &score);
+                CORE_HANDLE_ERROR(bingo_res, 1, "molecule search engine: can not get similarity score", bingoGetError());
+                /*
+                 * The higher scores are returned by the previous bands
+                 */
+                if (score >= high || score > _orderMax || score < low)
+                    continue;
+
+                SimOrderResult& result = _orderResults.push();
+                result.section_idx = section_idx;
+                result.structure_idx = str_idx;
+                result.score = score;
+            }
+            /*
+             * Narrow the band if there are too many structures in it
+             */
+            if (_orderResults.size() > SIM_ORDER_MAX_RESULTS && top - low > SIM_ORDER_MIN_STEP)
+            {
+                too_many = true;
+                low = (top + low) / 2;
+            }
+        }
+    }
+
+    _orderResults.qsort(_cmpSimOrderResults, 0);
+    _orderHigh = (low > _orderMin) ? low : -1.0f;
+    /*
+     * Adapt the next band to return about SIM_ORDER_RESULTS structures,
+     * expecting the same density of the scores
+     */
+    float width = top - low;
+    int hits = _orderResults.size();
+    if (hits == 0)
+        _orderStep = width * 2;
+    else
+        _orderStep = __min(width * SIM_ORDER_RESULTS / hits, width * 2);
+    _orderStep = __max(_orderStep, SIM_ORDER_MIN_STEP);
+}
+
+int MangoPgSearchEngine::_cmpSimOrderResults(SimOrderResult& r1, SimOrderResult& r2, void* context)
+{
+    if (r1.score > r2.score)
+        return -1;
+    if (r1.score < r2.score)
+        return 1;
+    if (r1.section_idx != r2.section_idx)
+        return r1.section_idx - r2.section_idx;
+    return r1.structure_idx - r2.structure_idx;
+}
+
+bool MangoPgSearchEngine::getOrderDistance(float& distance)
+{
+    if (_searchType != BingoPgCommon::MOL_SIM_ORDER)
+        return false;
+    distance = 1.0f - _orderScore;
+    return true;
 }
\ No newline at end of file
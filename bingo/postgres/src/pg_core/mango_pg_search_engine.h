@@ -12,6 +12,7 @@
 #include "base_cpp/red_black.h"
 
 #include "bingo_pg_cursor.h"
+#include "bingo_pg_vertical_counter.h"
 #include "bingo_postgres.h"
 #include "pg_bingo_context.h"
 
@@ -99,6 +100,8 @@ public:
 
     virtual void prepareQuerySearch(BingoPgIndex&, PG_OBJECT scan_desc);
     virtual bool searchNext(PG_OBJECT result_ptr);
+    virtual bool estimateScreening(int max_sections, double& fraction, double& structures, int& query_bits);
+    virtual bool getOrderDistance(float& distance);
 
     DECL_ERROR;
 
@@ -106,6 +109,13 @@ private:
     MangoPgSearchEngine(const MangoPgSearchEngine&); // no implicit copy
 
     bool _searchNextSim(PG_OBJECT result_ptr);
+    bool _searchNextSimOrder(PG_OBJECT result_ptr);
+    bool _isSimSectionReachable(int section_idx);
+    /*
+     * Screens a section with the similarity bounds. The passed structures are
+     * left in the section bitset, and their common ones in the counter
+     */
+    void _screenSimSection(int section_idx, indigo::Array<int>& bits_count);
 
     void _prepareExactQueryStrings(indigo::Array<char>& what_clause, indigo::Array<char>& from_clause, indigo::Array<char>& where_clause);
     void _prepareExactTauStrings(indigo::Array<char>& what_clause, indigo::Array<char>& from_clause, indigo::Array<char>& where_clause);
@@ -121,6 +131,49 @@ private:
 
     static void _errorHandler(const char* message, void* context);
 
+    /*
+     * Similarity screening counters: common ones and misses of the query bits
+     * for every structure of a section, and their allowed maximums. The
+     * structures are screened out every SIM_SCREEN_STEP query bits
+     */
+    enum
+    {
+        SIM_SCREEN_STEP = 8
+    };
+    BingoPgVerticalCounter _commonOnes;
+    BingoPgVerticalCounter _commonMisses;
+    BingoPgVerticalCounter _maxCommonOnes;
+    BingoPgVerticalCounter _maxMisses;
+
+    /*
+     * Similarity ordering returns the structures by the bands of the scores
+     * going down from the max bound of the similarity condition to its min
+     * bound. Every band is collected with one pass over the index
+     * and sorted, and the width of the next band is adapted to return about
+     * SIM_ORDER_RESULTS structures
+     */
+    enum
+    {
+        SIM_ORDER_RESULTS = 200,
+        SIM_ORDER_MAX_RESULTS = 100000
+    };
+    struct SimOrderResult
+    {
+        int section_idx;
+        int structure_idx;
+        float score;
+    };
+    void _collectSimBand();
+    static int _cmpSimOrderResults(SimOrderResult& r1, SimOrderResult& r2, void* context);
+
+    indigo::Array<SimOrderResult> _orderResults;
+    int _orderIdx;
+    float _orderMin;
+    float _orderMax;
+    float _orderHigh;
+    float _orderStep;
+    float _orderScore;
+
     indigo::Array<char> _relName;
     indigo::Array<char> _shadowRelName;
     indigo::Array<char> _shadowHashRelName;
@@ -25,7 +25,7 @@ extern "C"
 
 using namespace indigo;
 
-RingoPgBuildEngine::RingoPgBuildEngine(BingoPgConfig& bingo_config, const char* rel_name) : BingoPgBuildEngine(), _searchType(-1)
+RingoPgBuildEngine::RingoPgBuildEngine(BingoPgConfig& bingo_config, const char* rel_name) : BingoPgBuildEngine(), _shadowRows(0), _searchType(-1)
 {
     _setBingoContext();
     //   bingoSetErrorHandler(_errorHandler, 0);
@@ -87,7 +87,7 @@ bool RingoPgBuildEngine::processStructure(StructCache& struct_cache)
     return true;
 }
 
-void RingoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches)
+void RingoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches, ProcessedCb processed_cb, void* context)
 {
     _setBingoContext();
     int bingo_res;
@@ -95,11 +95,15 @@ void RingoPgBuildEngine::processStructures(ObjArray<StructCache>& struct_caches)
     _currentCache = 0;
     _structCaches = &struct_caches;
     _fpSize = getFpSize();
+    _processedCb = processed_cb;
+    _processedContext = context;
 
     /*
      * Process target
      */
     bingo_res = bingoIndexProcess(true, _getNextRecordCb, _processResultCb, _processErrorCb, this);
+    _processedCb = 0;
+    _processedContext = 0;
     CORE_HANDLE_ERROR(bingo_res, 0, "reaction build engine: error while processing records", bingoGetError());
     _setBingoContext();
 }
@@ -107,13 +111,38 @@ void RingoPgBuildEngine::insertShadowInfo(BingoPgFpData& item_data)
 {
     RingoPgFpData& data = (RingoPgFpData&)item_data;
 
-    const char* shadow_rel_name = _shadowRelName.ptr();
     ItemPointerData* tid_ptr = &data.getTidItem();
+    QS_DEF(Array<char>, row);
+
+    {
+        ArrayOutput output(row);
+        if (_shadowValues.size() > 0)
+            output.writeChar(',');
+        output.printf("('(%d, %d)'::tid, '(%d, %d)'::tid, %d)", data.getSectionIdx(), data.getStructureIdx(), ItemPointerGetBlockNumber(tid_ptr),
+                      ItemPointerGetOffsetNumber(tid_ptr), data.getHash());
+    }
+    _shadowValues.concat(row);
+
+    if (++_shadowRows >= SHADOW_ROWS_PER_QUERY)
+        flushShadowInfo();
+}
+
+void RingoPgBuildEngine::flushShadowInfo()
+{
+    if (_shadowRows == 0)
+        return;
+
+    QS_DEF(Array<char>, query);
+    {
+        ArrayOutput output(query);
+        output.printf("INSERT INTO %s(b_id,tid_map,ex_hash) VALUES ", _shadowRelName.ptr());
+        output.write(_shadowValues.ptr(), _shadowValues.size());
+        output.writeChar(0);
+    }
+    BingoPgCommon::executeQuery(query);
 
-    BingoPgCommon::executeQuery("INSERT INTO %s(b_id,tid_map,ex_hash) VALUES ("
-                                "'(%d, %d)'::tid, '(%d, %d)'::tid, %d)",
-                                shadow_rel_name, data.getSectionIdx(), data.getStructureIdx(), ItemPointerGetBlockNumber(tid_ptr),
-                                ItemPointerGetOffsetNumber(tid_ptr), data.getHash());
+    _shadowValues.clear();
+    _shadowRows = 0;
 }
 
 int RingoPgBuildEngine::getFpSize()
@@ -157,6 +186,7 @@ void RingoPgBuildEngine::prepareShadowInfo(const char* schema_name, const char*
 
 void RingoPgBuildEngine::finishShadowProcessing()
 {
+    flushShadowInfo();
     /*
      * Create shadow indexes
      */
@@ -179,6 +209,7 @@ void RingoPgBuildEngine::_processResultCb(void* context)
         StructCache& struct_cache = struct_caches[cache_idx];
         struct_cache.data.reset(fp_data.release());
         struct_cache.data->setTidItem(&struct_cache.ptr);
+        engine->_structureProcessed(struct_cache);
     }
     else
     {
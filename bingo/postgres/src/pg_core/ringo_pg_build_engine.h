@@ -24,7 +24,7 @@ public:
     virtual ~RingoPgBuildEngine();
 
     virtual bool processStructure(StructCache& struct_cache);
-    virtual void processStructures(indigo::ObjArray<StructCache>& struct_cache);
+    virtual void processStructures(indigo::ObjArray<StructCache>& struct_cache, ProcessedCb processed_cb, void* context);
 
     virtual int getFpSize();
     virtual int getType() const
@@ -34,6 +34,7 @@ public:
 
     virtual void prepareShadowInfo(const char* schema_name, const char* index_schema);
     virtual void insertShadowInfo(BingoPgFpData&);
+    virtual void flushShadowInfo();
     virtual void finishShadowProcessing();
 
     // hardcode return single threading for reactions due to an instable state
@@ -45,11 +46,21 @@ public:
 private:
     RingoPgBuildEngine(const RingoPgBuildEngine&); // no implicit copy
 
+    enum
+    {
+        SHADOW_ROWS_PER_QUERY = 1000
+    };
+
     static void _processResultCb(void* context);
     static bool _readPreparedInfo(int* id, RingoPgFpData& data, int fp_size);
 
     indigo::Array<char> _relName;
     indigo::Array<char> _shadowRelName;
+    /*
+     * Collected shadow rows to insert
+     */
+    indigo::Array<char> _shadowValues;
+    int _shadowRows;
 
     int _searchType;
 };
@@ -117,6 +117,14 @@ bool RingoPgSearchEngine::searchNext(PG_OBJECT result_ptr)
     return result;
 }
 
+bool RingoPgSearchEngine::estimateScreening(int max_sections, double& fraction, double& structures, int& query_bits)
+{
+    _setBingoContext();
+    if (_searchType == BingoPgCommon::REACT_SUB || _searchType == BingoPgCommon::REACT_SMARTS)
+        return _estimateScreeningSub(max_sections, fraction, structures, query_bits);
+    return false;
+}
+
 void RingoPgSearchEngine::_errorHandler(const char* message, void*)
 {
     throw Error("Error while searching a reaction: %s", message);
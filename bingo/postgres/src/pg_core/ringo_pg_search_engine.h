@@ -63,6 +63,7 @@ public:
 
     virtual void prepareQuerySearch(BingoPgIndex&, PG_OBJECT scan_desc);
     virtual bool searchNext(PG_OBJECT result_ptr);
+    virtual bool estimateScreening(int max_sections, double& fraction, double& structures, int& query_bits);
 
     DECL_ERROR;
 
@@ -29,6 +29,8 @@
 #define THREAD_MOD __stdcall
 #define THREAD_END return 0
 
+typedef void* OS_THREAD_HANDLE;
+
 #else
 
 #include <pthread.h>
@@ -39,6 +41,8 @@
     pthread_exit(NULL);                                                                                                                                        \
     return 0
 
+typedef pthread_t OS_THREAD_HANDLE;
+
 #endif
 
 #ifdef __cplusplus
@@ -48,6 +52,11 @@ extern "C"
 
     void osThreadCreate(THREAD_RET(THREAD_MOD* func)(void* param), void* param);
 
+    // Thread created by this function must be released by osThreadJoin
+    void osThreadCreateJoinable(THREAD_RET(THREAD_MOD* func)(void* param), void* param, OS_THREAD_HANDLE* handle);
+    // Waits for the thread to finish
+    void osThreadJoin(OS_THREAD_HANDLE handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,3 +24,13 @@ void osThreadCreate(THREAD_RET(THREAD_MOD* func)(void* param), void* param)
     pthread_create(&thread, NULL, func, (void*)param);
     pthread_detach(thread);
 }
+
+void osThreadCreateJoinable(THREAD_RET(THREAD_MOD* func)(void* param), void* param, OS_THREAD_HANDLE* handle)
+{
+    pthread_create(handle, NULL, func, (void*)param);
+}
+
+void osThreadJoin(OS_THREAD_HANDLE handle)
+{
+    pthread_join(handle, NULL);
+}
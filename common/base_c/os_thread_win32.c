@@ -24,3 +24,14 @@ void osThreadCreate(THREAD_RET(THREAD_MOD* func)(void* param), void* param)
 {
     CreateThread(NULL, 0, func, param, 0, NULL);
 }
+
+void osThreadCreateJoinable(THREAD_RET(THREAD_MOD* func)(void* param), void* param, OS_THREAD_HANDLE* handle)
+{
+    *handle = CreateThread(NULL, 0, func, param, 0, NULL);
+}
+
+void osThreadJoin(OS_THREAD_HANDLE handle)
+{
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+}
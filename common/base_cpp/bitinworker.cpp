@@ -21,7 +21,13 @@
 
 using namespace indigo;
 
-BitInWorker::BitInWorker(int StartBits, Scanner& NewIn) : _bits(StartBits), _scanner(NewIn)
+BitInWorker::BitInWorker(int StartBits, Scanner& NewIn) : _bits(StartBits), _scanner(&NewIn), _data(0), _size(0), _pos(0)
+{
+    _bitBuffer = 0L;
+    _bitBufferCount = 0;
+}
+
+BitInWorker::BitInWorker(int StartBits, const byte* data, int size) : _bits(StartBits), _scanner(0), _data(data), _size(size), _pos(0)
 {
     _bitBuffer = 0L;
     _bitBufferCount = 0;
@@ -29,7 +35,7 @@ BitInWorker::BitInWorker(int StartBits, Scanner& NewIn) : _bits(StartBits), _sca
 
 bool BitInWorker::isEOF(void)
 {
-    if (_scanner.isEOF())
+    if (_isInputEOF())
     {
         if (_bitBufferCount < _bits)
             return true;
@@ -44,7 +50,7 @@ bool BitInWorker::readBits(int& Code)
 {
     unsigned int Res;
 
-    if (_scanner.isEOF())
+    if (_isInputEOF())
     {
         if (_bitBufferCount < _bits)
             return false;
@@ -64,11 +70,11 @@ bool BitInWorker::readBits(int& Code)
     {
         int offset = (sizeof(int) - 1) * 8 - _bitBufferCount;
 
-        _bitBuffer |= (byte)(_scanner.readByte()) << offset;
+        _bitBuffer |= (byte)(_readInputByte()) << offset;
 
         _bitBufferCount += 8;
 
-        if (_scanner.isEOF())
+        if (_isInputEOF())
             break;
     }
 
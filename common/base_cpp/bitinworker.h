@@ -20,16 +20,17 @@
 #define __bitinworker_h__
 
 #include "base_c/defs.h"
+#include "base_cpp/scanner.h"
 
 namespace indigo
 {
 
-    class Scanner;
-
     class DLLEXPORT BitInWorker
     {
     public:
         BitInWorker(int StartBits, Scanner& NewIn);
+        // Reads directly from a memory block, without the scanner calls
+        BitInWorker(int StartBits, const byte* data, int size);
 
         bool readBits(int& Code);
 
@@ -44,7 +45,20 @@ namespace indigo
 
         dword _bitBuffer;
 
-        Scanner& _scanner;
+        Scanner* _scanner;
+
+        const byte* _data;
+        int _size;
+        int _pos;
+
+        inline bool _isInputEOF()
+        {
+            return _scanner != 0 ? _scanner->isEOF() : _pos >= _size;
+        }
+        inline byte _readInputByte()
+        {
+            return _scanner != 0 ? _scanner->readByte() : _data[_pos++];
+        }
 
         BitInWorker(const BitInWorker&);
     };
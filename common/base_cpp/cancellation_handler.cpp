@@ -93,12 +93,12 @@ namespace indigo
 
     AutoCancellationHandler::AutoCancellationHandler(CancellationHandler* hand)
     {
-        resetCancellationHandler(hand);
+        _prev = resetCancellationHandler(hand);
     }
 
     AutoCancellationHandler::~AutoCancellationHandler()
     {
-        resetCancellationHandler(nullptr);
+        resetCancellationHandler(_prev.release());
     }
 
 } // namespace indigo
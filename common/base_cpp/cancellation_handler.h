@@ -61,11 +61,17 @@ namespace indigo
     // TAKES Ownership!!!
     DLLEXPORT std::unique_ptr<CancellationHandler> resetCancellationHandler(CancellationHandler* handler);
 
+    // Installs the handler for the current scope and restores the previous one
     class AutoCancellationHandler
     {
     public:
         AutoCancellationHandler(CancellationHandler*);
         ~AutoCancellationHandler();
+
+    private:
+        AutoCancellationHandler(const AutoCancellationHandler&); // no implicit copy
+
+        std::unique_ptr<CancellationHandler> _prev;
     };
 } // namespace indigo
 
@@ -93,6 +93,8 @@ void OsCommandDispatcher::_run(int nthreads)
 {
     _last_command_index = 0;
     _expected_command_index = 0;
+    // Command indices start from zero again if the dispatcher is reused
+    _storedResults.setOffset(0);
     _need_to_terminate = false;
     _exception_to_forward = NULL;
 
@@ -107,8 +109,9 @@ void OsCommandDispatcher::_run(int nthreads)
     _parent_session_ID = TL_GET_SESSION_ID();
 
     // Create handling threads
+    _threads.clear_resize(_left_thread_count);
     for (int i = 0; i < _left_thread_count; i++)
-        osThreadCreate(_threadFuncStatic, this);
+        osThreadCreateJoinable(_threadFuncStatic, this, &_threads[i]);
 
     _mainLoop();
 }
@@ -132,6 +135,11 @@ void OsCommandDispatcher::_mainLoop()
             _onMsgHandleException((Exception*)parameter);
     }
 
+    // Threads still use the message system after the last message
+    for (int i = 0; i < _threads.size(); i++)
+        osThreadJoin(_threads[i]);
+    _threads.clear();
+
     if (_exception_to_forward != NULL)
     {
         Exception* cur = _exception_to_forward;
@@ -40,6 +40,7 @@
 //
 
 #include "base_c/defs.h"
+#include "base_c/os_thread.h"
 #include "base_cpp/array.h"
 #include "base_cpp/cyclic_array.h"
 #include "base_cpp/os_sync_wrapper.h"
@@ -48,14 +49,14 @@
 namespace indigo
 {
 
-    class OsCommandResult
+    class DLLEXPORT OsCommandResult
     {
     public:
         virtual ~OsCommandResult(){};
         virtual void clear(){};
     };
 
-    class OsCommand
+    class DLLEXPORT OsCommand
     {
     public:
         virtual ~OsCommand(){};
@@ -67,7 +68,7 @@ namespace indigo
 
     class Exception;
 
-    class OsCommandDispatcher
+    class DLLEXPORT OsCommandDispatcher
     {
     public:
         enum
@@ -135,6 +136,9 @@ namespace indigo
         PtrArray<OsCommandResult> _availableResults;
         CyclicArray<OsCommandResult*> _storedResults;
         Array<OsSemaphore*> _syspendedThreads;
+        // Handling threads are joined before leaving the main loop, so
+        // the dispatcher can be destroyed right after run() returns
+        Array<OS_THREAD_HANDLE> _threads;
 
         Exception* _exception_to_forward;
 
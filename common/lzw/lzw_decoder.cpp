@@ -30,6 +30,11 @@ LzwDecoder::LzwDecoder(LzwDict& NewDict, Scanner& NewIn) : _dict(NewDict), _biti
 {
 }
 
+LzwDecoder::LzwDecoder(LzwDict& NewDict, const byte* data, int size)
+    : _dict(NewDict), _bitin(_dict.getBitCodeSize(), data, size), CP_INIT, TL_CP_GET(_symbolsBuf)
+{
+}
+
 bool LzwDecoder::isEOF(void)
 {
     if (_bitin.isEOF())
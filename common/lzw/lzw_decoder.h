@@ -37,6 +37,8 @@ namespace indigo
         DECL_ERROR;
 
         LzwDecoder(LzwDict& NewDict, Scanner& NewIn);
+        // Decodes a memory block, without the scanner calls
+        LzwDecoder(LzwDict& NewDict, const byte* data, int size);
 
         bool isEOF(void);
 
@@ -34,11 +34,16 @@ namespace indigo
     public:
         enum
         {
-            CLEAN_TIMER_MS = 2000
+            CLEAN_TIMER_MS = 2000,
+            INCREMENTAL_RADIUS = 3, // bonds from an edited atom that are relaxed
+            INCREMENTAL_SHELL = 2   // fixed bonds around the relaxed part
         };
         MoleculeCleaner2d(BaseMolecule& mol, bool use_biconnected_decompose);
         MoleculeCleaner2d(BaseMolecule& mol, bool use_biconnected_decompose, const Array<int>& selected_vertices);
         static void clean(BaseMolecule& mol);
+        // Relaxes only the neighbourhood of the edited atoms and keeps the rest
+        // of the molecule in place, so the cost does not depend on molecule size
+        static void cleanIncremental(BaseMolecule& mol, const Array<int>& dirty_vertices);
         void do_clean(bool _clean_external_angles);
 
     private:
@@ -104,6 +109,7 @@ namespace indigo
         } // complex multiplication of two complex numbers
 
         const float APPROX_STEP = 0.01;   // step of derivate approximation
+        const float CONVERGENCE_STEP = 1e-3; // minimal step relative to target_len that is worth another iteration
         const Vec2f ZERO = Vec2f(0., 0.); // complex zero
         const Vec2f ONE = Vec2f(1., 0.);  // complex one
     };
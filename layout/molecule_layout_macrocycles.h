@@ -123,6 +123,14 @@ namespace indigo
 
         void doLayout();
 
+        // Solves plain saturated rings of the given sizes in advance, so that
+        // later layouts of such rings are taken from the shared solution memo.
+        // The precomputed solutions are never evicted from the memo.
+        static void precomputeRings(int max_size);
+
+        // The solve time grows quickly with the ring size: about a second for 40 atoms
+        static const int MAX_PRECOMPUTED_RING_SIZE = 40;
+
         void addVertexOutsideWeight(int v, int weight);
         void setVertexEdgeParallel(int v, bool parallel);
         bool getVertexStereo(int v);
@@ -183,6 +191,8 @@ namespace indigo
 
         void calculate_rotate_length();
         void rotate_cycle(int shift);
+        void _getMemoKey(std::string& key);
+        void _doLatticeLayout();
         void _rotate_ar_i(Array<int>& ar, Array<int>& tmp, int shift);
         void _rotate_ar_d(Array<float>& ar, Array<float>& tmp, int shift);
         void _rotate_ar_v(Array<Vec2f>& ar, Array<Vec2f>& tmp, int shift);
@@ -18,7 +18,6 @@
 
 #include "layout/layout_pattern_smart.h"
 
-#include "base_cpp/os_sync_wrapper.h"
 #include "base_cpp/scanner.h"
 #include "graph/graph.h"
 #include "layout/molecule_layout_graph.h"
@@ -30,6 +29,7 @@
 #include "base_cpp/profiling.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "templates/layout_patterns.inc"
@@ -44,34 +44,94 @@ public:
     MoleculeLayoutGraphSmart layout_graph;
 };
 
-static vector<unique_ptr<PatternLayoutSmart>> _patterns;
-static OsLock _patterns_lock;
-
-bool PatternLayoutFinder::tryToFindPattern(MoleculeLayoutGraphSmart& layout_graph)
+namespace
 {
-    _initPatterns();
+    struct PatternLayoutKey
+    {
+        long morgan_code;
+        int vertex_count;
+        int edge_count;
 
-    layout_graph.calcMorganCode();
+        bool operator==(const PatternLayoutKey& other) const
+        {
+            return morgan_code == other.morgan_code && vertex_count == other.vertex_count && edge_count == other.edge_count;
+        }
+    };
 
-    for (auto& pattern : _patterns)
+    struct PatternLayoutKeyHash
     {
-        MoleculeLayoutGraphSmart& plg = pattern->layout_graph;
+        size_t operator()(const PatternLayoutKey& key) const
+        {
+            size_t h = hash<long>()(key.morgan_code);
+            h = h * 31 + key.vertex_count;
+            h = h * 31 + key.edge_count;
+            return h;
+        }
+    };
 
-        // Compare morgan code and graph size
-        if (plg.getMorganCode() != layout_graph.getMorganCode())
-            continue;
+    // Templates are loaded once and never modified afterwards, so they are
+    // shared between all threads without locking
+    class PatternLayoutIndex
+    {
+    public:
+        PatternLayoutIndex()
+        {
+            profTimerStart(t0, "layout.init-patterns");
 
-        if (plg.vertexCount() != layout_graph.vertexCount())
-            continue;
+            patterns.reserve(NELEM(layout_templates));
+            for (const char* tpl : layout_templates)
+            {
+                patterns.emplace_back(new PatternLayoutSmart);
+                auto& pattern = patterns.back();
 
-        if (plg.edgeCount() != layout_graph.edgeCount())
-            continue;
+                BufferScanner scanner(tpl);
+                MolfileLoader loader(scanner);
 
-        OsLocker locker(_patterns_lock);
+                loader.loadQueryMolecule(pattern->query_molecule);
+                pattern->layout_graph.makeOnGraph(pattern->query_molecule);
 
+                // Copy coordinates
+                QueryMolecule& qm = pattern->query_molecule;
+                for (int v = qm.vertexBegin(); v != qm.vertexEnd(); v = qm.vertexNext(v))
+                    pattern->layout_graph.getPos(v) = qm.getAtomXyz(v).projectZ();
+
+                MoleculeLayoutGraphSmart& plg = pattern->layout_graph;
+                plg.calcMorganCode();
+
+                PatternLayoutKey key = {plg.getMorganCode(), plg.vertexCount(), plg.edgeCount()};
+                index[key].push_back(pattern.get());
+            }
+        }
+
+        vector<unique_ptr<PatternLayoutSmart>> patterns;
+        unordered_map<PatternLayoutKey, vector<PatternLayoutSmart*>, PatternLayoutKeyHash> index;
+    };
+
+    const PatternLayoutIndex& getPatternLayoutIndex()
+    {
+        // Thread-safe initialization of the function-local static
+        static const PatternLayoutIndex instance;
+        return instance;
+    }
+} // namespace
+
+bool PatternLayoutFinder::tryToFindPattern(MoleculeLayoutGraphSmart& layout_graph)
+{
+    const PatternLayoutIndex& patterns = getPatternLayoutIndex();
+
+    layout_graph.calcMorganCode();
+
+    // Compare morgan code and graph size
+    PatternLayoutKey key = {layout_graph.getMorganCode(), layout_graph.vertexCount(), layout_graph.edgeCount()};
+    auto candidates = patterns.index.find(key);
+    if (candidates == patterns.index.end())
+        return false;
+
+    for (PatternLayoutSmart* pattern : candidates->second)
+    {
         profTimerStart(t0, "layout.find-pattern");
 
-        // Check if substructure matching found
+        // Check if substructure matching found. Matching only reads the pattern.
         EmbeddingEnumerator ee(layout_graph);
 
         ee.setSubgraph(pattern->query_molecule);
@@ -103,39 +163,6 @@ bool PatternLayoutFinder::tryToFindPattern(MoleculeLayoutGraphSmart& layout_grap
     return false;
 }
 
-void PatternLayoutFinder::_initPatterns()
-{
-    if (!_patterns.empty())
-        return;
-
-    OsLocker locker(_patterns_lock);
-
-    if (!_patterns.empty())
-        return;
-
-    profTimerStart(t0, "layout.init-patterns");
-
-    _patterns.reserve(NELEM(layout_templates));
-    for (const char* tpl : layout_templates)
-    {
-        _patterns.emplace_back(new PatternLayoutSmart);
-        auto& pattern = _patterns.back();
-
-        BufferScanner scanner(tpl);
-        MolfileLoader loader(scanner);
-
-        loader.loadQueryMolecule(pattern->query_molecule);
-        pattern->layout_graph.makeOnGraph(pattern->query_molecule);
-
-        // Copy coordinates
-        QueryMolecule& qm = pattern->query_molecule;
-        for (int v = qm.vertexBegin(); v != qm.vertexEnd(); v = qm.vertexNext(v))
-            pattern->layout_graph.getPos(v) = qm.getAtomXyz(v).projectZ();
-
-        pattern->layout_graph.calcMorganCode();
-    }
-}
-
 bool PatternLayoutFinder::_matchPatternBond(Graph& subgraph, Graph& supergraph, int sub_idx, int super_idx, void* userdata)
 {
     MoleculeLayoutGraphSmart& target = (MoleculeLayoutGraphSmart&)supergraph;
@@ -22,6 +22,7 @@
 #include "graph/biconnected_decomposer.h"
 #include "molecule/molecule.h"
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -868,6 +869,13 @@ void MoleculeCleaner2d::do_clean(bool _clean_external_angles)
             pos[base_point[i]] -= gradient[i] * mult[best_i];
         _updatePositions();
 
+        // The scaled gradient times the chosen multiplier is the length of the
+        // step just made. Once the line search cannot move the atoms noticeably
+        // (or cannot decrease the energy at all) further iterations only repeat
+        // the same step until the timeout.
+        if (len * factor * mult[best_i] < CONVERGENCE_STEP * target_len)
+            break;
+
         /*if (best_i == 0) {
             for (int i = 0; i < gradient.size(); i++) printf("%d: (%.5f, %.5f) \n", base_point[i], gradient[i].x, gradient[i].y);
             break;
@@ -1146,3 +1154,70 @@ void MoleculeCleaner2d::clean(BaseMolecule& mol)
     MoleculeCleaner2d cleaner2d2(mol, true);
     cleaner2d2.do_clean(true);
 }
+
+void MoleculeCleaner2d::cleanIncremental(BaseMolecule& mol, const Array<int>& dirty_vertices)
+{
+    const int max_dist = INCREMENTAL_RADIUS + INCREMENTAL_SHELL;
+
+    // Breadth-first search from the edited atoms; the queue ends up holding
+    // all the atoms of the neighbourhood
+    QS_DEF(Array<int>, dist);
+    QS_DEF(Array<int>, queue);
+    dist.clear_resize(mol.vertexEnd());
+    dist.fffill();
+    queue.clear();
+
+    for (int i = 0; i < dirty_vertices.size(); i++)
+    {
+        int v = dirty_vertices[i];
+        if (dist[v] == 0)
+            continue;
+        dist[v] = 0;
+        queue.push(v);
+    }
+
+    for (int q = 0; q < queue.size(); q++)
+    {
+        int v = queue[q];
+        if (dist[v] == max_dist)
+            continue;
+        const Vertex& vert = mol.getVertex(v);
+        for (int n = vert.neiBegin(); n != vert.neiEnd(); n = vert.neiNext(n))
+        {
+            int u = vert.neiVertex(n);
+            if (dist[u] < 0)
+            {
+                dist[u] = dist[v] + 1;
+                queue.push(u);
+            }
+        }
+    }
+
+    if (queue.size() == 0)
+        return;
+
+    // The cleaner is quadratic in the number of atoms, so it runs on a copy of
+    // the neighbourhood only. Atoms of the outer shell are not selected and keep
+    // the relaxed part attached to the rest of the molecule.
+    std::unique_ptr<BaseMolecule> local(mol.neu());
+    QS_DEF(Array<int>, mapping);
+    local->makeSubmolecule(mol, queue, &mapping,
+                           SKIP_CIS_TRANS | SKIP_STEREOCENTERS | SKIP_RGROUP_FRAGMENTS | SKIP_ATTACHMENT_POINTS | SKIP_TGROUPS | SKIP_TEMPLATE_ATTACHMENT_POINTS);
+
+    QS_DEF(Array<int>, selected);
+    selected.clear();
+    for (int i = 0; i < queue.size(); i++)
+        if (dist[queue[i]] <= INCREMENTAL_RADIUS)
+            selected.push(mapping[queue[i]]);
+
+    MoleculeCleaner2d cleaner2d1(*local, false, selected);
+    cleaner2d1.do_clean(false);
+    MoleculeCleaner2d cleaner2d2(*local, true, selected);
+    cleaner2d2.do_clean(true);
+
+    // Atoms on the border of the copy have bonds that were cut off, so their
+    // original positions are kept
+    for (int i = 0; i < queue.size(); i++)
+        if (dist[queue[i]] < max_dist)
+            mol.setAtomXyz(queue[i], local->getAtomXyz(mapping[queue[i]]));
+}
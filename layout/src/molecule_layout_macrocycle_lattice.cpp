@@ -18,6 +18,8 @@
 
 #include "layout/molecule_layout_macrocycles.h"
 
+#include "base_cpp/cancellation_handler.h"
+#include "base_cpp/os_sync_wrapper.h"
 #include "base_cpp/profiling.h"
 #include "layout/molecule_layout.h"
 #include <algorithm>
@@ -30,6 +32,7 @@
 #include <stack>
 #include <stdio.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -93,6 +96,108 @@ MoleculeLayoutMacrocyclesLattice::MoleculeLayoutMacrocyclesLattice(int size)
     _vertex_drawn.clear_resize(size);
 }
 
+namespace
+{
+    // Solved lattice layouts, keyed on all the constraints of a cycle. The result
+    // of the lattice search depends only on these constraints, so macrocycles
+    // that share ring size, substitution and cis/trans pattern are solved once.
+    // The memo is shared by all threads, as parallel layout runs each worker
+    // in its own session. The precomputed solutions are pinned: they are kept
+    // when the other ones are dropped.
+    class MacrocycleLatticeMemo
+    {
+    public:
+        bool find(const std::string& key, Array<Vec2f>& positions)
+        {
+            OsLocker locker(_lock);
+            auto it = _pinned.find(key);
+            if (it == _pinned.end())
+            {
+                it = _solutions.find(key);
+                if (it == _solutions.end())
+                    return false;
+            }
+            positions.copy(it->second.data(), (int)it->second.size());
+            return true;
+        }
+
+        bool isPinned(const std::string& key)
+        {
+            OsLocker locker(_lock);
+            return _pinned.find(key) != _pinned.end();
+        }
+
+        void pin(const std::string& key, const Array<Vec2f>& positions)
+        {
+            OsLocker locker(_lock);
+            _pinned[key].assign(positions.ptr(), positions.ptr() + positions.size());
+            _solutions.erase(key);
+        }
+
+        void add(const std::string& key, const Array<Vec2f>& positions)
+        {
+            OsLocker locker(_lock);
+            if (_solutions.size() >= MAX_SOLUTIONS)
+                _solutions.clear();
+            _solutions[key].assign(positions.ptr(), positions.ptr() + positions.size());
+        }
+
+    private:
+        static const size_t MAX_SOLUTIONS = 4096;
+
+        OsLock _lock;
+        std::unordered_map<std::string, std::vector<Vec2f>> _solutions;
+        std::unordered_map<std::string, std::vector<Vec2f>> _pinned;
+    };
+
+    MacrocycleLatticeMemo& getMacrocycleLatticeMemo()
+    {
+        static MacrocycleLatticeMemo memo;
+        return memo;
+    }
+} // namespace
+
+void MoleculeLayoutMacrocyclesLattice::precomputeRings(int max_size)
+{
+    if (max_size > MAX_PRECOMPUTED_RING_SIZE)
+        throw Error("can not precompute rings larger than %d atoms", MAX_PRECOMPUTED_RING_SIZE);
+
+    // Only one thread solves the missing rings, the others wait for them
+    static OsLock precompute_lock;
+    OsLocker locker(precompute_lock);
+
+    MacrocycleLatticeMemo& memo = getMacrocycleLatticeMemo();
+    std::string key;
+
+    // Smaller rings are laid out as regular polygons
+    for (int size = 10; size <= max_size; size++)
+    {
+        MoleculeLayoutMacrocyclesLattice layout(size);
+        for (int i = 0; i < size; i++)
+            layout.setVertexEdgeParallel(i, false);
+
+        layout._getMemoKey(key);
+        if (memo.isPinned(key))
+            continue;
+        if (!memo.find(key, layout._positions))
+            layout._doLatticeLayout();
+        memo.pin(key, layout._positions);
+    }
+}
+
+void MoleculeLayoutMacrocyclesLattice::_getMemoKey(std::string& key)
+{
+    key.clear();
+    key.append((const char*)&length, sizeof(length));
+    key.append((const char*)_vertex_weight.ptr(), length * sizeof(int));
+    key.append((const char*)_vertex_stereo.ptr(), length * sizeof(int));
+    key.append((const char*)_edge_stereo.ptr(), length * sizeof(int));
+    key.append((const char*)_component_finish.ptr(), length * sizeof(int));
+    key.append((const char*)_target_angle.ptr(), length * sizeof(float));
+    key.append((const char*)_angle_importance.ptr(), length * sizeof(float));
+    key.append((const char*)_vertex_added_square.ptr(), length * sizeof(float));
+}
+
 void MoleculeLayoutMacrocyclesLattice::doLayout()
 {
     if (length <= 9)
@@ -113,6 +218,23 @@ void MoleculeLayoutMacrocyclesLattice::doLayout()
             return;
         }
     }
+
+    std::string key;
+    _getMemoKey(key);
+
+    MacrocycleLatticeMemo& memo = getMacrocycleLatticeMemo();
+    if (memo.find(key, _positions))
+    {
+        profIncCounter("layout.macrocycle-memo-hits", 1);
+        return;
+    }
+
+    _doLatticeLayout();
+    memo.add(key, _positions);
+}
+
+void MoleculeLayoutMacrocyclesLattice::_doLatticeLayout()
+{
     calculate_rotate_length();
 
     rotate_cycle(rotate_length);
@@ -153,8 +275,12 @@ void MoleculeLayoutMacrocyclesLattice::doLayout()
 
     Array<answer_point> path;
     path.clear_resize(length + 1);
+    CancellationHandler* cancellation = getCancellationHandler();
     for (int i = 0; i < 100 && i < points.size(); i++)
     {
+        if (cancellation != nullptr && cancellation->isCancelled())
+            throw Error("Macrocycle layout has been cancelled: %s", cancellation->cancelledRequestMessage());
+
         answfld._restore_path(path.ptr(), points[i]);
         cl.init(path.ptr());
         smoothing(cl);
@@ -687,8 +813,12 @@ void AnswerField::fill()
     // getLattice(0, 0, 0).getCell(0, 0) = 0;
     getLattice(0, 0, 1).getCell(0, 0) = 0;
 
+    CancellationHandler* cancellation = getCancellationHandler();
     for (int l = 0; l < length; l++)
     {
+        if (cancellation != nullptr && cancellation->isCancelled())
+            throw Error("Macrocycle layout has been cancelled: %s", cancellation->cancelledRequestMessage());
+
         for (int rot = -l; rot <= l; rot++)
         {
             for (int p = 0; p < 2; p++)
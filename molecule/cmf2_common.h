@@ -0,0 +1,78 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __cmf2_common__
+#define __cmf2_common__
+
+namespace indigo
+{
+
+    /* Binary molecule format constants (CMF version 2) */
+    enum
+    {
+        /* The header starts with CMF2_MAGIC and the version, which is below
+           0x80. CMF2_MAGIC is never a CMF symbol, so the formats can be
+           told apart by the first byte. */
+        CMF2_MAGIC = 0xFF,
+        CMF2_VERSION = 2,
+        CMF2_PREFIX_SIZE = 2,
+
+        /* Header flags */
+        CMF2_HAS_XYZ = 1,
+
+        /* Sections in the order of the header offsets. A reader skips
+           the sections it does not know. */
+        CMF2_SECTION_TOPOLOGY = 0,
+        CMF2_SECTION_CHARGES,
+        CMF2_SECTION_STEREO,
+        CMF2_SECTION_XYZ,
+        CMF2_SECTION_SGROUPS,
+        CMF2_NUM_OF_SECTIONS,
+
+        /* Atom codes of the topology section besides the element numbers */
+        CMF2_ATOM_PSEUDO = 0,
+        CMF2_ATOM_RSITE = 255,
+
+        /* Bond bits of the topology section: the lowest 3 bits are the order.
+           A bond usually adds a new atom, the one after the atoms of
+           the previous bonds, and only the distance to the other end is
+           kept above the bits. Otherwise CMF2_BOND_CLOSURE is set and both
+           ends are written. */
+        CMF2_BOND_ORDER_MASK = 7,
+        CMF2_BOND_RING = 8,
+        CMF2_BOND_CLOSURE = 16,
+        CMF2_BOND_SWAP = 32,
+        CMF2_BOND_SHIFT = 6,
+
+        /* Rare bond properties of the topology section */
+        CMF2_BOND_DIR_MASK = 3,
+        CMF2_BOND_HIGHLIGHTED = 4,
+
+        /* Atom properties of the charges section */
+        CMF2_PROP_CHARGE = 1,
+        CMF2_PROP_ISOTOPE = 2,
+        CMF2_PROP_RADICAL = 4,
+        CMF2_PROP_VALENCE = 8,
+
+        /* Cis-trans parity of an ignored double bond */
+        CMF2_CIS_TRANS_IGNORED = 0
+    };
+
+} // namespace indigo
+
+#endif
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __cmf2_loader_h__
+#define __cmf2_loader_h__
+
+#include "base_cpp/array.h"
+#include "base_cpp/exception.h"
+#include "molecule/cmf2_common.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+namespace indigo
+{
+
+    class Molecule;
+    class Scanner;
+    class SGroup;
+
+    // Loads a molecule saved by Cmf2Saver. The header is read by the
+    // constructor, so the atom and bond counts are available without
+    // decoding, and the skipped sections are not decoded at all.
+    class DLLEXPORT Cmf2Loader
+    {
+    public:
+        // Returns true if the data starts with the CMF2 prefix of any version
+        static bool checkVersion(const char* data, int size);
+
+        // The data should stay valid while the loader is used
+        explicit Cmf2Loader(const char* data, int size);
+        // Reads the rest of the scanner
+        explicit Cmf2Loader(Scanner& scanner);
+
+        int countAtoms() const;
+        int countBonds() const;
+        bool hasXyz() const;
+
+        void loadMolecule(Molecule& mol);
+
+        bool skip_cistrans;
+        bool skip_stereocenters;
+        bool skip_valence;
+        bool skip_xyz;
+        bool skip_sgroups;
+
+        DECL_ERROR;
+
+    protected:
+        void _init(const char* data, int size);
+        void _startSection(int section);
+
+        inline byte _readByte()
+        {
+            if (_cur == _end)
+                throw Error("unexpected end of the section");
+            return *_cur++;
+        }
+
+        unsigned int _readPackedUInt();
+        int _readPackedInt();
+        int _readIndex(int count);
+        float _readFloat();
+        word _readWord();
+        void _readString(Array<char>& str);
+        void _readIndices(Array<int>& indices, int count);
+
+        void _readCharges();
+        void _readTopology(Molecule& mol);
+        void _readStereo(Molecule& mol);
+        void _readXyz(Molecule& mol);
+        void _readSGroups(Molecule& mol, bool have_xyz);
+        void _readSGroupXyz(SGroup& sgroup);
+
+        Array<char> _buf;
+        const byte* _data;
+        int _size;
+
+        int _flags;
+        int _atom_count;
+        int _bond_count;
+        int _section_offsets[CMF2_NUM_OF_SECTIONS];
+        int _section_sizes[CMF2_NUM_OF_SECTIONS];
+
+        // Current section
+        const byte* _cur;
+        const byte* _end;
+
+        // Atom properties of the charges section
+        Array<int> _props;
+        Array<int> _charges;
+        Array<int> _isotopes;
+        Array<int> _radicals;
+        Array<int> _valences;
+
+    private:
+        Cmf2Loader(const Cmf2Loader&); // no implicit copy
+    };
+
+} // namespace indigo
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif /* __cmf2_loader_h__ */
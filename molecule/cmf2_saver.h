@@ -0,0 +1,87 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __cmf2_saver_h__
+#define __cmf2_saver_h__
+
+#include "base_cpp/array.h"
+#include "base_cpp/exception.h"
+#include "molecule/cmf2_common.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+namespace indigo
+{
+
+    class Molecule;
+    class Output;
+
+    // Saves a molecule in the binary format of CMF version 2. Unlike CMF it
+    // does not depend on an LZW dictionary, keeps the atom and bond order,
+    // and is split into sections that can be skipped without decoding:
+    //
+    //   prefix    CMF2_MAGIC CMF2_VERSION
+    //   header    flags, atom count, bond count, section count and
+    //             the length of every section (all packed)
+    //   sections  topology, charges/isotopes, stereo, coordinates, S-groups
+    //
+    // The integers are written with Output::writePackedUInt().
+    class DLLEXPORT Cmf2Saver
+    {
+    public:
+        explicit Cmf2Saver(Output& output);
+
+        void saveMolecule(Molecule& mol);
+
+        bool save_xyz;
+        bool save_bond_dirs;
+        bool save_highlighting;
+
+        DECL_ERROR;
+
+    protected:
+        void _writeTopology(Molecule& mol, Output& output);
+        void _writeCharges(Molecule& mol, Output& output);
+        void _writeStereo(Molecule& mol, Output& output);
+        void _writeXyz(Molecule& mol, Output& output);
+        void _writeSGroups(Molecule& mol, Output& output);
+
+        void _writeString(Output& output, const Array<char>& str);
+        void _writeIndices(Output& output, const Array<int>& data, const Array<int>& mapping);
+
+        Output& _output;
+
+        // Molecule indices to the saved ones, which have no gaps
+        Array<int> _atom_mapping;
+        Array<int> _bond_mapping;
+        Array<char> _sections[CMF2_NUM_OF_SECTIONS];
+
+    private:
+        Cmf2Saver(const Cmf2Saver&); // no implicit copy
+    };
+
+} // namespace indigo
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif /* __cmf2_saver_h__ */
@@ -49,6 +49,11 @@ namespace indigo
         // no dictionary, no decoder
         explicit CmfLoader(Scanner& scanner);
 
+        // The same for a memory block: the symbols are read without
+        // the virtual scanner calls
+        explicit CmfLoader(LzwDict& dict, const char* data, int size);
+        explicit CmfLoader(const char* data, int size);
+
         ~CmfLoader();
 
         void loadMolecule(Molecule& mol);
@@ -57,6 +62,9 @@ namespace indigo
         bool skip_cistrans;
         bool skip_stereocenters;
         bool skip_valence;
+        // S-groups are read through but not added to the molecule, and
+        // loadXyz() does not read their coordinates
+        bool skip_sgroups;
 
         int version; // By default the latest version 2 is used
 
@@ -146,6 +154,11 @@ namespace indigo
         Obj<LzwDecoder> _decoder_obj;
         LzwDecoder* _ext_decoder;
         Obj<LzwScanner> _lzw_scanner;
+        Obj<BufferScanner> _buffer_scanner;
+
+        // Symbols source for _getNextCode() bypassing _scanner
+        LzwDecoder* _decoder;
+        BufferScanner* _buffer;
 
         TL_CP_DECL(Array<_AtomDesc>, _atoms);
         TL_CP_DECL(Array<_BondDesc>, _bonds);
@@ -93,6 +93,8 @@ namespace indigo
 
         static void clone(QueryMolecule& mol, Molecule& other);
         static void makeEdgeSubmolecule(QueryMolecule& mol, Molecule& other, Array<int>& v_list, Array<int>& e_list);
+        // converts a scaffold back to a molecule with the same atom numbers and bond orders
+        static void makeMolecule(Molecule& mol, QueryMolecule& scaffold);
 
         static bool matchBonds(Graph& g1, Graph& g2, int i, int j, void* userdata);
         static bool matchAtoms(Graph& g1, Graph& g2, const int* core_sub, int i, int j, void* userdata);
@@ -23,6 +23,7 @@
 #include "molecule/molecule.h"
 #include "molecule/molecule_layered_molecules.h"
 #include "molecule/molecule_tautomer.h"
+#include "reaction/query_reaction.h"
 
 #define USE_DEPRECATED_INCHI
 
@@ -81,6 +82,75 @@ namespace indigo
         bool _complete;
         int aromatizedRange[2];
         RedBlackSet<unsigned> _enumeratedHistory;
+
+        friend class TautomerStreamEnumerator;
+    };
+
+    // Breadth-first tautomer enumeration with bounded memory.
+    // Unlike TautomerEnumerator, the tautomers are not stored as layers: only the
+    // tautomers that are not expanded yet are kept (as bond orders and hydrogen
+    // counts), and the ones that were seen already are remembered by a 64-bit hash.
+    // When the queue of pending tautomers or the set of seen ones is full, the newly
+    // found tautomers are dropped and isTruncated() returns true. It also returns true
+    // if next() stopped at max_tautomers with pending tautomers left. Only the RSMARTS
+    // rules are supported.
+    class DLLEXPORT TautomerStreamEnumerator
+    {
+    public:
+        DECL_ERROR;
+
+        TautomerStreamEnumerator(Molecule& molecule);
+        ~TautomerStreamEnumerator();
+
+        // Maximum number of pending tautomers in the queue (0 means no limit)
+        int max_queue;
+        // Maximum number of tautomers to return (0 means no limit)
+        int max_tautomers;
+        // Maximum number of distinct tautomers to remember (0 means no limit).
+        // When it is reached, the newly found tautomers are dropped.
+        int max_seen;
+        // Return aromatized tautomers and skip the ones that have the same aromatic form
+        bool aromatized;
+        AromaticityOptions arom_options;
+
+        // Constructs the next tautomer; returns false when the enumeration is over
+        bool next(Molecule& tautomer);
+        bool isTruncated() const;
+        int count() const;
+
+        // Picks a deterministic representative of the remaining tautomers: the aromatized
+        // tautomer with the minimal canonical SMILES. Only the current candidate is kept
+        // in memory. Returns a 64-bit hash of the canonical SMILES. Throws if the
+        // enumeration is truncated: the result is tautomer-invariant only when all
+        // the tautomers are enumerated.
+        qword getCanonicalTautomer(Molecule& result, Array<char>& canonical_smiles);
+
+    protected:
+        static void _product_proc(Molecule& product, Array<int>& monomers_indices, Array<int>& mapping, void* userdata);
+        static qword _hashOrders(const char* orders, int length);
+
+        void _construct(Molecule& molecule, const char* orders) const;
+        void _expand(const char* orders);
+        void _enqueue(const char* orders);
+        void _compact();
+
+        Molecule _proto;
+        int _stride;
+        ObjArray<QueryReaction> _rules;
+
+        // Bond orders of the queued tautomers, _stride bytes each.
+        // Tautomers before _head are expanded already, before _emitted are returned already.
+        Array<char> _queue;
+        int _head;
+        int _emitted;
+        Array<char> _product_orders;
+        // The tautomer being expanded
+        const char* _expanded;
+
+        RedBlackSet<qword> _seen;
+        RedBlackSet<qword> _seen_aromatized;
+        int _count;
+        bool _truncated;
     };
 
 } // namespace indigo
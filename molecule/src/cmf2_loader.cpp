@@ -0,0 +1,603 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "molecule/cmf2_loader.h"
+
+#include "base_cpp/scanner.h"
+#include "molecule/elements.h"
+#include "molecule/molecule.h"
+#include "molecule/molecule_allene_stereo.h"
+#include "molecule/molecule_cis_trans.h"
+#include "molecule/molecule_stereocenters.h"
+
+using namespace indigo;
+
+IMPL_ERROR(Cmf2Loader, "CMF2 loader");
+
+bool Cmf2Loader::checkVersion(const char* data, int size)
+{
+    return size >= CMF2_PREFIX_SIZE && (byte)data[0] == CMF2_MAGIC && (byte)data[1] >= CMF2_VERSION && (byte)data[1] < 0x80;
+}
+
+Cmf2Loader::Cmf2Loader(const char* data, int size)
+{
+    _init(data, size);
+}
+
+Cmf2Loader::Cmf2Loader(Scanner& scanner)
+{
+    scanner.readAll(_buf);
+    _init(_buf.ptr(), _buf.size());
+}
+
+void Cmf2Loader::_init(const char* data, int size)
+{
+    int i;
+
+    skip_cistrans = false;
+    skip_stereocenters = false;
+    skip_valence = false;
+    skip_xyz = false;
+    skip_sgroups = false;
+
+    if (!checkVersion(data, size))
+        throw Error("not a CMF2 data");
+    if ((byte)data[1] != CMF2_VERSION)
+        throw Error("unsupported version %d", (int)(byte)data[1]);
+
+    _data = (const byte*)data;
+    _size = size;
+    _cur = _data + CMF2_PREFIX_SIZE;
+    _end = _data + size;
+
+    _flags = _readPackedUInt();
+    _atom_count = _readPackedUInt();
+    _bond_count = _readPackedUInt();
+
+    int sections = _readPackedUInt();
+    int offset = 0;
+
+    // A reader of this version ignores the sections added after it
+    for (i = 0; i < sections; i++)
+    {
+        int section_size = _readPackedUInt();
+
+        if (section_size < 0 || section_size > size)
+            throw Error("bad section size %d", section_size);
+
+        if (i < CMF2_NUM_OF_SECTIONS)
+        {
+            _section_offsets[i] = offset;
+            _section_sizes[i] = section_size;
+        }
+        offset += section_size;
+        if (offset > size)
+            throw Error("sections exceed the data size");
+    }
+    for (; i < CMF2_NUM_OF_SECTIONS; i++)
+    {
+        _section_offsets[i] = offset;
+        _section_sizes[i] = 0;
+    }
+
+    int header_size = (int)(_cur - _data);
+
+    if (header_size + offset > size)
+        throw Error("sections exceed the data size");
+    if (_atom_count < 0 || _atom_count > _section_sizes[CMF2_SECTION_TOPOLOGY] || _bond_count < 0 ||
+        _bond_count > _section_sizes[CMF2_SECTION_TOPOLOGY])
+        throw Error("bad atom or bond count");
+
+    for (i = 0; i < CMF2_NUM_OF_SECTIONS; i++)
+        _section_offsets[i] += header_size;
+}
+
+int Cmf2Loader::countAtoms() const
+{
+    return _atom_count;
+}
+
+int Cmf2Loader::countBonds() const
+{
+    return _bond_count;
+}
+
+bool Cmf2Loader::hasXyz() const
+{
+    return (_flags & CMF2_HAS_XYZ) != 0;
+}
+
+void Cmf2Loader::_startSection(int section)
+{
+    _cur = _data + _section_offsets[section];
+    _end = _cur + _section_sizes[section];
+}
+
+unsigned int Cmf2Loader::_readPackedUInt()
+{
+    unsigned int value = 0;
+    int shift = 0;
+
+    while (true)
+    {
+        byte cur = _readByte();
+        value |= (cur & 0x7F) << shift;
+
+        if (!(cur & 0x80))
+            return value;
+        shift += 7;
+        if (shift > 28)
+            throw Error("bad packed integer");
+    }
+}
+
+int Cmf2Loader::_readPackedInt()
+{
+    unsigned int value = _readPackedUInt();
+
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+int Cmf2Loader::_readIndex(int count)
+{
+    unsigned int value = _readPackedUInt();
+
+    if (value >= (unsigned int)count)
+        throw Error("index %u is out of range", value);
+    return (int)value;
+}
+
+float Cmf2Loader::_readFloat()
+{
+    float value;
+
+    if (_end - _cur < (int)sizeof(float))
+        throw Error("unexpected end of the section");
+    memcpy(&value, _cur, sizeof(float));
+    _cur += sizeof(float);
+    return value;
+}
+
+word Cmf2Loader::_readWord()
+{
+    word value;
+
+    if (_end - _cur < (int)sizeof(word))
+        throw Error("unexpected end of the section");
+    memcpy(&value, _cur, sizeof(word));
+    _cur += sizeof(word);
+    return value;
+}
+
+void Cmf2Loader::_readString(Array<char>& str)
+{
+    unsigned int len = _readPackedUInt();
+
+    if (len > (unsigned int)(_end - _cur))
+        throw Error("unexpected end of the section");
+    str.resize(len + 1);
+    memcpy(str.ptr(), _cur, len);
+    str[len] = 0;
+    _cur += len;
+}
+
+void Cmf2Loader::_readIndices(Array<int>& indices, int count)
+{
+    unsigned int len = _readPackedUInt();
+
+    if (len > (unsigned int)(_end - _cur))
+        throw Error("unexpected end of the section");
+    indices.clear_resize(len);
+    for (unsigned int i = 0; i < len; i++)
+        indices[i] = _readIndex(count);
+}
+
+void Cmf2Loader::loadMolecule(Molecule& mol)
+{
+    int i;
+
+    mol.clear();
+
+    // Charges go first: setting a charge drops the implicit hydrogens
+    _readCharges();
+    _readTopology(mol);
+
+    if (!skip_valence)
+    {
+        for (i = 0; i < _atom_count; i++)
+            if (_props[i] & CMF2_PROP_VALENCE)
+                mol.setValence(i, _valences[i]);
+    }
+
+    if (!skip_cistrans || !skip_stereocenters)
+        _readStereo(mol);
+
+    if (!skip_xyz && hasXyz())
+        _readXyz(mol);
+
+    if (!skip_sgroups && _section_sizes[CMF2_SECTION_SGROUPS] > 0)
+        _readSGroups(mol, hasXyz());
+}
+
+void Cmf2Loader::_readCharges()
+{
+    _props.clear_resize(_atom_count);
+    _props.zerofill();
+    _charges.clear_resize(_atom_count);
+    _isotopes.clear_resize(_atom_count);
+    _radicals.clear_resize(_atom_count);
+    _valences.clear_resize(_atom_count);
+
+    _startSection(CMF2_SECTION_CHARGES);
+
+    if (_cur == _end)
+        return;
+
+    int count = _readPackedUInt();
+
+    for (int i = 0; i < count; i++)
+    {
+        int idx = _readIndex(_atom_count);
+        int props = _readByte();
+
+        _props[idx] = props;
+        if (props & CMF2_PROP_CHARGE)
+            _charges[idx] = _readPackedInt();
+        if (props & CMF2_PROP_ISOTOPE)
+            _isotopes[idx] = _readPackedUInt();
+        if (props & CMF2_PROP_RADICAL)
+            _radicals[idx] = _readByte();
+        if (props & CMF2_PROP_VALENCE)
+            _valences[idx] = _readPackedUInt();
+    }
+}
+
+void Cmf2Loader::_readTopology(Molecule& mol)
+{
+    QS_DEF(Array<char>, label);
+    int i, j;
+
+    _startSection(CMF2_SECTION_TOPOLOGY);
+
+    for (i = 0; i < _atom_count; i++)
+    {
+        int code = _readPackedUInt();
+        int idx;
+
+        if ((code >> 1) == CMF2_ATOM_PSEUDO)
+        {
+            _readString(label);
+            if (label.size() < 2)
+                throw Error("empty pseudo-atom");
+            idx = mol.addAtom(ELEM_PSEUDO);
+            mol.setPseudoAtom(idx, label.ptr());
+        }
+        else if ((code >> 1) == CMF2_ATOM_RSITE)
+        {
+            int bits = _readPackedUInt();
+
+            idx = mol.addAtom(ELEM_RSITE);
+            if (bits > 0)
+                mol.setRSiteBits(idx, bits);
+        }
+        else if ((code >> 1) < ELEM_MAX)
+            idx = mol.addAtom(code >> 1);
+        else
+            throw Error("bad atom number: %d", code >> 1);
+
+        int props = _props[idx];
+        int extra = (code & 1) ? _readPackedUInt() : 0;
+
+        if (props & CMF2_PROP_CHARGE)
+            mol.setAtomCharge(idx, _charges[idx]);
+        if (props & CMF2_PROP_ISOTOPE)
+            mol.setAtomIsotope(idx, _isotopes[idx]);
+        if ((extra >> 1) > 0)
+            mol.setImplicitH(idx, (extra >> 1) - 1);
+        if (props & CMF2_PROP_RADICAL)
+            mol.setAtomRadical(idx, _radicals[idx]);
+        if (extra & 1)
+            mol.highlightAtom(idx);
+    }
+
+    int last = 0;
+
+    for (i = 0; i < _bond_count; i++)
+    {
+        unsigned int bits = _readPackedUInt();
+        int order = bits & CMF2_BOND_ORDER_MASK;
+        int end = last + 1;
+
+        if (order > BOND_AROMATIC)
+            throw Error("bad bond order: %d", order);
+        if (bits & CMF2_BOND_CLOSURE)
+            end = last - _readPackedInt();
+
+        int beg = end - (int)(bits >> CMF2_BOND_SHIFT) - 1;
+
+        if (beg < 0 || end >= _atom_count)
+            throw Error("bad bond %d-%d", beg, end);
+        if (end > last)
+            last = end;
+
+        int idx = (bits & CMF2_BOND_SWAP) ? mol.addBond_Silent(end, beg, order) : mol.addBond_Silent(beg, end, order);
+
+        mol.setEdgeTopology(idx, (bits & CMF2_BOND_RING) ? TOPOLOGY_RING : TOPOLOGY_CHAIN);
+    }
+
+    mol.validateEdgeTopologies();
+
+    // The rare properties follow only if there are any
+    if (_cur == _end)
+        return;
+
+    int count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int bond = _readIndex(_bond_count);
+        int bits = _readByte();
+
+        if (bits & CMF2_BOND_DIR_MASK)
+            mol.setBondDirection(bond, bits & CMF2_BOND_DIR_MASK);
+        if (bits & CMF2_BOND_HIGHLIGHTED)
+            mol.highlightBond(bond);
+    }
+
+    count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int atom = _readIndex(_atom_count);
+        int order = _readPackedUInt();
+
+        mol.addAttachmentPoint(order, atom);
+    }
+
+    count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int atom = _readIndex(_atom_count);
+        int n = _readPackedUInt();
+
+        for (j = 0; j < n; j++)
+            mol.setRSiteAttachmentOrder(atom, _readIndex(_atom_count), j);
+    }
+}
+
+void Cmf2Loader::_readStereo(Molecule& mol)
+{
+    int i, count;
+
+    _startSection(CMF2_SECTION_STEREO);
+
+    if (_cur == _end)
+        return;
+
+    count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int atom = _readIndex(_atom_count);
+        int packed = _readPackedUInt();
+
+        if (!skip_stereocenters)
+            mol.stereocenters.add(atom, (packed & 3) + 1, packed >> 3, (packed & 4) != 0);
+    }
+
+    count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int bond = _readIndex(_bond_count);
+        int parity = _readByte();
+
+        if (skip_cistrans)
+            continue;
+
+        if (parity != CMF2_CIS_TRANS_IGNORED)
+            mol.cis_trans.setParity(bond, parity);
+        else
+            mol.cis_trans.ignore(bond);
+        mol.cis_trans.restoreSubstituents(bond);
+    }
+
+    count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int atom = _readIndex(_atom_count);
+        int parity = _readByte();
+        int left, right, subst[4], tmp;
+        bool pure_h[4];
+
+        if (!MoleculeAlleneStereo::possibleCenter(mol, atom, left, right, subst, pure_h))
+            throw Error("invalid molecule allene stereo marker");
+
+        if (subst[1] != -1 && subst[1] < subst[0])
+            __swap(subst[1], subst[0], tmp);
+        if (subst[3] != -1 && subst[3] < subst[2])
+            __swap(subst[3], subst[2], tmp);
+
+        if (pure_h[0])
+        {
+            __swap(subst[1], subst[0], tmp);
+            parity = 3 - parity;
+        }
+        if (pure_h[2])
+        {
+            __swap(subst[2], subst[3], tmp);
+            parity = 3 - parity;
+        }
+
+        mol.allene_stereo.add(atom, left, right, subst, parity);
+    }
+}
+
+void Cmf2Loader::_readXyz(Molecule& mol)
+{
+    Vec3f xyz_min, range;
+
+    _startSection(CMF2_SECTION_XYZ);
+
+    xyz_min.x = _readFloat();
+    xyz_min.y = _readFloat();
+    xyz_min.z = _readFloat();
+    range.x = _readFloat();
+    range.y = _readFloat();
+    range.z = _readFloat();
+
+    bool have_z = _readByte() != 0;
+
+    for (int i = 0; i < _atom_count; i++)
+    {
+        float x = xyz_min.x + ((float)_readWord() / 65535) * range.x;
+        float y = xyz_min.y + ((float)_readWord() / 65535) * range.y;
+        float z = have_z ? xyz_min.z + ((float)_readWord() / 65535) * range.z : 0;
+
+        mol.setAtomXyz(i, x, y, z);
+    }
+
+    mol.have_xyz = true;
+}
+
+void Cmf2Loader::_readSGroups(Molecule& mol, bool have_xyz)
+{
+    int i, j;
+
+    _startSection(CMF2_SECTION_SGROUPS);
+
+    int count = _readPackedUInt();
+
+    for (i = 0; i < count; i++)
+    {
+        int type = _readPackedUInt();
+
+        if (type > SGroup::SG_TYPE_ANY)
+            throw Error("bad S-group type: %d", type);
+
+        SGroup& sg = mol.sgroups.getSGroup(mol.sgroups.addSGroup(type));
+
+        sg.sgroup_subtype = _readPackedUInt();
+        sg.brk_style = _readPackedInt();
+        _readIndices(sg.atoms, _atom_count);
+        _readIndices(sg.bonds, _bond_count);
+
+        if (type == SGroup::SG_TYPE_DAT)
+        {
+            DataSGroup& sd = (DataSGroup&)sg;
+
+            _readString(sd.description);
+            _readString(sd.name);
+            _readString(sd.type);
+            _readString(sd.querycode);
+            _readString(sd.queryoper);
+            _readString(sd.data);
+
+            int bits = _readByte();
+
+            sd.detached = (bits & 1) != 0;
+            sd.relative = (bits & 2) != 0;
+            sd.display_units = (bits & 4) != 0;
+            sd.num_chars = _readPackedInt();
+            sd.dasp_pos = _readPackedInt();
+            sd.tag = (char)_readByte();
+        }
+        else if (type == SGroup::SG_TYPE_SUP)
+        {
+            Superatom& sa = (Superatom&)sg;
+
+            _readString(sa.subscript);
+            _readString(sa.sa_class);
+            sa.contracted = _readPackedInt();
+
+            int n = _readPackedUInt();
+
+            for (j = 0; j < n; j++)
+            {
+                Superatom::_AttachmentPoint& ap = sa.attachment_points.at(sa.attachment_points.add());
+
+                ap.aidx = _readIndex(_atom_count + 1) - 1;
+                ap.lvidx = _readIndex(_atom_count + 1) - 1;
+                _readString(ap.apid);
+            }
+
+            n = _readPackedUInt();
+            if (n > _end - _cur)
+                throw Error("unexpected end of the section");
+            sa.bond_connections.clear_resize(n);
+            for (j = 0; j < n; j++)
+            {
+                sa.bond_connections[j].bond_idx = _readIndex(_bond_count + 1) - 1;
+                sa.bond_connections[j].bond_dir.set(0, 0);
+            }
+        }
+        else if (type == SGroup::SG_TYPE_SRU)
+        {
+            RepeatingUnit& su = (RepeatingUnit&)sg;
+
+            _readString(su.subscript);
+            su.connectivity = _readPackedInt();
+        }
+        else if (type == SGroup::SG_TYPE_MUL)
+        {
+            MultipleGroup& sm = (MultipleGroup&)sg;
+
+            _readIndices(sm.parent_atoms, _atom_count);
+            sm.multiplier = _readPackedInt();
+        }
+
+        if (have_xyz)
+            _readSGroupXyz(sg);
+    }
+}
+
+void Cmf2Loader::_readSGroupXyz(SGroup& sg)
+{
+    int j, n = _readPackedUInt();
+
+    if (n > _end - _cur)
+        throw Error("unexpected end of the section");
+    sg.brackets.clear_resize(n);
+    for (j = 0; j < n; j++)
+    {
+        sg.brackets[j][0].x = _readFloat();
+        sg.brackets[j][0].y = _readFloat();
+        sg.brackets[j][1].x = _readFloat();
+        sg.brackets[j][1].y = _readFloat();
+    }
+
+    if (sg.sgroup_type == SGroup::SG_TYPE_DAT)
+    {
+        DataSGroup& sd = (DataSGroup&)sg;
+
+        sd.display_pos.x = _readFloat();
+        sd.display_pos.y = _readFloat();
+    }
+    else if (sg.sgroup_type == SGroup::SG_TYPE_SUP)
+    {
+        Superatom& sa = (Superatom&)sg;
+
+        for (j = 0; j < sa.bond_connections.size(); j++)
+        {
+            sa.bond_connections[j].bond_dir.x = _readFloat();
+            sa.bond_connections[j].bond_dir.y = _readFloat();
+        }
+    }
+}
@@ -0,0 +1,562 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "molecule/cmf2_saver.h"
+
+#include "base_cpp/output.h"
+#include "molecule/elements.h"
+#include "molecule/molecule.h"
+#include "molecule/molecule_cis_trans.h"
+#include "molecule/molecule_stereocenters.h"
+
+using namespace indigo;
+
+IMPL_ERROR(Cmf2Saver, "CMF2 saver");
+
+Cmf2Saver::Cmf2Saver(Output& output) : _output(output)
+{
+    save_xyz = false;
+    save_bond_dirs = false;
+    save_highlighting = false;
+}
+
+static unsigned int _zigzag(int value)
+{
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+void Cmf2Saver::saveMolecule(Molecule& mol)
+{
+    int i;
+
+    _atom_mapping.clear_resize(mol.vertexEnd());
+    _atom_mapping.fffill();
+    _bond_mapping.clear_resize(mol.edgeEnd());
+    _bond_mapping.fffill();
+
+    int atom_count = 0, bond_count = 0;
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+        _atom_mapping[i] = atom_count++;
+    for (i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+        _bond_mapping[i] = bond_count++;
+
+    bool have_xyz = save_xyz && mol.have_xyz;
+
+    for (i = 0; i < CMF2_NUM_OF_SECTIONS; i++)
+        _sections[i].clear();
+
+    {
+        ArrayOutput out(_sections[CMF2_SECTION_TOPOLOGY]);
+        _writeTopology(mol, out);
+    }
+    {
+        ArrayOutput out(_sections[CMF2_SECTION_CHARGES]);
+        _writeCharges(mol, out);
+    }
+    {
+        ArrayOutput out(_sections[CMF2_SECTION_STEREO]);
+        _writeStereo(mol, out);
+    }
+    if (have_xyz)
+    {
+        ArrayOutput out(_sections[CMF2_SECTION_XYZ]);
+        _writeXyz(mol, out);
+    }
+    if (mol.sgroups.getSGroupCount() > 0)
+    {
+        ArrayOutput out(_sections[CMF2_SECTION_SGROUPS]);
+        _writeSGroups(mol, out);
+    }
+
+    _output.writeByte(CMF2_MAGIC);
+    _output.writeByte(CMF2_VERSION);
+
+    _output.writePackedUInt(have_xyz ? CMF2_HAS_XYZ : 0);
+    _output.writePackedUInt(atom_count);
+    _output.writePackedUInt(bond_count);
+
+    // The trailing empty sections are not listed
+    int sections = CMF2_NUM_OF_SECTIONS;
+
+    while (sections > 0 && _sections[sections - 1].size() == 0)
+        sections--;
+
+    _output.writePackedUInt(sections);
+    for (i = 0; i < sections; i++)
+        _output.writePackedUInt(_sections[i].size());
+    for (i = 0; i < sections; i++)
+        _output.write(_sections[i].ptr(), _sections[i].size());
+}
+
+void Cmf2Saver::_writeTopology(Molecule& mol, Output& output)
+{
+    int i, j;
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+    {
+        // Implicit hydrogens plus one, zero if they are not saved
+        int hydrogens = 0;
+
+        if (!mol.isPseudoAtom(i) && !mol.isRSite(i) && Molecule::shouldWriteHCount(mol, i))
+        {
+            try
+            {
+                hydrogens = mol.getImplicitH(i) + 1;
+            }
+            catch (Element::Error&)
+            {
+            }
+        }
+
+        int highlighted = (save_highlighting && mol.isAtomHighlighted(i)) ? 1 : 0;
+        int extra = (hydrogens != 0 || highlighted != 0) ? 1 : 0;
+
+        if (mol.isPseudoAtom(i))
+        {
+            const char* str = mol.getPseudoAtom(i);
+            int len = (int)strlen(str);
+
+            if (len < 1)
+                throw Error("empty pseudo-atom");
+
+            output.writePackedUInt((CMF2_ATOM_PSEUDO << 1) | extra);
+            output.writePackedUInt(len);
+            output.write(str, len);
+        }
+        else if (mol.isRSite(i))
+        {
+            output.writePackedUInt((CMF2_ATOM_RSITE << 1) | extra);
+            output.writePackedUInt(mol.getRSiteBits(i));
+        }
+        else
+        {
+            int number = mol.getAtomNumber(i);
+
+            if (number <= 0 || number >= ELEM_MAX)
+                throw Error("unexpected atom label");
+
+            output.writePackedUInt((number << 1) | extra);
+        }
+
+        if (extra)
+            output.writePackedUInt((hydrogens << 1) | highlighted);
+    }
+
+    // The last atom that is an end of the previous bonds
+    int last = 0;
+    int extras = 0;
+
+    for (i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+    {
+        const Edge& edge = mol.getEdge(i);
+        int order = mol.getBondOrder(i);
+
+        if (order < BOND_ZERO || order > BOND_AROMATIC)
+            throw Error("bad bond order: %d", order);
+
+        int beg = _atom_mapping[edge.beg];
+        int end = _atom_mapping[edge.end];
+        int bits = order, tmp;
+
+        if (mol.getBondTopology(i) == TOPOLOGY_RING)
+            bits |= CMF2_BOND_RING;
+        if (beg > end)
+        {
+            bits |= CMF2_BOND_SWAP;
+            __swap(beg, end, tmp);
+        }
+
+        if (end == last + 1)
+            output.writePackedUInt(bits | ((end - beg - 1) << CMF2_BOND_SHIFT));
+        else
+        {
+            output.writePackedUInt(bits | CMF2_BOND_CLOSURE | ((end - beg - 1) << CMF2_BOND_SHIFT));
+            output.writePackedUInt(_zigzag(last - end));
+        }
+        if (end > last)
+            last = end;
+
+        if ((save_bond_dirs && mol.getBondDirection(i) != 0) || (save_highlighting && mol.isBondHighlighted(i)))
+            extras++;
+    }
+
+    int attachments = 0;
+
+    for (i = 1; i <= mol.attachmentPointCount(); i++)
+        for (j = 0; mol.getAttachmentPoint(i, j) != -1; j++)
+            attachments++;
+
+    QS_DEF(Array<int>, rsites);
+    rsites.clear();
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+        if (mol.isRSite(i) && mol.getRSiteAttachmentPointByOrder(i, 0) >= 0)
+            rsites.push(i);
+
+    // The rare properties follow only if there are any
+    if (extras == 0 && attachments == 0 && rsites.size() == 0)
+        return;
+
+    output.writePackedUInt(extras);
+    for (i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+    {
+        int bits = 0;
+
+        if (save_bond_dirs)
+            bits |= mol.getBondDirection(i);
+        if (save_highlighting && mol.isBondHighlighted(i))
+            bits |= CMF2_BOND_HIGHLIGHTED;
+
+        if (bits != 0)
+        {
+            output.writePackedUInt(_bond_mapping[i]);
+            output.writeByte(bits);
+        }
+    }
+
+    output.writePackedUInt(attachments);
+    for (i = 1; i <= mol.attachmentPointCount(); i++)
+    {
+        int aidx;
+
+        for (j = 0; (aidx = mol.getAttachmentPoint(i, j)) != -1; j++)
+        {
+            output.writePackedUInt(_atom_mapping[aidx]);
+            output.writePackedUInt(i);
+        }
+    }
+
+    output.writePackedUInt(rsites.size());
+    for (i = 0; i < rsites.size(); i++)
+    {
+        int att, count = 0;
+
+        while (mol.getRSiteAttachmentPointByOrder(rsites[i], count) >= 0)
+            count++;
+
+        output.writePackedUInt(_atom_mapping[rsites[i]]);
+        output.writePackedUInt(count);
+        for (j = 0; (att = mol.getRSiteAttachmentPointByOrder(rsites[i], j)) >= 0; j++)
+            output.writePackedUInt(_atom_mapping[att]);
+    }
+}
+
+void Cmf2Saver::_writeCharges(Molecule& mol, Output& output)
+{
+    QS_DEF(Array<int>, props);
+    int i, count = 0;
+
+    props.clear_resize(mol.vertexEnd());
+    props.zerofill();
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+    {
+        if (mol.getAtomCharge(i) != 0)
+            props[i] |= CMF2_PROP_CHARGE;
+        if (mol.getAtomIsotope(i) > 0)
+            props[i] |= CMF2_PROP_ISOTOPE;
+
+        if (!mol.isPseudoAtom(i) && !mol.isRSite(i))
+        {
+            try
+            {
+                if (mol.getAtomRadical(i) > 0)
+                    props[i] |= CMF2_PROP_RADICAL;
+            }
+            catch (Element::Error&)
+            {
+            }
+
+            // The same valences as CMF saves
+            int number = mol.getAtomNumber(i);
+
+            if (mol.isExplicitValenceSet(i) ||
+                (mol.getAtomAromaticity(i) == ATOM_AROMATIC && (mol.getAtomCharge(i) != 0 || (number != ELEM_C && number != ELEM_O))))
+            {
+                try
+                {
+                    if (mol.getAtomValence(i) >= 0)
+                        props[i] |= CMF2_PROP_VALENCE;
+                }
+                catch (Element::Error&)
+                {
+                }
+            }
+        }
+
+        if (props[i] != 0)
+            count++;
+    }
+
+    // An empty section means no properties
+    if (count == 0)
+        return;
+
+    output.writePackedUInt(count);
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+    {
+        if (props[i] == 0)
+            continue;
+
+        output.writePackedUInt(_atom_mapping[i]);
+        output.writeByte(props[i]);
+
+        if (props[i] & CMF2_PROP_CHARGE)
+            output.writePackedUInt(_zigzag(mol.getAtomCharge(i)));
+        if (props[i] & CMF2_PROP_ISOTOPE)
+            output.writePackedUInt(mol.getAtomIsotope(i));
+        if (props[i] & CMF2_PROP_RADICAL)
+            output.writeByte(mol.getAtomRadical(i));
+        if (props[i] & CMF2_PROP_VALENCE)
+            output.writePackedUInt(mol.getAtomValence(i));
+    }
+}
+
+void Cmf2Saver::_writeStereo(Molecule& mol, Output& output)
+{
+    MoleculeStereocenters& stereo = mol.stereocenters;
+    int i;
+
+    QS_DEF(Array<int>, bonds);
+    bonds.clear();
+
+    for (i = mol.edgeBegin(); i != mol.edgeEnd(); i = mol.edgeNext(i))
+        if (mol.cis_trans.getParity(i) != 0 || mol.cis_trans.isIgnored(i))
+            bonds.push(i);
+
+    // An empty section means no stereo
+    if (stereo.size() == 0 && bonds.size() == 0 && mol.allene_stereo.size() == 0)
+        return;
+
+    output.writePackedUInt(stereo.size());
+    for (i = stereo.begin(); i != stereo.end(); i = stereo.next(i))
+    {
+        int atom_idx, type, group, pyramid[4];
+        bool invert = false;
+
+        stereo.get(i, atom_idx, type, group, pyramid);
+
+        if (type == MoleculeStereocenters::ATOM_ANY)
+            group = 0;
+        else
+            invert = !MoleculeStereocenters::isPyramidMappingRigid(pyramid, pyramid[3] == -1 ? 3 : 4, _atom_mapping.ptr());
+
+        output.writePackedUInt(_atom_mapping[atom_idx]);
+        output.writePackedUInt((group << 3) | (invert ? 4 : 0) | (type - 1));
+    }
+
+    output.writePackedUInt(bonds.size());
+    for (i = 0; i < bonds.size(); i++)
+    {
+        int parity = mol.cis_trans.getParity(bonds[i]);
+
+        if (parity != 0)
+            parity = MoleculeCisTrans::applyMapping(parity, mol.cis_trans.getSubstituents(bonds[i]), _atom_mapping.ptr(), true);
+        else
+            parity = CMF2_CIS_TRANS_IGNORED;
+
+        output.writePackedUInt(_bond_mapping[bonds[i]]);
+        output.writeByte(parity);
+    }
+
+    output.writePackedUInt(mol.allene_stereo.size());
+    for (i = mol.allene_stereo.begin(); i != mol.allene_stereo.end(); i = mol.allene_stereo.next(i))
+    {
+        int atom_idx, left, right, parity, subst[4];
+        const int* mapping = _atom_mapping.ptr();
+
+        mol.allene_stereo.get(i, atom_idx, left, right, subst, parity);
+
+        // The loader sorts the substituents by the saved indices
+        if (subst[1] != -1 && mapping[subst[1]] < mapping[subst[0]])
+            parity = 3 - parity;
+        if (subst[3] != -1 && mapping[subst[3]] < mapping[subst[2]])
+            parity = 3 - parity;
+
+        output.writePackedUInt(mapping[atom_idx]);
+        output.writeByte(parity);
+    }
+}
+
+void Cmf2Saver::_writeXyz(Molecule& mol, Output& output)
+{
+    Vec3f xyz_min(10000, 10000, 10000);
+    Vec3f xyz_max(-10000, -10000, -10000);
+    Vec3f range;
+    int i;
+
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+    {
+        const Vec3f& pos = mol.getAtomXyz(i);
+
+        xyz_min.min(pos);
+        xyz_max.max(pos);
+    }
+
+    range.diff(xyz_max, xyz_min);
+
+    bool have_z = range.z > EPSILON;
+
+    output.writeBinaryFloat(xyz_min.x);
+    output.writeBinaryFloat(xyz_min.y);
+    output.writeBinaryFloat(xyz_min.z);
+    output.writeBinaryFloat(range.x);
+    output.writeBinaryFloat(range.y);
+    output.writeBinaryFloat(range.z);
+    output.writeByte(have_z ? 1 : 0);
+
+    // The coordinates are quantized to 16 bits within the range like in CMF
+    for (i = mol.vertexBegin(); i != mol.vertexEnd(); i = mol.vertexNext(i))
+    {
+        const Vec3f& pos = mol.getAtomXyz(i);
+
+        output.writeBinaryWord(range.x > EPSILON ? (word)((pos.x - xyz_min.x) / range.x * 65535 + 0.5f) : 0);
+        output.writeBinaryWord(range.y > EPSILON ? (word)((pos.y - xyz_min.y) / range.y * 65535 + 0.5f) : 0);
+        if (have_z)
+            output.writeBinaryWord((word)((pos.z - xyz_min.z) / range.z * 65535 + 0.5f));
+    }
+}
+
+void Cmf2Saver::_writeSGroups(Molecule& mol, Output& output)
+{
+    bool have_xyz = save_xyz && mol.have_xyz;
+    int i, j;
+
+    output.writePackedUInt(mol.sgroups.getSGroupCount());
+
+    for (i = mol.sgroups.begin(); i != mol.sgroups.end(); i = mol.sgroups.next(i))
+    {
+        SGroup& sg = mol.sgroups.getSGroup(i);
+
+        output.writePackedUInt(sg.sgroup_type);
+        output.writePackedUInt(sg.sgroup_subtype);
+        output.writePackedUInt(_zigzag(sg.brk_style));
+        _writeIndices(output, sg.atoms, _atom_mapping);
+        _writeIndices(output, sg.bonds, _bond_mapping);
+
+        if (sg.sgroup_type == SGroup::SG_TYPE_DAT)
+        {
+            DataSGroup& sd = (DataSGroup&)sg;
+
+            _writeString(output, sd.description);
+            _writeString(output, sd.name);
+            _writeString(output, sd.type);
+            _writeString(output, sd.querycode);
+            _writeString(output, sd.queryoper);
+            _writeString(output, sd.data);
+            output.writeByte((sd.detached ? 1 : 0) | (sd.relative ? 2 : 0) | (sd.display_units ? 4 : 0));
+            output.writePackedUInt(_zigzag(sd.num_chars));
+            output.writePackedUInt(_zigzag(sd.dasp_pos));
+            output.writeChar(sd.tag);
+        }
+        else if (sg.sgroup_type == SGroup::SG_TYPE_SUP)
+        {
+            Superatom& sa = (Superatom&)sg;
+
+            _writeString(output, sa.subscript);
+            _writeString(output, sa.sa_class);
+            output.writePackedUInt(_zigzag(sa.contracted));
+
+            output.writePackedUInt(sa.attachment_points.size());
+            for (j = sa.attachment_points.begin(); j != sa.attachment_points.end(); j = sa.attachment_points.next(j))
+            {
+                Superatom::_AttachmentPoint& ap = sa.attachment_points.at(j);
+
+                output.writePackedUInt(ap.aidx >= 0 ? _atom_mapping[ap.aidx] + 1 : 0);
+                output.writePackedUInt(ap.lvidx >= 0 ? _atom_mapping[ap.lvidx] + 1 : 0);
+                _writeString(output, ap.apid);
+            }
+
+            output.writePackedUInt(sa.bond_connections.size());
+            for (j = 0; j < sa.bond_connections.size(); j++)
+            {
+                int bond_idx = sa.bond_connections[j].bond_idx;
+
+                output.writePackedUInt(bond_idx >= 0 ? _bond_mapping[bond_idx] + 1 : 0);
+            }
+        }
+        else if (sg.sgroup_type == SGroup::SG_TYPE_SRU)
+        {
+            RepeatingUnit& su = (RepeatingUnit&)sg;
+
+            _writeString(output, su.subscript);
+            output.writePackedUInt(_zigzag(su.connectivity));
+        }
+        else if (sg.sgroup_type == SGroup::SG_TYPE_MUL)
+        {
+            MultipleGroup& sm = (MultipleGroup&)sg;
+
+            _writeIndices(output, sm.parent_atoms, _atom_mapping);
+            output.writePackedUInt(_zigzag(sm.multiplier));
+        }
+
+        if (!have_xyz)
+            continue;
+
+        // The S-group coordinates are rare, so they are not quantized
+        output.writePackedUInt(sg.brackets.size());
+        for (j = 0; j < sg.brackets.size(); j++)
+        {
+            output.writeBinaryFloat(sg.brackets[j][0].x);
+            output.writeBinaryFloat(sg.brackets[j][0].y);
+            output.writeBinaryFloat(sg.brackets[j][1].x);
+            output.writeBinaryFloat(sg.brackets[j][1].y);
+        }
+
+        if (sg.sgroup_type == SGroup::SG_TYPE_DAT)
+        {
+            DataSGroup& sd = (DataSGroup&)sg;
+
+            output.writeBinaryFloat(sd.display_pos.x);
+            output.writeBinaryFloat(sd.display_pos.y);
+        }
+        else if (sg.sgroup_type == SGroup::SG_TYPE_SUP)
+        {
+            Superatom& sa = (Superatom&)sg;
+
+            for (j = 0; j < sa.bond_connections.size(); j++)
+            {
+                output.writeBinaryFloat(sa.bond_connections[j].bond_dir.x);
+                output.writeBinaryFloat(sa.bond_connections[j].bond_dir.y);
+            }
+        }
+    }
+}
+
+void Cmf2Saver::_writeString(Output& output, const Array<char>& str)
+{
+    int len = str.size();
+
+    if (len > 0 && str[len - 1] == 0)
+        len--;
+    output.writePackedUInt(len);
+    output.write(str.ptr(), len);
+}
+
+void Cmf2Saver::_writeIndices(Output& output, const Array<int>& data, const Array<int>& mapping)
+{
+    output.writePackedUInt(data.size());
+    for (int i = 0; i < data.size(); i++)
+    {
+        if (data[i] < 0 || data[i] >= mapping.size() || mapping[data[i]] < 0)
+            throw Error("invalid index: %d", data[i]);
+        output.writePackedUInt(mapping[data[i]]);
+    }
+}
@@ -36,6 +36,29 @@ CmfLoader::CmfLoader(LzwDict& dict, Scanner& scanner)
     _decoder_obj.create(dict, scanner);
     _lzw_scanner.create(_decoder_obj.ref());
     _scanner = _lzw_scanner.get();
+    _decoder = _decoder_obj.get();
+}
+
+CmfLoader::CmfLoader(LzwDict& dict, const char* data, int size)
+    : CP_INIT, TL_CP_GET(atom_mapping_to_restore), TL_CP_GET(inv_atom_mapping_to_restore), TL_CP_GET(bond_mapping_to_restore),
+      TL_CP_GET(inv_bond_mapping_to_restore), TL_CP_GET(_atoms), TL_CP_GET(_bonds), TL_CP_GET(_pseudo_labels), TL_CP_GET(_attachments), TL_CP_GET(_sgroup_order)
+{
+    _init();
+    const byte* bytes = (const byte*)data;
+    _decoder_obj.create(dict, bytes, size);
+    _lzw_scanner.create(_decoder_obj.ref());
+    _scanner = _lzw_scanner.get();
+    _decoder = _decoder_obj.get();
+}
+
+CmfLoader::CmfLoader(const char* data, int size)
+    : CP_INIT, TL_CP_GET(atom_mapping_to_restore), TL_CP_GET(inv_atom_mapping_to_restore), TL_CP_GET(bond_mapping_to_restore),
+      TL_CP_GET(inv_bond_mapping_to_restore), TL_CP_GET(_atoms), TL_CP_GET(_bonds), TL_CP_GET(_pseudo_labels), TL_CP_GET(_attachments), TL_CP_GET(_sgroup_order)
+{
+    _init();
+    _buffer_scanner.create(data, size);
+    _scanner = _buffer_scanner.get();
+    _buffer = _buffer_scanner.get();
 }
 
 CmfLoader::CmfLoader(Scanner& scanner)
@@ -53,6 +76,7 @@ CmfLoader::CmfLoader(LzwDecoder& decoder)
     _init();
     _lzw_scanner.create(decoder);
     _scanner = _lzw_scanner.get();
+    _decoder = &decoder;
 }
 
 CmfLoader::~CmfLoader()
@@ -66,8 +90,11 @@ void CmfLoader::_init()
     skip_cistrans = false;
     skip_stereocenters = false;
     skip_valence = false;
+    skip_sgroups = false;
     _ext_decoder = 0;
     _scanner = 0;
+    _decoder = 0;
+    _buffer = 0;
     atom_flags = 0;
     bond_flags = 0;
 
@@ -80,6 +107,21 @@ void CmfLoader::_init()
 
 bool CmfLoader::_getNextCode(int& code)
 {
+    // The same as reading _scanner, but with direct calls
+    if (_decoder != 0)
+    {
+        if (_decoder->isEOF())
+            return false;
+        code = _decoder->get();
+        return true;
+    }
+    if (_buffer != 0)
+    {
+        if (_buffer->BufferScanner::isEOF())
+            return false;
+        code = _buffer->BufferScanner::readByte();
+        return true;
+    }
     if (_scanner->isEOF())
         return false;
     code = _scanner->readByte();
@@ -899,7 +941,15 @@ void CmfLoader::_readExtSection(Molecule& mol)
         // TODO provide a readers map to avoid such "if"s
         else if (code == CMF_DATASGROUP || code == CMF_SUPERATOM || code == CMF_REPEATINGUNIT || code == CMF_MULTIPLEGROUP || code == CMF_GENERICSGROUP)
         {
-            _readSGroup(code, mol);
+            if (skip_sgroups)
+            {
+                // The mapping may follow, so the S-groups are read anyway
+                QS_DEF(Molecule, skipped);
+                skipped.sgroups.clear();
+                _readSGroup(code, skipped);
+            }
+            else
+                _readSGroup(code, mol);
         }
         else if (code == CMF_RSITE_ATTACHMENTS)
         {
@@ -954,7 +1004,7 @@ void CmfLoader::loadXyz(Scanner& scanner)
     }
 
     // Read sgroup coordinates data
-    for (int i = 0; i < _sgroup_order.size(); i++)
+    for (int i = 0; i < _sgroup_order.size() && !skip_sgroups; i++)
         _readSGroupXYZ(scanner, _sgroup_order[i], *_mol, range);
 
     _mol->have_xyz = true;
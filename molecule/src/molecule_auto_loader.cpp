@@ -21,6 +21,7 @@
 #include "base_cpp/output.h"
 #include "base_cpp/scanner.h"
 #include "gzip/gzip_scanner.h"
+#include "molecule/cmf2_loader.h"
 #include "molecule/cml_loader.h"
 #include "molecule/icm_loader.h"
 #include "molecule/icm_saver.h"
@@ -245,13 +246,13 @@ void MoleculeAutoLoader::_loadMolecule(BaseMolecule& mol, bool query)
         }
     }
 
-    // check for ICM format
-    if (!query && _scanner->length() >= 4LL)
+    // check for ICM and CMF2 formats
+    if (!query && _scanner->length() - _scanner->tell() >= 4LL)
     {
-        char id[3];
+        char id[4];
         long long pos = _scanner->tell();
 
-        _scanner->readCharsFix(3, id);
+        _scanner->readCharsFix(4, id);
         _scanner->seek(pos, SEEK_SET);
         if (IcmSaver::checkVersion(id))
         {
@@ -262,6 +263,12 @@ void MoleculeAutoLoader::_loadMolecule(BaseMolecule& mol, bool query)
             loader.loadMolecule((Molecule&)mol);
             return;
         }
+        if (Cmf2Loader::checkVersion(id, CMF2_PREFIX_SIZE))
+        {
+            Cmf2Loader loader(*_scanner);
+            loader.loadMolecule((Molecule&)mol);
+            return;
+        }
     }
 
     // check for CML format
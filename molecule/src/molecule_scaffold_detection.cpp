@@ -112,6 +112,22 @@ void MoleculeScaffoldDetection::makeEdgeSubmolecule(QueryMolecule& mol, Molecule
     }
 }
 
+void MoleculeScaffoldDetection::makeMolecule(Molecule& mol, QueryMolecule& scaffold)
+{
+    QS_DEF(Array<int>, v_mapping);
+    mol.clear();
+    v_mapping.clear_resize(scaffold.vertexEnd());
+
+    for (int i = scaffold.vertexBegin(); i < scaffold.vertexEnd(); i = scaffold.vertexNext(i))
+        v_mapping[i] = mol.addAtom(scaffold.getAtomNumber(i));
+
+    for (int i = scaffold.edgeBegin(); i < scaffold.edgeEnd(); i = scaffold.edgeNext(i))
+    {
+        const Edge& edge = scaffold.getEdge(i);
+        mol.addBond(v_mapping[edge.beg], v_mapping[edge.end], scaffold.getBondOrder(i));
+    }
+}
+
 bool MoleculeScaffoldDetection::matchBonds(Graph& g1, Graph& g2, int i, int j, void*)
 {
     BaseMolecule& mol1 = (BaseMolecule&)g1;
@@ -17,8 +17,10 @@
  ***************************************************************************/
 #include "molecule/molecule_tautomer_enumerator.h"
 
+#include "base_cpp/output.h"
 #include "base_cpp/scanner.h"
 #include "graph/embedding_enumerator.h"
+#include "molecule/canonical_smiles_saver.h"
 #include "molecule/elements.h"
 #include "molecule/inchi_parser.h"
 #include "molecule/inchi_wrapper.h"
@@ -37,10 +39,73 @@
 #include "reaction/reaction_transformation.h"
 #include "reaction/rsmiles_loader.h"
 
+#include <algorithm>
 #include <tuple>
 
 using namespace indigo;
 
+// Tautomerization rules in the form of reaction SMARTS
+static const char* _tautomer_rules[] = {
+#if 0
+  // Just InChI-like rules based on heteroatoms
+  "[#1:0][N&v3,n,O,S:1][*:2]=,:[N&v3,n,O,S:3]>>[N,n,O,S:1]=[A,a:2]-[N,n,O,S:3][#1:0]",
+  "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[N&v3,n,O,S:5]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[N,n,O,S:5][#1:0]",
+  "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[*:5][*:6]=,:[N&v3,n,O,S:7]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[A,a:5]=[A,a:6]-[N,n,O,S:7][#1:0]",
+  "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[*:5][*:6]=,:[*:7][*:8]=,:[N&v3,n,O,S:9]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[A,a:5]=[A,a:6]-[A,a:7]=[A,a:8]-[N,n,O,S:9][#1:0]"
+#else
+    "[O,S,Se,Te;X1:1]=[C:2][CX4;R0,R1,R2:3][#1:0]>>[#1:0][O,S,Se,Te;X2:1]-[#6;X3:2]=[C,c;X3:3]", // Rule 1:  1,3 Keto-enol
+    "[#1:0][O,S,Se,Te;X2:1]-[#6;X3:2]=[C,c;X3:3]>>[O,S,Se,Te;X1:1]=[C:2][CX4;R0,R1,R2:3][#1:0]", // Rule 1:  1,3 Keto-enol
+    "[O,S,Se,Te;X1:1]=[CX3:2]([#6:6])[C:3]=[C:4][CX4,NX3:5]([C:7])[#1:0]>>[#1:0][O,S,Se,Te;X2:1][CX3:2]([C:6])=[C:3][C:4]=[CX3,N:5]([C:7])", // Rule 2:  1,5
+                                                                                                                                             // Keto-enol
+    "[#1:0][O,S,Se,Te;X2:1][CX3:2]([C:6])=[C:3][C:4]=[CX3,N:5]([C:7])>>[O,S,Se,Te;X1:1]=[CX3:2]([#6:6])[C:3]=[C:4][CX4,NX3:5]([C:7])[#1:0]", // Rule 2:  1,5
+                                                                                                                                             // Keto-enol
+    "[#1,a,O:5][NX2:1]=[CX3:2]([C,#1:4])[CX4;R0,R1,R2:3][#1:0]>>[#1,a,O:5][NX3:1]([#1:0])[CX3:2]([C,#1:4])=[CX3:3]", // Rule 3:  simple (aliphatic) imine
+    "[#1,a,O:5]-[NX3:1](-[#1:0])-[CX3:2](-[C,#1:4])=[CX3:3]>>[#1,a,O:5]-[NX2:1]=[CX3:2](-[C,#1:4])-[CX4;R0,R1,R2:3][#1:0]", // Rule 3:  simple (aliphatic)
+                                                                                                                            // imine
+    "[CX3R0:1]([C,#1:5])([C:4])=[C:2][N:3]([C:6])[#1:0]>>[#1:0][CX4R0:1]([C,#1:5])([C:4])[c:2]:[n:3]:[c:6]",                // Rule 4:  special imine
+    "[#1:0][CX4R0:1]([C,#1:5])([C:4])[c:2]:[n:3]:[c:6]>>[CX3R0:1]([C,#1:5])([C:4])=[C:2][N:3]([C:6])[#1:0]",                // Rule 4:  special imine
+    "[#1:0][N:1]-&@[C:2]=[O,NX2:3]>>[NX2,nX2:1]=[C,c:2]-[O,N:3][#1:0]",  // Rule 5:  aromatic heteroatom H shift
+    "[NX2,nX2:1]=,:[C,c:2][O,N:3][#1:0]>>[#1:0][N:1]-&@[C:2]=[O,NX2:3]", // Rule 5:  aromatic heteroatom H shift
+    "[N,n,S,s,O,o,Se,Te:1]=[NX2,nX2,C,c,P,p:2]-[N,n,S,O,Se,Te:3][#1:0]>>[#1:0][N,n,S,O,Se,Te:1]-[NX2,nX2,C,c,P,p:2]=[N,n,S,s,O,o,Se,Te:3]", // Rule 6:  1,3
+                                                                                                                                            // heteroatom H
+                                                                                                                                            // shift
+    "[NX2,nX2,S,O,Se,Te:1]=[C,c,NX2,nX2:2][C,c:3]=[C,c,nX2:4][N,n,S,s,O,o,Se,Te:5][#1:0]>>[#1:0][N,n,S,O,Se,Te:1][C,c,NX2,nX2:2]=[C,c:3][C,c,nX2:4]=[NX2,S,"
+    "O,Se,Te:5]",                                                                                       // Rule 7:  1,5 (aromatic) heteroatom H shift (1)
+    "[n,s,o:1]:[c,n:2]:[c:3]:[c,n:4]:[n,s,o:5][#1:0]>>[#1:0][n,s,o:1]:[c,n:2]:[c:3]:[c,n:4]:[n,s,o:5]", // Rule 8:  1,5 aromatic heteroatom H shift (2)
+    "[NX2,nX2,S,O,Se,Te:1]=,:[C,c,NX2,nX2:2][C,c:3]=,:[C,c,NX2,nX2:4][C,c,NX2,nX2:5]=,:[C,c,NX2,nX2:6][N,n,S,s,O,o,Se,Te:7][#1:0]>>[#1:0][N,n,S,O,Se,Te:1]-"
+    "[C,c,NX2,nX2:2]=[C,c:3]-[C,c,NX2,nX2:4]=[C,c,NX2,nX2:5]-[C,c,NX2,nX2:6]=[NX2,S,O,Se,Te:7]", // Rule 9:  1,7 (aromatic) heteroatom H shift
+    "[#1:0][N,n,O:1][C,c,nX2:2]=,:[C,c,nX2:3][c,nX2:4]=,:[c,nX2:5][c,nX2:6]=,:[c,nX2:7][C,c,nX2:8]=,:[N,n,O:9]>>[NX2,nX2,O:1]=[C,c,nX2:2]-[c,nX2:3]=[c,nX2:"
+    "4]-[c,nX2:5]=[c,nX2:6]-[c,nX2:7]=[c,nX2:8]-[n,O:9][#1:0]", // Rule 10:  1,9 (aromatic) heteroatom H shift
+    "[#1:0][N,n,O:1][C,c,nX2:2]=,:[C,c,nX2:3][c,nX2:4]=,:[C,c,nX2:5][C,c,nX2:6]=,:[C,c,nX2:7][C,c,nX2:8]=,:[C,c,nX2:9][C,c,nX2:10]=,:[NX2,nX2,O:11]>>[NX2,"
+    "nX2,O:1]=[C,c,nX2:2]-[C,c,nX2:3]=[C,c,nX2:4]-[C,c,nX2:5]=[C,c,nX2:6]-[C,c,nX2:7]=[C,c,nX2:8]-[C,c,nX2:9]=[C,c,nX2:10]-[O,nX2:11][#1:0]", // Rule 11:
+                                                                                                                                              // 1,11
+                                                                                                                                              // (aromatic)
+                                                                                                                                              // heteroatom
+                                                                                                                                              // H shift
+    "[#1:0][O,S,N:1][C,c;r5:2]([!#6&!#1:5])=,:[C,c;r5:3][C,c;r5:4]>>[O,S,N:1]=[C;r5:2]([A,a:5])-[Cr5;R0,R1,R2:3]([#1:0])[C,c;r5:4]", // Rule 12:  furanones
+    "[O,S,N:1]=[C;r5:2]([A,a:5])[Cr5;R0,R1,R2:3]([#1:0])[C,c;r5:4]>>[#1:0][O,S,N:1]-[C,c;r5:2]([!#6&!#1:5])=[C,c;r5:3]-[C,c;r5:4]",  // Rule 12:  furanones
+    "[O,S,Se,Te;X1:1]=[C:2]=[C:3][#1:0]>>[#1:0][O,S,Se,Te;X2:1][C:2]#[C:3]", // Rule 13:  keten/ynol exchange
+    "[#1:0][O,S,Se,Te;X2:1][C:2]#[C:3]>>[O,S,Se,Te;X1:1]=[C:2]=[C:3][#1:0]", // Rule 13:  keten/ynol exchange
+    "[#1:0][C:1][N+:2]([O-:4])=[O:3]>>[C:1]=[N+:2]([O-:4])[O:3][#1:0]",      // Rule 14:  ionic nitro/aci-nitro
+    "[C:1]=[N+:2]([O-:4])[O:3][#1:0]>>[#1:0][C:1][N+:2]([O-:4])=[O:3]",      // Rule 14:  ionic nitro/aci-nitro
+    //"[#1:0][C:1][N:2](=[O:4])=[O:3]>>[C:1]=[N:2](=[O:4])[O:3][#1:0]",   // Rule 15:  pentavalent nitro/aci-nitro
+    "[#1:0][O:1][N:2]=[C:3]>>[O:1]=[N:2][C:3][#1:0]",                                              // Rule 16:  oxim/nitroso
+    "[O:1]=[N:2][C:3][#1:0]>>[#1:0][O:1][N:2]=[C:3]",                                              // Rule 16:  oxim/nitroso
+    "[#1:0][O:1][N:2]=[C:3][C:4]=[C:5][C:6]=[O:7]>>[O:1]=[N:2][c:3]=[c:4][c:5]=[c:6][O:7][#1:0]",  // Rule 17:  oxim/nitroso via phenol
+    "[O:1]=[N:2][c:3]:[c:4]:[c:5]:[c:6][O:7][#1:0]>>[#1:0][O:1][N:2]=[C:3][C:4]=[C:5][C:6]=[O:7]", // Rule 17:  oxim/nitroso via phenol
+    "[#1:0][O:1][C:2]#[N:3]>>[O:1]=[C:2]=[N:3][#1:0]",                                             // Rule 18:  cyanic/iso-cyanic acids
+    "[O:1]=[C:2]=[N:3][#1:0]>>[#1:0][O:1][C:2]#[N:3]",                                             // Rule 18:  cyanic/iso-cyanic acids
+    "[#1:0][O,N:1][C:2]=[S,Se,Te:3]=[O:4]>>[O,N:1]=[C:2][S,Se,Te:3][O:4][#1:0]",                   // Rule 19:  formamidinesulfinic acids
+    "[O,N:1]=[C:2][S,Se,Te:3][O:4][#1:0]>>[#1:0][O,N:1][C:2]=[S,Se,Te:3]=[O:4]",                   // Rule 19:  formamidinesulfinic acids
+    "[#1:0][C0:1]#[N0:2]>>[C-:1]#[N+:2][#1:0]",                                                    // Rule 20:  isocyanides
+    "[C-:1]#[N+:2][#1:0]>>[#1:0][C0:1]#[N0:2]",                                                    // Rule 20:  isocyanides
+    "[#1:0][O:1][P:2]>>[O:1]=[P:2][#1:0]",                                                         // Rule 21:   phosphonic acids
+    "[O:1]=[P:2][#1:0]>>[#1:0][O:1][P:2]"                                                          // Rule 21:   phosphonic acids
+#endif
+};
+
+static const int _tautomer_rules_count = sizeof(_tautomer_rules) / sizeof(_tautomer_rules[0]);
+
 TautomerEnumerator::TautomerEnumerator(Molecule& molecule, TautomerMethod method)
     : layeredMolecules(molecule),
 #ifdef USE_DEPRECATED_INCHI
@@ -388,64 +453,6 @@ bool TautomerEnumerator::_performProcedure()
         return layeredMolecules.layers == layersBefore;
     }
 #endif
-    const char* reactionSmarts[] = {
-#if 0
-      // Just InChI-like rules based on heteroatoms
-      "[#1:0][N&v3,n,O,S:1][*:2]=,:[N&v3,n,O,S:3]>>[N,n,O,S:1]=[A,a:2]-[N,n,O,S:3][#1:0]",
-      "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[N&v3,n,O,S:5]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[N,n,O,S:5][#1:0]",
-      "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[*:5][*:6]=,:[N&v3,n,O,S:7]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[A,a:5]=[A,a:6]-[N,n,O,S:7][#1:0]",
-      "[#1:0][N&v3,n,O,S:1][*:2]=,:[*:3][*:4]=,:[*:5][*:6]=,:[*:7][*:8]=,:[N&v3,n,O,S:9]>>[N,n,O,S:1]=[A,a:2]-[A,a:3]=[A,a:4]-[A,a:5]=[A,a:6]-[A,a:7]=[A,a:8]-[N,n,O,S:9][#1:0]"
-#else
-        "[O,S,Se,Te;X1:1]=[C:2][CX4;R0,R1,R2:3][#1:0]>>[#1:0][O,S,Se,Te;X2:1]-[#6;X3:2]=[C,c;X3:3]", // Rule 1:  1,3 Keto-enol
-        "[#1:0][O,S,Se,Te;X2:1]-[#6;X3:2]=[C,c;X3:3]>>[O,S,Se,Te;X1:1]=[C:2][CX4;R0,R1,R2:3][#1:0]", // Rule 1:  1,3 Keto-enol
-        "[O,S,Se,Te;X1:1]=[CX3:2]([#6:6])[C:3]=[C:4][CX4,NX3:5]([C:7])[#1:0]>>[#1:0][O,S,Se,Te;X2:1][CX3:2]([C:6])=[C:3][C:4]=[CX3,N:5]([C:7])", // Rule 2:  1,5
-                                                                                                                                                 // Keto-enol
-        "[#1:0][O,S,Se,Te;X2:1][CX3:2]([C:6])=[C:3][C:4]=[CX3,N:5]([C:7])>>[O,S,Se,Te;X1:1]=[CX3:2]([#6:6])[C:3]=[C:4][CX4,NX3:5]([C:7])[#1:0]", // Rule 2:  1,5
-                                                                                                                                                 // Keto-enol
-        "[#1,a,O:5][NX2:1]=[CX3:2]([C,#1:4])[CX4;R0,R1,R2:3][#1:0]>>[#1,a,O:5][NX3:1]([#1:0])[CX3:2]([C,#1:4])=[CX3:3]", // Rule 3:  simple (aliphatic) imine
-        "[#1,a,O:5]-[NX3:1](-[#1:0])-[CX3:2](-[C,#1:4])=[CX3:3]>>[#1,a,O:5]-[NX2:1]=[CX3:2](-[C,#1:4])-[CX4;R0,R1,R2:3][#1:0]", // Rule 3:  simple (aliphatic)
-                                                                                                                                // imine
-        "[CX3R0:1]([C,#1:5])([C:4])=[C:2][N:3]([C:6])[#1:0]>>[#1:0][CX4R0:1]([C,#1:5])([C:4])[c:2]:[n:3]:[c:6]",                // Rule 4:  special imine
-        "[#1:0][CX4R0:1]([C,#1:5])([C:4])[c:2]:[n:3]:[c:6]>>[CX3R0:1]([C,#1:5])([C:4])=[C:2][N:3]([C:6])[#1:0]",                // Rule 4:  special imine
-        "[#1:0][N:1]-&@[C:2]=[O,NX2:3]>>[NX2,nX2:1]=[C,c:2]-[O,N:3][#1:0]",  // Rule 5:  aromatic heteroatom H shift
-        "[NX2,nX2:1]=,:[C,c:2][O,N:3][#1:0]>>[#1:0][N:1]-&@[C:2]=[O,NX2:3]", // Rule 5:  aromatic heteroatom H shift
-        "[N,n,S,s,O,o,Se,Te:1]=[NX2,nX2,C,c,P,p:2]-[N,n,S,O,Se,Te:3][#1:0]>>[#1:0][N,n,S,O,Se,Te:1]-[NX2,nX2,C,c,P,p:2]=[N,n,S,s,O,o,Se,Te:3]", // Rule 6:  1,3
-                                                                                                                                                // heteroatom H
-                                                                                                                                                // shift
-        "[NX2,nX2,S,O,Se,Te:1]=[C,c,NX2,nX2:2][C,c:3]=[C,c,nX2:4][N,n,S,s,O,o,Se,Te:5][#1:0]>>[#1:0][N,n,S,O,Se,Te:1][C,c,NX2,nX2:2]=[C,c:3][C,c,nX2:4]=[NX2,S,"
-        "O,Se,Te:5]",                                                                                       // Rule 7:  1,5 (aromatic) heteroatom H shift (1)
-        "[n,s,o:1]:[c,n:2]:[c:3]:[c,n:4]:[n,s,o:5][#1:0]>>[#1:0][n,s,o:1]:[c,n:2]:[c:3]:[c,n:4]:[n,s,o:5]", // Rule 8:  1,5 aromatic heteroatom H shift (2)
-        "[NX2,nX2,S,O,Se,Te:1]=,:[C,c,NX2,nX2:2][C,c:3]=,:[C,c,NX2,nX2:4][C,c,NX2,nX2:5]=,:[C,c,NX2,nX2:6][N,n,S,s,O,o,Se,Te:7][#1:0]>>[#1:0][N,n,S,O,Se,Te:1]-"
-        "[C,c,NX2,nX2:2]=[C,c:3]-[C,c,NX2,nX2:4]=[C,c,NX2,nX2:5]-[C,c,NX2,nX2:6]=[NX2,S,O,Se,Te:7]", // Rule 9:  1,7 (aromatic) heteroatom H shift
-        "[#1:0][N,n,O:1][C,c,nX2:2]=,:[C,c,nX2:3][c,nX2:4]=,:[c,nX2:5][c,nX2:6]=,:[c,nX2:7][C,c,nX2:8]=,:[N,n,O:9]>>[NX2,nX2,O:1]=[C,c,nX2:2]-[c,nX2:3]=[c,nX2:"
-        "4]-[c,nX2:5]=[c,nX2:6]-[c,nX2:7]=[c,nX2:8]-[n,O:9][#1:0]", // Rule 10:  1,9 (aromatic) heteroatom H shift
-        "[#1:0][N,n,O:1][C,c,nX2:2]=,:[C,c,nX2:3][c,nX2:4]=,:[C,c,nX2:5][C,c,nX2:6]=,:[C,c,nX2:7][C,c,nX2:8]=,:[C,c,nX2:9][C,c,nX2:10]=,:[NX2,nX2,O:11]>>[NX2,"
-        "nX2,O:1]=[C,c,nX2:2]-[C,c,nX2:3]=[C,c,nX2:4]-[C,c,nX2:5]=[C,c,nX2:6]-[C,c,nX2:7]=[C,c,nX2:8]-[C,c,nX2:9]=[C,c,nX2:10]-[O,nX2:11][#1:0]", // Rule 11:
-                                                                                                                                                  // 1,11
-                                                                                                                                                  // (aromatic)
-                                                                                                                                                  // heteroatom
-                                                                                                                                                  // H shift
-        "[#1:0][O,S,N:1][C,c;r5:2]([!#6&!#1:5])=,:[C,c;r5:3][C,c;r5:4]>>[O,S,N:1]=[C;r5:2]([A,a:5])-[Cr5;R0,R1,R2:3]([#1:0])[C,c;r5:4]", // Rule 12:  furanones
-        "[O,S,N:1]=[C;r5:2]([A,a:5])[Cr5;R0,R1,R2:3]([#1:0])[C,c;r5:4]>>[#1:0][O,S,N:1]-[C,c;r5:2]([!#6&!#1:5])=[C,c;r5:3]-[C,c;r5:4]",  // Rule 12:  furanones
-        "[O,S,Se,Te;X1:1]=[C:2]=[C:3][#1:0]>>[#1:0][O,S,Se,Te;X2:1][C:2]#[C:3]", // Rule 13:  keten/ynol exchange
-        "[#1:0][O,S,Se,Te;X2:1][C:2]#[C:3]>>[O,S,Se,Te;X1:1]=[C:2]=[C:3][#1:0]", // Rule 13:  keten/ynol exchange
-        "[#1:0][C:1][N+:2]([O-:4])=[O:3]>>[C:1]=[N+:2]([O-:4])[O:3][#1:0]",      // Rule 14:  ionic nitro/aci-nitro
-        "[C:1]=[N+:2]([O-:4])[O:3][#1:0]>>[#1:0][C:1][N+:2]([O-:4])=[O:3]",      // Rule 14:  ionic nitro/aci-nitro
-        //"[#1:0][C:1][N:2](=[O:4])=[O:3]>>[C:1]=[N:2](=[O:4])[O:3][#1:0]",   // Rule 15:  pentavalent nitro/aci-nitro
-        "[#1:0][O:1][N:2]=[C:3]>>[O:1]=[N:2][C:3][#1:0]",                                              // Rule 16:  oxim/nitroso
-        "[O:1]=[N:2][C:3][#1:0]>>[#1:0][O:1][N:2]=[C:3]",                                              // Rule 16:  oxim/nitroso
-        "[#1:0][O:1][N:2]=[C:3][C:4]=[C:5][C:6]=[O:7]>>[O:1]=[N:2][c:3]=[c:4][c:5]=[c:6][O:7][#1:0]",  // Rule 17:  oxim/nitroso via phenol
-        "[O:1]=[N:2][c:3]:[c:4]:[c:5]:[c:6][O:7][#1:0]>>[#1:0][O:1][N:2]=[C:3][C:4]=[C:5][C:6]=[O:7]", // Rule 17:  oxim/nitroso via phenol
-        "[#1:0][O:1][C:2]#[N:3]>>[O:1]=[C:2]=[N:3][#1:0]",                                             // Rule 18:  cyanic/iso-cyanic acids
-        "[O:1]=[C:2]=[N:3][#1:0]>>[#1:0][O:1][C:2]#[N:3]",                                             // Rule 18:  cyanic/iso-cyanic acids
-        "[#1:0][O,N:1][C:2]=[S,Se,Te:3]=[O:4]>>[O,N:1]=[C:2][S,Se,Te:3][O:4][#1:0]",                   // Rule 19:  formamidinesulfinic acids
-        "[O,N:1]=[C:2][S,Se,Te:3][O:4][#1:0]>>[#1:0][O,N:1][C:2]=[S,Se,Te:3]=[O:4]",                   // Rule 19:  formamidinesulfinic acids
-        "[#1:0][C0:1]#[N0:2]>>[C-:1]#[N+:2][#1:0]",                                                    // Rule 20:  isocyanides
-        "[C-:1]#[N+:2][#1:0]>>[#1:0][C0:1]#[N0:2]",                                                    // Rule 20:  isocyanides
-        "[#1:0][O:1][P:2]>>[O:1]=[P:2][#1:0]",                                                         // Rule 21:   phosphonic acids
-        "[O:1]=[P:2][#1:0]>>[#1:0][O:1][P:2]"                                                          // Rule 21:   phosphonic acids
-#endif
-    };
 
     while (_currentLayer < layeredMolecules.layers)
     {
@@ -453,12 +460,12 @@ bool TautomerEnumerator::_performProcedure()
         constructMolecule(mol, _currentLayer, false);
         while (true)
         {
-            if (_currentRule == sizeof(reactionSmarts) / sizeof(reactionSmarts[0]))
+            if (_currentRule == _tautomer_rules_count)
             {
                 _currentRule = 0;
                 break;
             }
-            const char* rule = reactionSmarts[_currentRule++];
+            const char* rule = _tautomer_rules[_currentRule++];
             QueryReaction reaction;
             AutoPtr<Scanner> _scanner(new BufferScanner(rule));
             RSmilesLoader loader(*_scanner.get());
@@ -606,3 +613,271 @@ void TautomerEnumerator::constructMolecule(Molecule& molecule, int layer, bool n
 {
     layeredMolecules.constructMolecule(molecule, layer, needAromatize);
 }
+
+//
+// TautomerStreamEnumerator
+//
+
+IMPL_ERROR(TautomerStreamEnumerator, "tautomer stream enumerator");
+
+TautomerStreamEnumerator::TautomerStreamEnumerator(Molecule& molecule)
+    : max_queue(0), max_tautomers(0), max_seen(1 << 20), aromatized(false), _head(0), _emitted(0), _expanded(NULL), _count(0), _truncated(false)
+{
+    // The clone has compact indices, so every molecule constructed from
+    // the prototype has the same edge numbering
+    _proto.clone(molecule, NULL, NULL);
+    _proto.dearomatize(AromaticityOptions());
+    _proto.clearXyz();
+
+    // A tautomer is stored as the bond orders followed by the hydrogen counts
+    // of the atoms: the rules move hydrogens, so both are needed to restore it
+    _stride = std::max(_proto.edgeEnd() + _proto.vertexEnd(), 1);
+
+    for (int i = 0; i < _tautomer_rules_count; i++)
+    {
+        BufferScanner scanner(_tautomer_rules[i]);
+        RSmilesLoader loader(scanner);
+        loader.smarts_mode = true;
+        loader.loadQueryReaction(_rules.push());
+    }
+
+    _product_orders.clear_resize(_stride);
+    _product_orders.zerofill();
+    for (auto i : _proto.edges())
+        _product_orders[i] = _proto.getBondOrder(i);
+    for (auto i : _proto.vertices())
+        _product_orders[_proto.edgeEnd() + i] = _proto.getImplicitH_NoThrow(i, -1);
+    _enqueue(_product_orders.ptr());
+}
+
+TautomerStreamEnumerator::~TautomerStreamEnumerator()
+{
+}
+
+bool TautomerStreamEnumerator::isTruncated() const
+{
+    return _truncated;
+}
+
+int TautomerStreamEnumerator::count() const
+{
+    return _count;
+}
+
+qword TautomerStreamEnumerator::_hashOrders(const char* orders, int length)
+{
+    // FNV-1a
+    qword hash = 14695981039346656037ULL;
+    for (int i = 0; i < length; i++)
+    {
+        hash ^= (byte)orders[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void TautomerStreamEnumerator::_construct(Molecule& molecule, const char* orders) const
+{
+    molecule.clone(const_cast<Molecule&>(_proto), NULL, NULL);
+    for (auto i : molecule.edges())
+        molecule.setBondOrder(i, orders[i]);
+
+    // The hydrogens are set explicitly: the cached counts of the prototype
+    // are wrong for the atoms that lost or gained the mobile hydrogen
+    const char* hydrogens = orders + molecule.edgeEnd();
+    for (auto i : molecule.vertices())
+    {
+        if (hydrogens[i] >= 0)
+            molecule.setImplicitH(i, hydrogens[i]);
+    }
+}
+
+void TautomerStreamEnumerator::_enqueue(const char* orders)
+{
+    qword hash = _hashOrders(orders, _stride);
+    if (_seen.find(hash))
+        return;
+
+    // Every returned tautomer is taken from the queue, so this bounds
+    // _seen_aromatized as well
+    if (max_seen > 0 && _seen.size() >= max_seen)
+    {
+        _truncated = true;
+        return;
+    }
+
+    // The dropped tautomer is not marked as seen: it can be found again
+    // later, when there is a free space in the queue
+    if (max_queue > 0 && _queue.size() / _stride - _head >= max_queue)
+    {
+        _truncated = true;
+        return;
+    }
+
+    _seen.insert(hash);
+    _queue.concat(orders, _stride);
+}
+
+void TautomerStreamEnumerator::_compact()
+{
+    // All the tautomers before _head are both expanded and returned
+    int expanded = _head * _stride;
+    if (expanded < 4096 || expanded < _queue.size() / 2)
+        return;
+
+    _queue.remove(0, expanded);
+    _emitted -= _head;
+    _head = 0;
+}
+
+void TautomerStreamEnumerator::_product_proc(Molecule& product, Array<int>& monomers_indices, Array<int>& mapping, void* userdata)
+{
+    TautomerStreamEnumerator& self = *(TautomerStreamEnumerator*)userdata;
+
+    QS_DEF(Array<int>, mapping_inverse);
+    mapping_inverse.clear_resize(product.vertexEnd());
+    mapping_inverse.fffill();
+    for (int i = 0; i < mapping.size(); i++)
+    {
+        if (mapping[i] >= 0)
+            mapping_inverse[mapping[i]] = i;
+    }
+
+    Array<char>& orders = self._product_orders;
+    orders.clear_resize(self._stride);
+    orders.zerofill();
+
+    // The atoms that are not in the product keep their hydrogens
+    int edge_end = self._proto.edgeEnd();
+    memcpy(orders.ptr() + edge_end, self._expanded + edge_end, self._stride - edge_end);
+    for (auto v_idx : product.vertices())
+    {
+        int proto_idx = mapping_inverse[v_idx];
+        if (proto_idx >= 0 && proto_idx < self._proto.vertexEnd())
+            orders[edge_end + proto_idx] = product.getImplicitH_NoThrow(v_idx, -1);
+    }
+
+    for (auto e_idx : product.edges())
+    {
+        const Edge& edge = product.getEdge(e_idx);
+        int beg = mapping_inverse[edge.beg];
+        int end = mapping_inverse[edge.end];
+        if (beg == -1 || end == -1)
+            continue;
+        int proto_idx = self._proto.findEdgeIndex(beg, end);
+        // Tautomerization rules never create new bonds between the mapped atoms
+        if (proto_idx == -1)
+            return;
+        orders[proto_idx] = product.getBondOrder(e_idx);
+    }
+
+    self._enqueue(orders.ptr());
+}
+
+void TautomerStreamEnumerator::_expand(const char* orders)
+{
+    Molecule mol;
+    _construct(mol, orders);
+    _expanded = orders;
+
+    for (int i = 0; i < _rules.size(); i++)
+    {
+        ReactionProductEnumerator rpe(_rules[i]);
+        rpe.addMonomer(0, mol);
+        rpe.is_multistep_reaction = false;
+        rpe.is_one_tube = true;
+        rpe.is_self_react = true;
+        rpe.max_deep_level = 1;
+        rpe.max_product_count = 10;
+        rpe.refine_proc = TautomerEnumerator::refine_proc;
+        rpe.product_proc = _product_proc;
+        rpe.userdata = this;
+        rpe.buildProducts();
+    }
+}
+
+bool TautomerStreamEnumerator::next(Molecule& tautomer)
+{
+    QS_DEF(Array<char>, orders);
+
+    while (max_tautomers <= 0 || _count < max_tautomers)
+    {
+        if (_emitted < _queue.size() / _stride)
+        {
+            _construct(tautomer, _queue.ptr() + _stride * _emitted++);
+            if (aromatized)
+            {
+                // The hydrogens are set explicitly by _construct(), so they stay
+                // unambiguous for the aromatic heteroatoms
+                tautomer.aromatize(arom_options);
+
+                // The aromatic forms differ by the bond orders and the hydrogens
+                orders.copy(_queue.ptr() + _stride * (_emitted - 1), _stride);
+                for (auto i : tautomer.edges())
+                    orders[i] = tautomer.getBondOrder(i);
+
+                qword hash = _hashOrders(orders.ptr(), _stride);
+                if (_seen_aromatized.find(hash))
+                    continue;
+                _seen_aromatized.insert(hash);
+            }
+            _count++;
+            return true;
+        }
+
+        if (_head >= _queue.size() / _stride)
+            return false;
+
+        // Expansion appends to the queue, so the tautomer is copied first
+        orders.copy(_queue.ptr() + _stride * _head++, _stride);
+        _compact();
+        _expand(orders.ptr());
+    }
+
+    // The limit is reached while there are pending tautomers: some of them
+    // may be new, so the enumeration is not complete
+    if (_emitted < _queue.size() / _stride || _head < _queue.size() / _stride)
+        _truncated = true;
+    return false;
+}
+
+qword TautomerStreamEnumerator::getCanonicalTautomer(Molecule& result, Array<char>& canonical_smiles)
+{
+    QS_DEF(Molecule, tautomer);
+    QS_DEF(Array<char>, smiles);
+
+    // The generic aromaticity model is used: the basic one keeps the forms
+    // like 2-pyridone kekulized
+    bool was_aromatized = aromatized;
+    AromaticityOptions was_options = arom_options;
+    aromatized = true;
+    arom_options.method = AromaticityOptions::GENERIC;
+
+    result.clear();
+    canonical_smiles.clear();
+    while (next(tautomer))
+    {
+        smiles.clear();
+        ArrayOutput output(smiles);
+        CanonicalSmilesSaver saver(output);
+        saver.saveMolecule(tautomer);
+        smiles.push(0);
+
+        if (canonical_smiles.size() == 0 || strcmp(smiles.ptr(), canonical_smiles.ptr()) < 0)
+        {
+            canonical_smiles.copy(smiles);
+            result.clone(tautomer, NULL, NULL);
+        }
+    }
+
+    aromatized = was_aromatized;
+    arom_options = was_options;
+
+    // The minimum over a part of the tautomers depends on the tautomer
+    // the enumeration started from
+    if (_truncated)
+        throw Error("canonical tautomer: enumeration was truncated, the result is not tautomer-invariant");
+    if (canonical_smiles.size() == 0)
+        throw Error("no tautomers were enumerated");
+    return _hashOrders(canonical_smiles.ptr(), canonical_smiles.size() - 1);
+}
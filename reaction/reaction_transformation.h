@@ -42,6 +42,14 @@ namespace indigo
 
         bool transform(ReusableObjArray<Molecule>& molecules, QueryReaction& reaction, ReusableObjArray<Array<int>>* mapping_array = 0);
 
+        // Same as transform(), but takes the reaction already prepared by
+        // mergeReaction(), so the merging step can be done once per reaction
+        bool transformMerged(Molecule& molecule, QueryReaction& merged_reaction, Array<int>* mapping = 0);
+
+        // Merges all reactants and all products of the reaction into
+        // a single reactant and a single product
+        static void mergeReaction(QueryReaction& reaction, QueryReaction& merged_reaction);
+
         AromaticityOptions arom_options;
 
         bool layout_flag;
@@ -59,9 +67,7 @@ namespace indigo
 
         static void _product_proc(Molecule& product, Array<int>& monomers_indices, Array<int>& mapping, void* userdata);
 
-        void _mergeReactionComponents(QueryReaction& reaction, int mol_type, QueryMolecule& merged_molecule, Array<int>& merged_aam);
-
-        void _generateMergedReaction(QueryReaction& reaction);
+        static void _mergeReactionComponents(QueryReaction& reaction, int mol_type, QueryMolecule& merged_molecule, Array<int>& merged_aam);
     };
 } // namespace indigo
 
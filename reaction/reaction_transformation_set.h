@@ -0,0 +1,89 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __reaction_transformation_set__
+#define __reaction_transformation_set__
+
+#include "base_cpp/obj_array.h"
+#include "molecule/molecule_arom.h"
+#include "molecule/molecule_fingerprint.h"
+#include "reaction/query_reaction.h"
+#include "reaction/reaction_transformation.h"
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+namespace indigo
+{
+    // Ordered set of transformations that are prepared once and then
+    // applied to many molecules. Reactions are merged only once, and every
+    // transformation is guarded by a substructure fingerprint of its reactant
+    // side, so the transformations that cannot match are skipped without
+    // running the embedding enumerator. Transformations with equal
+    // fingerprints share one screening check per molecule.
+    //
+    // apply() does not modify the set, but it is not safe to call it for
+    // the same set from several threads: use clone() to get a copy per thread.
+    class DLLEXPORT ReactionTransformationSet
+    {
+    public:
+        DECL_ERROR;
+
+        ReactionTransformationSet();
+
+        void clear();
+
+        // Options that are used for screening. Should be set before add()
+        AromaticityOptions arom_options;
+        MoleculeFingerprintParameters fp_params;
+
+        void add(QueryReaction& reaction);
+        void clone(ReactionTransformationSet& other);
+
+        int count() const;
+        QueryReaction& getMergedReaction(int idx);
+
+        // Applies all transformations in order and returns the number
+        // of transformations that changed the molecule.
+        // Indices of such transformations are stored into "applied", if given.
+        int apply(Molecule& molecule, ReactionTransformation& rt, Array<int>* applied = 0);
+
+        // Statistics collected by apply()
+        int screened_out;
+        int attempted;
+
+    private:
+        void _buildQueryScreen(QueryReaction& merged_reaction, Array<byte>& fp);
+        void _buildTargetScreen(Molecule& molecule, Array<byte>& fp);
+        int _findOrAddScreen(const Array<byte>& fp);
+
+        ObjArray<QueryReaction> _reactions;
+        // Screen index for every reaction, or -1 if the reactant
+        // does not have any bits to screen by
+        Array<int> _screen_ids;
+        ObjArray<Array<byte>> _screens;
+    };
+} // namespace indigo
+
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+#endif /* __reaction_transformation_set__ */
@@ -39,17 +39,22 @@ ReactionTransformation::ReactionTransformation(void) : CP_INIT, TL_CP_GET(_merge
 
 bool ReactionTransformation::transform(Molecule& molecule, QueryReaction& reaction, Array<int>* mapping)
 {
-    _generateMergedReaction(reaction);
+    mergeReaction(reaction, _merged_reaction);
 
-    int reactant_idx = _merged_reaction.reactantBegin();
-    int product_idx = _merged_reaction.productBegin();
+    return transformMerged(molecule, _merged_reaction, mapping);
+}
+
+bool ReactionTransformation::transformMerged(Molecule& molecule, QueryReaction& merged_reaction, Array<int>* mapping)
+{
+    int reactant_idx = merged_reaction.reactantBegin();
+    int product_idx = merged_reaction.productBegin();
 
     bool has_coord = BaseMolecule::hasCoord(molecule);
 
     QS_DEF(QueryMolecule, cur_full_product);
     cur_full_product.clear();
-    cur_full_product.clone(_merged_reaction.getQueryMolecule(product_idx), NULL, NULL);
-    Array<int>& cur_cur_monomer_aam_array = _merged_reaction.getAAMArray(product_idx);
+    cur_full_product.clone(merged_reaction.getQueryMolecule(product_idx), NULL, NULL);
+    Array<int>& cur_cur_monomer_aam_array = merged_reaction.getAAMArray(product_idx);
     QS_DEF(RedBlackStringMap<int>, cur_smiles_array);
     cur_smiles_array.clear();
     QS_DEF(ReactionEnumeratorState::ReactionMonomers, cur_reaction_monomers);
@@ -63,7 +68,7 @@ bool ReactionTransformation::transform(Molecule& molecule, QueryReaction& reacti
     ReactionEnumeratorContext context;
     context.arom_options = arom_options;
 
-    ReactionEnumeratorState re_state(context, _merged_reaction, cur_full_product, cur_cur_monomer_aam_array, cur_smiles_array, cur_reaction_monomers,
+    ReactionEnumeratorState re_state(context, merged_reaction, cur_full_product, cur_cur_monomer_aam_array, cur_smiles_array, cur_reaction_monomers,
                                      product_count, cur_tubes_monomers);
 
     re_state.is_multistep_reaction = false;
@@ -114,7 +119,8 @@ bool ReactionTransformation::transform(Molecule& molecule, QueryReaction& reacti
             molecule.stereocenters.markBonds();
     }
 
-    mapping->copy(_mapping);
+    if (mapping != 0)
+        mapping->copy(_mapping);
 
     return transformed_flag;
 }
@@ -163,7 +169,7 @@ void ReactionTransformation::_mergeReactionComponents(QueryReaction& reaction, i
     }
 }
 
-void ReactionTransformation::_generateMergedReaction(QueryReaction& reaction)
+void ReactionTransformation::mergeReaction(QueryReaction& reaction, QueryReaction& merged_reaction)
 {
     QS_DEF(QueryMolecule, merged_reactant);
     merged_reactant.clear();
@@ -183,22 +189,22 @@ void ReactionTransformation::_generateMergedReaction(QueryReaction& reaction)
     // Products merging
     _mergeReactionComponents(reaction, BaseReaction::PRODUCT, merged_cur_monomer, product_aam);
 
-    _merged_reaction.clear();
+    merged_reaction.clear();
 
-    int reactant_idx = _merged_reaction.addReactant();
-    int product_idx = _merged_reaction.addProduct();
+    int reactant_idx = merged_reaction.addReactant();
+    int product_idx = merged_reaction.addProduct();
 
-    QueryMolecule& reactant = _merged_reaction.getQueryMolecule(reactant_idx);
-    QueryMolecule& product = _merged_reaction.getQueryMolecule(product_idx);
+    QueryMolecule& reactant = merged_reaction.getQueryMolecule(reactant_idx);
+    QueryMolecule& product = merged_reaction.getQueryMolecule(product_idx);
 
     reactant.clone(merged_reactant, NULL, NULL);
     product.clone(merged_cur_monomer, NULL, NULL);
 
-    Array<int>& r_aam = _merged_reaction.getAAMArray(reactant_idx);
+    Array<int>& r_aam = merged_reaction.getAAMArray(reactant_idx);
     r_aam.clear();
     r_aam.concat(reactant_aam);
 
-    Array<int>& p_aam = _merged_reaction.getAAMArray(product_idx);
+    Array<int>& p_aam = merged_reaction.getAAMArray(product_idx);
     p_aam.clear();
     p_aam.concat(product_aam);
 }
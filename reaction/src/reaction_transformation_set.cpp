@@ -0,0 +1,184 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "reaction/reaction_transformation_set.h"
+#include "base_c/bitarray.h"
+#include "molecule/query_molecule.h"
+
+using namespace indigo;
+
+IMPL_ERROR(ReactionTransformationSet, "reaction transformation set");
+
+ReactionTransformationSet::ReactionTransformationSet()
+{
+    fp_params.ext = false;
+    fp_params.similarity_type = SimilarityType::SIM;
+    fp_params.ord_qwords = 25;
+    fp_params.any_qwords = 15;
+    fp_params.tau_qwords = 0;
+    fp_params.sim_qwords = 0;
+
+    clear();
+}
+
+void ReactionTransformationSet::clear()
+{
+    _reactions.clear();
+    _screen_ids.clear();
+    _screens.clear();
+    screened_out = 0;
+    attempted = 0;
+}
+
+int ReactionTransformationSet::count() const
+{
+    return _reactions.size();
+}
+
+QueryReaction& ReactionTransformationSet::getMergedReaction(int idx)
+{
+    return _reactions[idx];
+}
+
+void ReactionTransformationSet::add(QueryReaction& reaction)
+{
+    QueryReaction& merged = _reactions.push();
+    ReactionTransformation::mergeReaction(reaction, merged);
+
+    QS_DEF(Array<byte>, fp);
+    _buildQueryScreen(merged, fp);
+
+    if (bitIsAllZero(fp.ptr(), fp.size()))
+        _screen_ids.push(-1);
+    else
+        _screen_ids.push(_findOrAddScreen(fp));
+}
+
+void ReactionTransformationSet::clone(ReactionTransformationSet& other)
+{
+    clear();
+
+    arom_options = other.arom_options;
+    fp_params = other.fp_params;
+
+    for (int i = 0; i < other._reactions.size(); i++)
+        _reactions.push().clone(other._reactions[i], NULL, NULL, NULL);
+
+    _screen_ids.copy(other._screen_ids);
+    for (int i = 0; i < other._screens.size(); i++)
+        _screens.push().copy(other._screens[i]);
+}
+
+int ReactionTransformationSet::_findOrAddScreen(const Array<byte>& fp)
+{
+    for (int i = 0; i < _screens.size(); i++)
+        if (_screens[i].memcmp(fp) == 0)
+            return i;
+
+    _screens.push().copy(fp);
+    return _screens.size() - 1;
+}
+
+void ReactionTransformationSet::_buildQueryScreen(QueryReaction& merged_reaction, Array<byte>& fp)
+{
+    QS_DEF(QueryMolecule, reactant);
+    reactant.clone(merged_reaction.getQueryMolecule(merged_reaction.reactantBegin()), NULL, NULL);
+
+    // R-sites can be mapped onto the same target atom (see
+    // ReactionEnumeratorState), so they are not a part of the screen
+    QS_DEF(Array<int>, rsites);
+    rsites.clear();
+    for (int i = reactant.vertexBegin(); i != reactant.vertexEnd(); i = reactant.vertexNext(i))
+        if (reactant.isRSite(i))
+            rsites.push(i);
+    reactant.removeAtoms(rsites);
+
+    reactant.aromatize(arom_options);
+
+    MoleculeFingerprintBuilder builder(reactant, fp_params);
+    builder.parseFingerprintType("sub", true);
+    builder.skip_ext = true;
+    builder.process();
+
+    fp.copy(builder.get(), fp_params.fingerprintSize());
+}
+
+void ReactionTransformationSet::_buildTargetScreen(Molecule& molecule, Array<byte>& fp)
+{
+    QS_DEF(Molecule, target);
+    target.clone(molecule, NULL, NULL);
+    target.aromatize(arom_options);
+
+    MoleculeFingerprintBuilder builder(target, fp_params);
+    builder.parseFingerprintType("sub", false);
+    builder.skip_ext = true;
+    builder.process();
+
+    fp.copy(builder.get(), fp_params.fingerprintSize());
+}
+
+int ReactionTransformationSet::apply(Molecule& molecule, ReactionTransformation& rt, Array<int>* applied)
+{
+    QS_DEF(Array<byte>, target_fp);
+    // Screening result for each screen: -1 if not checked yet, 0 or 1 otherwise
+    QS_DEF(Array<int>, screen_passed);
+    bool target_fp_valid = false;
+
+    if (applied != 0)
+        applied->clear();
+
+    int applied_count = 0;
+    for (int i = 0; i < _reactions.size(); i++)
+    {
+        int screen_idx = _screen_ids[i];
+        if (screen_idx >= 0)
+        {
+            if (!target_fp_valid)
+            {
+                _buildTargetScreen(molecule, target_fp);
+                screen_passed.clear_resize(_screens.size());
+                screen_passed.fffill();
+                target_fp_valid = true;
+            }
+
+            if (screen_passed[screen_idx] < 0)
+            {
+                const Array<byte>& query_fp = _screens[screen_idx];
+                screen_passed[screen_idx] = bitTestOnes(query_fp.ptr(), target_fp.ptr(), query_fp.size()) ? 1 : 0;
+            }
+
+            if (screen_passed[screen_idx] == 0)
+            {
+                screened_out++;
+                continue;
+            }
+        }
+
+        attempted++;
+        if (rt.transformMerged(molecule, _reactions[i]))
+        {
+            applied_count++;
+            if (applied != 0)
+                applied->push(i);
+            // Molecule has changed, so the fingerprint has to be rebuilt
+            target_fp_valid = false;
+        }
+    }
+
+    return applied_count;
+}
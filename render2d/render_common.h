@@ -513,6 +513,12 @@ namespace indigo
         MultilineTextLayout titleAlign;
 
         int gridColumnNumber;
+        // Least number of grid rows, so that all pages of a document have the
+        // same layout; 0 - as many as the objects take
+        int gridRowNumber;
+        // Threads that lay out the grid structures: 0 - the calling thread only,
+        // -1 - select automatically
+        int gridThreads;
 
     private:
         CanvasOptions(const CanvasOptions&);
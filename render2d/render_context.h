@@ -24,6 +24,8 @@
 #include <cairo.h>
 
 #include "render_common.h"
+#include "render_font_cache.h"
+#include "render_surface_backend.h"
 
 namespace indigo
 {
@@ -48,6 +50,15 @@ namespace indigo
         void initNullContext();
         void initContext(int width, int height);
         void closeContext(bool discard);
+        // Between beginPages() and endPages() every context opened with
+        // initContext() is a page of the same PDF or SVG document, and
+        // closeContext() finishes the page and keeps the document open
+        void beginPages();
+        void endPages(bool discard);
+        void initRecordingContext(const Vec2f& size);
+        cairo_surface_t* closeRecordingContext();
+        void drawRecording(cairo_surface_t* recording, float recordingScale);
+        float getDefaultScale() const;
         void translate(float dx, float dy);
         void scale(float s);
         void storeTransform();
@@ -206,14 +217,17 @@ namespace indigo
         void* _h_fonts[FONT_SIZE_COUNT * 2];
 #endif
 
-        cairo_font_face_t *cairoFontFaceRegular, *cairoFontFaceBold;
-        cairo_matrix_t fontScale, fontCtm;
         cairo_font_options_t* fontOptions;
-        cairo_scaled_font_t* _scaled_fonts[FONT_SIZE_COUNT * 2];
+        RenderFontCache& _fontCache;
 
-        bool metafileFontsToCurves;
+        bool fontsToCurves;
+        bool _recordingFontsToCurves;
+        bool _pages;
         cairo_t* _cr;
         cairo_surface_t* _surface;
+        cairo_surface_t* _document;
+        // Backend of the open surface, NULL for the Windows modes
+        RenderSurfaceBackend* _backend;
         void* _meta_hdc;
 
     public:
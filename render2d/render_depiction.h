@@ -0,0 +1,75 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __render_depiction_h__
+#define __render_depiction_h__
+
+#include "base_cpp/auto_ptr.h"
+#include "math/algebra.h"
+
+typedef struct _cairo_surface cairo_surface_t;
+
+namespace indigo
+{
+
+    class BaseMolecule;
+    class BaseReaction;
+
+    // A molecule or a reaction prepared for repeated rendering. The first
+    // render records the drawing of the structure in its own coordinates,
+    // along with its measured size. Later renders replay the recording at any
+    // scale and into any output format, skipping label layout, text measurement
+    // and bond geometry. The recording keeps the render options that were in
+    // effect when it was made; clear() drops it.
+    class RenderDepiction
+    {
+    public:
+        RenderDepiction();
+        ~RenderDepiction();
+
+        bool isRecorded() const
+        {
+            return recording != NULL;
+        }
+        void clear();
+
+        // Copies the structure and shares the recording
+        void copy(const RenderDepiction& other);
+
+        AutoPtr<BaseMolecule> mol;
+        AutoPtr<BaseReaction> rxn;
+
+        cairo_surface_t* recording;
+        float recordingScale;
+        Vec2f size;
+        Vec2f origin;
+        float referenceY;
+
+        // Metrics used to choose the object scale; negative until known
+        int bondCount;
+        int atomCount;
+        float totalBondLength;
+        float totalClosestAtomDistance;
+
+    private:
+        RenderDepiction(const RenderDepiction&);
+    };
+
+} // namespace indigo
+
+#endif //__render_depiction_h__
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __render_font_cache_h__
+#define __render_font_cache_h__
+
+#include <cairo.h>
+#include <string>
+#include <unordered_map>
+
+#include "base_cpp/array.h"
+
+namespace indigo
+{
+    // Font state shared by all the render contexts of a session. Cairo keeps
+    // the glyph caches inside the font faces and scaled fonts, so holding them
+    // here lets a sequence of renders (thumbnails, grids) reuse glyphs instead
+    // of resolving the font family and measuring every label from scratch.
+    class RenderFontCache
+    {
+    public:
+        RenderFontCache();
+        ~RenderFontCache();
+
+        // Returns a font face for the family; the reference is owned by the cache
+        cairo_font_face_t* getFontFace(const char* family, bool bold);
+
+        // Text extents for the font currently selected in cr, cached by the font,
+        // the transformation matrix and the target surface type
+        void getTextExtents(cairo_t* cr, const char* text, cairo_text_extents_t& te);
+
+        void clear();
+
+        static RenderFontCache& getInstance();
+
+    private:
+        enum
+        {
+            MAX_EXTENTS = 16384
+        };
+
+        Array<char> _family;
+        cairo_font_face_t* _faces[2];
+        std::string _key;
+        std::unordered_map<std::string, cairo_text_extents_t> _extents;
+
+        RenderFontCache(const RenderFontCache&);
+    };
+
+} // namespace indigo
+
+#endif //__render_font_cache_h__
@@ -23,6 +23,7 @@
 #include "render_item.h"
 #include "render_item_aux.h"
 #include "render_item_column.h"
+#include "render_item_depiction.h"
 #include "render_item_fragment.h"
 #include "render_item_hline.h"
 #include "render_item_molecule.h"
@@ -79,6 +80,7 @@ namespace indigo
             TYPE_Molecule,
             TYPE_Reaction,
             TYPE_Comment,
+            TYPE_Depiction,
         };
 
         RenderItemBase& getItem(int i)
@@ -92,6 +94,7 @@ namespace indigo
                 GET_ITEM(Column);
                 GET_ITEM(Molecule);
                 GET_ITEM(Reaction);
+                GET_ITEM(Depiction);
             default:
                 throw Error("Item type unrecognized");
             }
@@ -103,6 +106,7 @@ namespace indigo
         IMPL_ITEM(Column);
         IMPL_ITEM(Molecule);
         IMPL_ITEM(Reaction);
+        IMPL_ITEM(Depiction);
 
         RenderContext& rc;
 
@@ -122,6 +126,7 @@ namespace indigo
         DEF_POOL(Column);
         DEF_POOL(Molecule);
         DEF_POOL(Reaction);
+        DEF_POOL(Depiction);
 
         ObjPool<Item> _items;
     };
@@ -30,11 +30,14 @@ namespace indigo
     class Scanner;
     class Output;
     class RenderItemFactory;
+    class RenderDepiction;
+    class RenderContext;
 
     enum RENDER_MODE
     {
         RENDER_MOL,
         RENDER_RXN,
+        RENDER_DEPICTION,
         RENDER_NONE
     };
 
@@ -58,6 +61,10 @@ namespace indigo
         PtrArray<BaseMolecule> mols;
         PtrArray<BaseReaction> rxns;
 
+        // Prepared depictions are owned by the caller
+        RenderDepiction* depiction;
+        Array<RenderDepiction*> depictions;
+
         ObjArray<Array<char>> titles;
         Array<int> refAtoms;
 
@@ -65,6 +72,19 @@ namespace indigo
         CanvasOptions cnvOpt;
     };
 
+    // Supplies the objects of a multi-page grid one page at a time
+    class RenderPageSource
+    {
+    public:
+        virtual ~RenderPageSource()
+        {
+        }
+
+        // Fills the objects of the next page and their titles into the params;
+        // returns false when there are no objects left
+        virtual bool nextPage(RenderParams& params) = 0;
+    };
+
     class RenderParamInterface
     {
     public:
@@ -72,10 +92,19 @@ namespace indigo
         static void render(RenderParams& params);
         static int multilineTextUnit(RenderItemFactory& factory, int type, const Array<char>& titleStr, const float spacing,
                                      const MultilineTextLayout::Alignment alignment);
+        // Lays out a molecule or a reaction of a grid; the molecules go first.
+        // Different objects can be prepared concurrently.
+        static void prepareGridObject(RenderParams& params, int index);
+        // Renders a grid into a PDF or SVG document page by page, so that only
+        // the objects of one page are held at a time. Returns the number of pages.
+        static int renderPages(RenderParams& params, RenderPageSource& source);
 
     private:
+        static bool _renderObjects(RenderParams& params, RenderContext& rc);
         static void _prepareMolecule(RenderParams& params, BaseMolecule& bm);
         static void _prepareReaction(RenderParams& params, BaseReaction& rxn);
+        static int _addDepictionItem(RenderParams& params, RenderItemFactory& factory, RenderDepiction& depiction);
+        static void _prepareGridObjects(RenderParams& params);
         static bool needsLayoutSub(BaseMolecule& mol);
         static bool needsLayout(BaseMolecule& mol);
         RenderParamInterface();
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __render_png_h__
+#define __render_png_h__
+
+#include <cairo.h>
+#include <zlib.h>
+
+#include "base_cpp/array.h"
+#include "base_cpp/exception.h"
+#include "render_surface_backend.h"
+
+namespace indigo
+{
+    class Output;
+
+    // PNG writer for Cairo image surfaces. Structure depictions are mostly
+    // flat background with thin lines, which deflate compresses well without
+    // any row filtering, so rows are stored unfiltered at a low compression
+    // level. This is several times faster than cairo_surface_write_to_png(),
+    // which runs the adaptive libpng filters at the default zlib level, and
+    // produces the same pixels. The deflate state and the row buffer are kept
+    // between images of a session.
+    class RenderPngEncoder
+    {
+    public:
+        DECL_ERROR;
+
+        RenderPngEncoder();
+        ~RenderPngEncoder();
+
+        void write(cairo_surface_t* surface, Output& output);
+
+        static RenderPngEncoder& getInstance();
+
+    private:
+        void _writeChunk(Output& output, const char* type, const byte* data, int length);
+        void _deflate(Output& output, const byte* data, int length, int flush);
+
+        z_stream _zs;
+        bool _zsInit;
+        Array<byte> _row;
+        Array<byte> _idat;
+
+        RenderPngEncoder(const RenderPngEncoder&);
+    };
+
+    // PNG backend of RenderContext. Images are drawn on an image surface and
+    // written with RenderPngEncoder. The surface of the last written image is
+    // kept in the session and is cleared and reused by the next image of the
+    // same size, so thumbnails do not allocate a surface per image.
+    class RenderPngBackend : public RenderSurfaceBackend
+    {
+    public:
+        virtual cairo_surface_t* createSurface(cairo_write_func_t writer, void* closure, int width, int height);
+        virtual void closeSurface(cairo_surface_t* surface, Output* output, bool discard);
+    };
+
+} // namespace indigo
+
+#endif //__render_png_h__
@@ -0,0 +1,58 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#ifndef __render_surface_backend_h__
+#define __render_surface_backend_h__
+
+#include <cairo.h>
+
+#include "base_cpp/exception.h"
+
+namespace indigo
+{
+    class Output;
+
+    // Output format backend of RenderContext. It creates the surface an image
+    // is drawn on and writes the image when the context is closed. Backends
+    // are shared by all sessions and keep their per-session state in
+    // session-local containers. Windows modes (EMF, HDC, printing) have no
+    // backend and are handled by RenderContext itself.
+    class RenderSurfaceBackend
+    {
+    public:
+        DECL_ERROR;
+
+        virtual ~RenderSurfaceBackend();
+
+        // The writer is NULL for the contexts that only measure the drawing
+        virtual cairo_surface_t* createSurface(cairo_write_func_t writer, void* closure, int width, int height) = 0;
+        // Takes the surface of a closed context and writes the image unless it is discarded
+        virtual void closeSurface(cairo_surface_t* surface, Output* output, bool discard) = 0;
+        // Text is drawn as paths instead of glyphs
+        virtual bool textToCurves() const;
+
+        // Returns NULL if the mode has no backend
+        static RenderSurfaceBackend* get(int mode);
+        // Replaces the backend of the mode and takes ownership of it. NULL
+        // restores the built-in backend. Must not be called while rendering.
+        static void set(int mode, RenderSurfaceBackend* backend);
+    };
+
+} // namespace indigo
+
+#endif //__render_surface_backend_h__
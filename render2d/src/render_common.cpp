@@ -341,6 +341,8 @@ void CanvasOptions::clear()
     titleAlign.clear();
     titleOffset = 0;
     gridColumnNumber = 1;
+    gridRowNumber = 0;
+    gridThreads = 0;
     comment.clear();
     titleProp.clear();
     titleProp.appendString("^NAME", true);
@@ -23,6 +23,7 @@
 #include "molecule/molecule.h"
 #include "reaction/reaction.h"
 
+#include <algorithm>
 #include <limits.h>
 
 using namespace indigo;
@@ -119,7 +120,8 @@ void RenderContext::storeAndDestroyMetafile(bool discard)
 CP_DEF(RenderContext);
 
 RenderContext::RenderContext(const RenderOptions& ropt, float sf, float lwf)
-    : CP_INIT, TL_CP_GET(_fontfamily), TL_CP_GET(transforms), metafileFontsToCurves(false), _cr(NULL), _surface(NULL), _meta_hdc(NULL), opt(ropt),
+    : CP_INIT, TL_CP_GET(_fontfamily), TL_CP_GET(transforms), fontOptions(NULL), _fontCache(RenderFontCache::getInstance()), fontsToCurves(false),
+      _recordingFontsToCurves(false), _pages(false), _cr(NULL), _surface(NULL), _document(NULL), _backend(NULL), _meta_hdc(NULL), opt(ropt),
       _pattern(NULL)
 {
     _settings.init(sf, lwf);
@@ -185,6 +187,11 @@ void RenderContext::setDefaultScale(float scale)
     _defaultScale = scale;
 }
 
+float RenderContext::getDefaultScale() const
+{
+    return _defaultScale;
+}
+
 void RenderContext::setFontFamily(const char* ff)
 {
     bprintf(_fontfamily, "%s", ff);
@@ -215,22 +222,21 @@ void RenderContext::createSurface(cairo_write_func_t writer, Output* output, int
     int mode = opt.mode;
     if (writer == NULL && (mode == MODE_HDC || mode == MODE_PRN))
         mode = MODE_PDF;
-    switch (mode)
-    {
-    case MODE_NONE:
+    if (mode == MODE_NONE)
         throw Error("mode not set");
-    case MODE_PDF:
-        _surface = cairo_pdf_surface_create_for_stream(writer, opt.output, _width, _height);
-        cairoCheckSurfaceStatus();
-        break;
-    case MODE_SVG:
-        _surface = cairo_svg_surface_create_for_stream(writer, opt.output, _width, _height);
-        cairoCheckSurfaceStatus();
-        break;
-    case MODE_PNG:
-        _surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, _width, _height);
+
+    _backend = RenderSurfaceBackend::get(mode);
+    if (_backend != NULL)
+    {
+        _surface = _backend->createSurface(writer, opt.output, _width, _height);
         cairoCheckSurfaceStatus();
-        break;
+        if (_backend->textToCurves())
+            fontsToCurves = true;
+        return;
+    }
+
+    switch (mode)
+    {
     case MODE_HDC:
 #ifdef _WIN32
         _surface = createWin32Surface();
@@ -250,7 +256,7 @@ void RenderContext::createSurface(cairo_write_func_t writer, Output* output, int
         bool isLarge;
         _surface = createWin32PrintingSurfaceForMetafile(isLarge);
         if (isLarge)
-            metafileFontsToCurves = true;
+            fontsToCurves = true;
 #else
         throw Error("mode \"EMF\" is not supported on this platform");
 #endif
@@ -272,15 +278,7 @@ void RenderContext::init()
 {
     fontsInit();
 
-    cairo_text_extents_t te;
-    cairo_select_font_face(_cr, _fontfamily.ptr(), CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-    cairoCheckStatus();
-    cairo_set_font_size(_cr, _settings.fzz[FONT_SIZE_ATTR]);
-    cairoCheckStatus();
-    _tlock.lock();
-    cairo_text_extents(_cr, "N", &te);
-    _tlock.unlock();
-    cairoCheckStatus();
+    fontsSetFont(_cr, FONT_SIZE_ATTR, false);
 
     cairo_set_antialias(_cr, CAIRO_ANTIALIAS_GRAY);
     cairoCheckStatus();
@@ -317,7 +315,25 @@ void RenderContext::initContext(int width, int height)
     if (_surface != NULL || _cr != NULL)
         throw Error("context is already open (or invalid)");
 
-    createSurface(writer, opt.output, _width, _height);
+    if (_document != NULL)
+    {
+        _surface = _document;
+        // SVG pages share the size of the document
+        if (opt.mode == MODE_PDF)
+            cairo_pdf_surface_set_size(_surface, _width, _height);
+        cairoCheckSurfaceStatus();
+    }
+    else
+    {
+        createSurface(writer, opt.output, _width, _height);
+        if (_pages)
+        {
+            // Earlier SVG versions only keep the last page of a document
+            if (opt.mode == MODE_SVG)
+                cairo_svg_surface_restrict_to_version(_surface, CAIRO_SVG_VERSION_1_2);
+            _document = _surface;
+        }
+    }
     _cr = cairo_create(_surface);
     if (opt.backgroundColor.x >= 0 && opt.backgroundColor.y >= 0 && opt.backgroundColor.z >= 0)
         fillBackground();
@@ -325,22 +341,45 @@ void RenderContext::initContext(int width, int height)
 
 void RenderContext::closeContext(bool discard)
 {
+    if (_surface != NULL && _surface == _document)
+    {
+        if (_cr != NULL)
+        {
+            cairo_show_page(_cr);
+            cairo_destroy(_cr);
+            _cr = NULL;
+        }
+        cairoCheckSurfaceStatus();
+        _surface = NULL;
+        bbmin.x = bbmin.y = 1;
+        bbmax.x = bbmax.y = -1;
+        fontsDispose();
+        return;
+    }
+
     if (_cr != NULL)
     {
         cairo_destroy(_cr);
         _cr = NULL;
     }
 
+    if (_backend != NULL)
+    {
+        cairo_surface_t* surface = _surface;
+        RenderSurfaceBackend* backend = _backend;
+        _surface = NULL;
+        _backend = NULL;
+        bbmin.x = bbmin.y = 1;
+        bbmax.x = bbmax.y = -1;
+        fontsDispose();
+        backend->closeSurface(surface, opt.output, discard);
+        return;
+    }
+
     switch (opt.mode)
     {
     case MODE_NONE:
         throw Error("mode not set");
-    case MODE_PNG:
-        if (!discard)
-            cairo_surface_write_to_png_stream(_surface, writer, opt.output);
-        break;
-    case MODE_PDF:
-    case MODE_SVG:
     case MODE_HDC:
     case MODE_PRN:
         break;
@@ -365,6 +404,87 @@ void RenderContext::closeContext(bool discard)
     fontsDispose();
 }
 
+void RenderContext::beginPages()
+{
+    if (opt.mode != MODE_PDF && opt.mode != MODE_SVG)
+        throw Error("multi-page output is only supported for PDF and SVG");
+    if (_surface != NULL || _cr != NULL)
+        throw Error("context is already open (or invalid)");
+    _pages = true;
+}
+
+void RenderContext::endPages(bool discard)
+{
+    _pages = false;
+    if (_cr != NULL)
+    {
+        cairo_destroy(_cr);
+        _cr = NULL;
+    }
+    if (_surface != NULL && _surface != _document)
+        cairo_surface_destroy(_surface);
+    _surface = NULL;
+
+    if (_document != NULL)
+    {
+        cairo_surface_t* document = _document;
+        _document = NULL;
+        _backend = NULL;
+        RenderSurfaceBackend::get(opt.mode)->closeSurface(document, opt.output, discard);
+    }
+}
+
+void RenderContext::initRecordingContext(const Vec2f& size)
+{
+    if (_surface != NULL || _cr != NULL)
+        throw Error("context is already open (or invalid)");
+
+    // The SVG and PDF surfaces can not replay an unbounded recording, so it is
+    // bounded by the item size with a wide margin for the line caps and labels.
+    // Cairo does not replay bounded recordings with a negative origin, so the
+    // margin is a device offset instead.
+    double margin = std::max(size.x, size.y) * _defaultScale;
+    cairo_rectangle_t extents = {0, 0, size.x * _defaultScale + 2 * margin, size.y * _defaultScale + 2 * margin};
+    _surface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+    cairo_surface_set_device_offset(_surface, margin, margin);
+    cairoCheckSurfaceStatus();
+    _cr = cairo_create(_surface);
+    scale(_defaultScale);
+
+    // The recording is replayed into surfaces of any type, so the text is
+    // stored as outlines, as for SVG
+    _recordingFontsToCurves = fontsToCurves;
+    fontsToCurves = true;
+    init();
+}
+
+cairo_surface_t* RenderContext::closeRecordingContext()
+{
+    cairo_surface_t* recording = _surface;
+    if (_cr != NULL)
+    {
+        cairo_destroy(_cr);
+        _cr = NULL;
+    }
+    _surface = NULL;
+
+    fontsToCurves = _recordingFontsToCurves;
+    bbmin.x = bbmin.y = 1;
+    bbmax.x = bbmax.y = -1;
+    fontsDispose();
+    return recording;
+}
+
+void RenderContext::drawRecording(cairo_surface_t* recording, float recordingScale)
+{
+    cairo_save(_cr);
+    cairo_scale(_cr, 1 / recordingScale, 1 / recordingScale);
+    cairo_set_source_surface(_cr, recording, 0, 0);
+    cairo_paint(_cr);
+    cairo_restore(_cr);
+    cairoCheckStatus();
+}
+
 void RenderContext::translate(float dx, float dy)
 {
     cairo_translate(_cr, dx, dy);
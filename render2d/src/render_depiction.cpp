@@ -0,0 +1,79 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "render_depiction.h"
+#include "molecule/base_molecule.h"
+#include "reaction/base_reaction.h"
+
+#include <cairo.h>
+
+using namespace indigo;
+
+RenderDepiction::RenderDepiction() : recording(NULL)
+{
+    clear();
+}
+
+RenderDepiction::~RenderDepiction()
+{
+    clear();
+}
+
+void RenderDepiction::copy(const RenderDepiction& other)
+{
+    clear();
+    if (other.mol.get() != NULL)
+    {
+        mol.reset(other.mol->neu());
+        mol->clone_KeepIndices(other.mol.ref());
+    }
+    else
+        mol.reset(NULL);
+    if (other.rxn.get() != NULL)
+    {
+        rxn.reset(other.rxn->neu());
+        rxn->clone(other.rxn.ref(), 0, 0, 0);
+    }
+    else
+        rxn.reset(NULL);
+
+    // The recording is never changed once made, so copies share it
+    if (other.recording != NULL)
+        recording = cairo_surface_reference(other.recording);
+    recordingScale = other.recordingScale;
+    size.copy(other.size);
+    origin.copy(other.origin);
+    referenceY = other.referenceY;
+    bondCount = other.bondCount;
+    atomCount = other.atomCount;
+    totalBondLength = other.totalBondLength;
+    totalClosestAtomDistance = other.totalClosestAtomDistance;
+}
+
+void RenderDepiction::clear()
+{
+    if (recording != NULL)
+        cairo_surface_destroy(recording);
+    recording = NULL;
+    recordingScale = 1;
+    size.set(0, 0);
+    origin.set(0, 0);
+    referenceY = 0;
+    bondCount = atomCount = -1;
+    totalBondLength = totalClosestAtomDistance = -1;
+}
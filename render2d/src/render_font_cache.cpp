@@ -0,0 +1,100 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "render_font_cache.h"
+#include "base_cpp/tlscont.h"
+
+#include <string.h>
+
+using namespace indigo;
+
+static _SessionLocalContainer<RenderFontCache> render_font_cache_self;
+
+RenderFontCache& RenderFontCache::getInstance()
+{
+    return render_font_cache_self.getLocalCopy();
+}
+
+RenderFontCache::RenderFontCache()
+{
+    _faces[0] = _faces[1] = NULL;
+}
+
+RenderFontCache::~RenderFontCache()
+{
+    clear();
+}
+
+void RenderFontCache::clear()
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (_faces[i] != NULL)
+            cairo_font_face_destroy(_faces[i]);
+        _faces[i] = NULL;
+    }
+    _family.clear();
+    _extents.clear();
+}
+
+cairo_font_face_t* RenderFontCache::getFontFace(const char* family, bool bold)
+{
+    if (_family.size() == 0 || strcmp(_family.ptr(), family) != 0)
+    {
+        clear();
+        _family.readString(family, true);
+    }
+
+    cairo_font_face_t*& face = _faces[bold ? 1 : 0];
+    if (face == NULL)
+        face = cairo_toy_font_face_create(family, CAIRO_FONT_SLANT_NORMAL, bold ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
+    return face;
+}
+
+void RenderFontCache::getTextExtents(cairo_t* cr, const char* text, cairo_text_extents_t& te)
+{
+    // Metrics depend on the font size and the device scale (hinting) and differ
+    // between raster and vector surfaces, so all of them are part of the key
+    cairo_font_face_t* face = cairo_get_font_face(cr);
+    cairo_matrix_t font_matrix, ctm;
+    cairo_get_font_matrix(cr, &font_matrix);
+    cairo_get_matrix(cr, &ctm);
+    int surface_type = cairo_surface_get_type(cairo_get_target(cr));
+
+    _key.clear();
+    _key.append((const char*)&face, sizeof(face));
+    _key.append((const char*)&surface_type, sizeof(surface_type));
+    _key.append((const char*)&font_matrix.xx, 4 * sizeof(double));
+    _key.append((const char*)&ctm.xx, 4 * sizeof(double));
+    _key.append(text);
+
+    auto it = _extents.find(_key);
+    if (it != _extents.end())
+    {
+        te = it->second;
+        return;
+    }
+
+    cairo_text_extents(cr, text, &te);
+    if (cairo_status(cr) != CAIRO_STATUS_SUCCESS)
+        return;
+
+    if (_extents.size() >= MAX_EXTENTS)
+        _extents.clear();
+    _extents.emplace(_key, te);
+}
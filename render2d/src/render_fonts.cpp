@@ -46,16 +46,7 @@ void RenderContext::cairoCheckStatus() const
 
 void RenderContext::fontsClear()
 {
-    memset(_scaled_fonts, 0, FONT_SIZE_COUNT * 2 * sizeof(cairo_scaled_font_t*));
-
-    cairoFontFaceRegular = NULL;
-    cairoFontFaceBold = NULL;
     fontOptions = NULL;
-
-    cairo_matrix_init_identity(&fontCtm);
-    cairoCheckStatus();
-    cairo_matrix_init_identity(&fontScale);
-    cairoCheckStatus();
 }
 
 void RenderContext::fontsInit()
@@ -70,28 +61,11 @@ void RenderContext::fontsInit()
 
 void RenderContext::fontsDispose()
 {
-    for (int i = 0; i < FONT_SIZE_COUNT * 2; ++i)
-    {
-        if (_scaled_fonts[i] != NULL)
-        {
-            cairo_scaled_font_destroy(_scaled_fonts[i]);
-            cairoCheckStatus();
-        }
-    }
-    if (cairoFontFaceRegular != NULL)
-    {
-        cairo_font_face_destroy(cairoFontFaceRegular);
-        cairoCheckStatus();
-    }
-    if (cairoFontFaceBold != NULL)
-    {
-        cairo_font_face_destroy(cairoFontFaceBold);
-        cairoCheckStatus();
-    }
-
+    // Font faces and measured text stay in the session font cache
     if (fontOptions != NULL)
     {
         cairo_font_options_destroy(fontOptions);
+        fontOptions = NULL;
         cairoCheckStatus();
     }
     fontsClear();
@@ -108,7 +82,7 @@ double RenderContext::fontGetSize(FONT_SIZE size)
 
 void RenderContext::fontsSetFont(cairo_t* cr, FONT_SIZE size, bool bold)
 {
-    cairo_select_font_face(cr, _fontfamily.ptr(), CAIRO_FONT_SLANT_NORMAL, bold ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_face(cr, _fontCache.getFontFace(_fontfamily.ptr(), bold));
     cairoCheckStatus();
     cairo_set_font_size(cr, fontGetSize(size));
     cairoCheckStatus();
@@ -118,7 +92,7 @@ void RenderContext::fontsGetTextExtents(cairo_t* cr, const char* text, int size,
 {
     cairo_text_extents_t te;
     _tlock.lock();
-    cairo_text_extents(cr, text, &te);
+    _fontCache.getTextExtents(cr, text, te);
     _tlock.unlock();
     cairoCheckStatus();
 
@@ -172,24 +146,22 @@ void RenderContext::fontsDrawText(const TextItem& ti, const Vec3f& color, bool b
     cairo_text_path(_cr, ti.text.ptr());
     bbIncludePath(false);
     _tlock.unlock();
-    cairo_new_path(_cr);
-    moveTo(ti.bbp);
-    moveToRel(ti.relpos);
+    cairoCheckStatus();
 
-    if (metafileFontsToCurves)
-    { // TODO: remove
-        _tlock.lock();
-        cairo_text_path(_cr, ti.text.ptr());
-        _tlock.unlock();
-        cairoCheckStatus();
-        cairo_fill(_cr);
-        cairoCheckStatus();
-    }
-    else
+    if (fontsToCurves)
     {
-        _tlock.lock();
-        cairo_show_text(_cr, ti.text.ptr());
-        _tlock.unlock();
+        // The glyph outlines are already in the current path
+        cairo_fill(_cr);
         cairoCheckStatus();
+        return;
     }
+
+    cairo_new_path(_cr);
+    moveTo(ti.bbp);
+    moveToRel(ti.relpos);
+
+    _tlock.lock();
+    cairo_show_text(_cr, ti.text.ptr());
+    _tlock.unlock();
+    cairoCheckStatus();
 }
\ No newline at end of file
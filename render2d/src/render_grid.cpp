@@ -68,7 +68,7 @@ void RenderGrid::draw()
     if (enableTitles && titles.size() != objs.size())
         throw Error("Number of titles should be same as the number of objects");
 
-    nRows = (objs.size() + nColumns - 1) / nColumns;
+    nRows = __max((objs.size() + nColumns - 1) / nColumns, _cnvOpt.gridRowNumber);
 
     commentSize.set(0, 0);
     commentOffset = 0;
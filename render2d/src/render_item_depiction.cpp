@@ -0,0 +1,111 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "render_item_depiction.h"
+#include "render_context.h"
+#include "render_item_factory.h"
+
+using namespace indigo;
+
+IMPL_ERROR(RenderItemDepiction, "RenderItemDepiction");
+
+RenderItemDepiction::RenderItemDepiction(RenderItemFactory& factory) : RenderItemBase(factory), depiction(NULL), item(-1)
+{
+}
+
+void RenderItemDepiction::init()
+{
+    if (!depiction->isRecorded())
+        _factory.getItem(item).init();
+}
+
+void RenderItemDepiction::setObjScale(float scale)
+{
+    // The object scale only depends on the structure, so a recorded
+    // depiction was made with the same one
+    if (!depiction->isRecorded())
+        _factory.getItem(item).setObjScale(scale);
+}
+
+void RenderItemDepiction::estimateSize()
+{
+    if (!depiction->isRecorded())
+    {
+        RenderItemBase& inner = _factory.getItem(item);
+        inner.estimateSize();
+
+        _rc.initRecordingContext(inner.size);
+        try
+        {
+            inner.render(false);
+        }
+        catch (...)
+        {
+            cairo_surface_destroy(_rc.closeRecordingContext());
+            throw;
+        }
+        depiction->recording = _rc.closeRecordingContext();
+        depiction->recordingScale = _rc.getDefaultScale();
+        depiction->size.copy(inner.size);
+        depiction->origin.copy(inner.origin);
+        depiction->referenceY = inner.referenceY;
+    }
+    size.copy(depiction->size);
+    origin.copy(depiction->origin);
+    referenceY = depiction->referenceY;
+}
+
+void RenderItemDepiction::render(bool idle)
+{
+    if (idle)
+    {
+        // The recorded drawing starts at the origin of the item
+        _rc.bbIncludePoint(Vec2f(0, 0));
+        _rc.bbIncludePoint(size);
+        return;
+    }
+    _rc.drawRecording(depiction->recording, depiction->recordingScale);
+}
+
+float RenderItemDepiction::getTotalBondLength()
+{
+    if (depiction->totalBondLength < 0)
+        depiction->totalBondLength = _factory.getItem(item).getTotalBondLength();
+    return depiction->totalBondLength;
+}
+
+float RenderItemDepiction::getTotalClosestAtomDistance()
+{
+    if (depiction->totalClosestAtomDistance < 0)
+        depiction->totalClosestAtomDistance = _factory.getItem(item).getTotalClosestAtomDistance();
+    return depiction->totalClosestAtomDistance;
+}
+
+int RenderItemDepiction::getBondCount()
+{
+    if (depiction->bondCount < 0)
+        depiction->bondCount = _factory.getItem(item).getBondCount();
+    return depiction->bondCount;
+}
+
+int RenderItemDepiction::getAtomCount()
+{
+    if (depiction->atomCount < 0)
+        depiction->atomCount = _factory.getItem(item).getAtomCount();
+    return depiction->atomCount;
+}
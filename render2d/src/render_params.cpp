@@ -17,7 +17,7 @@
  ***************************************************************************/
 
 #include "base_cpp/array.h"
-#include "base_cpp/os_sync_wrapper.h"
+#include "base_cpp/os_thread_wrapper.h"
 #include "base_cpp/output.h"
 #include "layout/metalayout.h"
 #include "layout/molecule_layout.h"
@@ -60,6 +60,8 @@ void RenderParams::clearArrays()
 {
     mols.clear();
     rxns.clear();
+    depiction = NULL;
+    depictions.clear();
     titles.clear();
     refAtoms.clear();
 }
@@ -162,6 +164,91 @@ void RenderParamInterface::_prepareReaction(RenderParams& params, BaseReaction&
     }
 }
 
+int RenderParamInterface::_addDepictionItem(RenderParams& params, RenderItemFactory& factory, RenderDepiction& depiction)
+{
+    // The structure item is only drawn until the depiction is recorded
+    int item;
+    if (depiction.mol.get() != NULL)
+    {
+        item = factory.addItemMolecule();
+        if (!depiction.isRecorded())
+            _prepareMolecule(params, depiction.mol.ref());
+        factory.getItemMolecule(item).mol = depiction.mol.get();
+    }
+    else
+    {
+        item = factory.addItemReaction();
+        if (!depiction.isRecorded())
+            _prepareReaction(params, depiction.rxn.ref());
+        factory.getItemReaction(item).rxn = depiction.rxn.get();
+    }
+
+    int obj = factory.addItemDepiction();
+    factory.getItemDepiction(obj).depiction = &depiction;
+    factory.getItemDepiction(obj).item = item;
+    return obj;
+}
+
+//
+// Parallel grid cells
+//
+
+class RenderGridCellCommand : public OsCommand
+{
+public:
+    virtual void execute(OsCommandResult& result)
+    {
+        RenderParamInterface::prepareGridObject(*params, index);
+    }
+
+    RenderParams* params;
+    int index;
+};
+
+// Lays out the structures of a grid on several threads. The drawing stays on
+// the calling thread, so the image is the same as the serial one.
+class RenderGridCellDispatcher : public OsCommandDispatcher
+{
+public:
+    RenderGridCellDispatcher(RenderParams& params) : OsCommandDispatcher(HANDLING_ORDER_ANY, false), _params(params), _next(0)
+    {
+    }
+
+protected:
+    virtual OsCommand* _allocateCommand()
+    {
+        AutoPtr<RenderGridCellCommand> command(new RenderGridCellCommand());
+        command->params = &_params;
+        return command.release();
+    }
+
+    virtual bool _setupCommand(OsCommand& command)
+    {
+        if (_next >= _params.mols.size() + _params.rxns.size())
+            return false;
+        ((RenderGridCellCommand&)command).index = _next++;
+        return true;
+    }
+
+private:
+    RenderParams& _params;
+    int _next;
+};
+
+void RenderParamInterface::prepareGridObject(RenderParams& params, int index)
+{
+    if (index < params.mols.size())
+        _prepareMolecule(params, *params.mols[index]);
+    else
+        _prepareReaction(params, *params.rxns[index - params.mols.size()]);
+}
+
+void RenderParamInterface::_prepareGridObjects(RenderParams& params)
+{
+    RenderGridCellDispatcher dispatcher(params);
+    dispatcher.run(params.cnvOpt.gridThreads);
+}
+
 int RenderParamInterface::multilineTextUnit(RenderItemFactory& factory, int type, const Array<char>& titleStr, const float spacing,
                                             const MultilineTextLayout::Alignment alignment)
 {
@@ -186,24 +273,30 @@ int RenderParamInterface::multilineTextUnit(RenderItemFactory& factory, int type
 
 void RenderParamInterface::render(RenderParams& params)
 {
-    // Disable multithreaded SVG rendering due to the Cairo issue. See IND-482
-    OsLock* render_lock = 0;
-    if (params.rOpt.mode == MODE_SVG)
-    {
-        static ThreadSafeStaticObj<OsLock> svg_lock;
-        render_lock = svg_lock.ptr();
-    }
-    OsLockerNullable locker(render_lock);
-
     if (params.rmode == RENDER_NONE)
         throw Error("No object to render specified");
 
     RenderContext rc(params.rOpt, params.relativeThickness, params.bondLineWidthFactor);
+    if (_renderObjects(params, rc))
+        rc.closeContext(false);
+}
 
+// Draws the objects into the context and leaves it open. Returns false if
+// they were written as CDXML instead.
+bool RenderParamInterface::_renderObjects(RenderParams& params, RenderContext& rc)
+{
     bool bondLengthSet = params.cnvOpt.bondLength > 0;
     int bondLength = (int)(bondLengthSet ? params.cnvOpt.bondLength : 100);
     rc.setDefaultScale((float)bondLength); // TODO: fix bondLength type
 
+    // The structures of a grid are laid out in parallel when asked to
+    bool prepared = false;
+    if (params.cnvOpt.gridThreads != 0 && params.mols.size() + params.rxns.size() > 1)
+    {
+        _prepareGridObjects(params);
+        prepared = true;
+    }
+
     RenderItemFactory factory(rc);
     int obj = -1;
     Array<int> objs;
@@ -223,7 +316,8 @@ void RenderParamInterface::render(RenderParams& params)
             {
                 int mol = factory.addItemMolecule();
                 BaseMolecule& bm = *params.mols[i];
-                _prepareMolecule(params, bm);
+                if (!prepared)
+                    _prepareMolecule(params, bm);
                 factory.getItemMolecule(mol).mol = &bm;
                 objs.push(mol);
 
@@ -251,7 +345,8 @@ void RenderParamInterface::render(RenderParams& params)
             {
                 int rxn = factory.addItemReaction();
                 BaseReaction& br = *params.rxns[i];
-                _prepareReaction(params, br);
+                if (!prepared)
+                    _prepareReaction(params, br);
                 factory.getItemReaction(rxn).rxn = &br;
                 objs.push(rxn);
 
@@ -263,6 +358,27 @@ void RenderParamInterface::render(RenderParams& params)
             }
         }
     }
+    else if (params.rmode == RENDER_DEPICTION)
+    {
+        if (params.rOpt.mode == MODE_CDXML)
+            throw Error("Prepared depictions can not be rendered to CDXML");
+
+        if (params.depictions.size() == 0)
+            obj = _addDepictionItem(params, factory, *params.depiction);
+        else
+        {
+            for (int i = 0; i < params.depictions.size(); ++i)
+            {
+                objs.push(_addDepictionItem(params, factory, *params.depictions[i]));
+
+                if (params.titles.size() > 0)
+                {
+                    titles.push(multilineTextUnit(factory, RenderItemAuxiliary::AUX_TITLE, params.titles[i],
+                                                  params.rOpt.titleSpacing * params.rOpt.titleFontFactor, params.cnvOpt.titleAlign.inbox_alignment));
+                }
+            }
+        }
+    }
     else
     {
         throw Error("Invalid rendering mode: %i", params.rmode);
@@ -280,7 +396,7 @@ void RenderParamInterface::render(RenderParams& params)
     {
         // Render into CDXML format
         RenderParamCdxmlInterface::render(params);
-        return;
+        return false;
     }
 
     if (obj >= 0)
@@ -299,5 +415,51 @@ void RenderParamInterface::render(RenderParams& params)
         render.refAtoms.copy(params.refAtoms);
         render.draw();
     }
-    rc.closeContext(false);
+    return true;
+}
+
+int RenderParamInterface::renderPages(RenderParams& params, RenderPageSource& source)
+{
+    RenderContext rc(params.rOpt, params.relativeThickness, params.bondLineWidthFactor);
+    rc.beginPages();
+
+    // The first page sets the size of the following ones, unless it is given
+    int width = params.cnvOpt.width;
+    int height = params.cnvOpt.height;
+    int pages = 0;
+    try
+    {
+        while (true)
+        {
+            params.clearArrays();
+            if (!source.nextPage(params))
+                break;
+            if (params.rmode == RENDER_NONE)
+                throw Error("No object to render specified");
+
+            _renderObjects(params, rc);
+            if (pages == 0)
+            {
+                params.cnvOpt.width = rc.getWidth();
+                params.cnvOpt.height = rc.getHeight();
+            }
+            rc.closeContext(false);
+            pages++;
+        }
+    }
+    catch (...)
+    {
+        params.cnvOpt.width = width;
+        params.cnvOpt.height = height;
+        params.clearArrays();
+        rc.endPages(true);
+        throw;
+    }
+    params.cnvOpt.width = width;
+    params.cnvOpt.height = height;
+    rc.endPages(false);
+
+    if (pages == 0)
+        throw Error("No object to render specified");
+    return pages;
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "render_png.h"
+#include "base_cpp/output.h"
+#include "base_cpp/tlscont.h"
+
+#include <string.h>
+
+using namespace indigo;
+
+IMPL_ERROR(RenderPngEncoder, "PNG encoder");
+
+static _SessionLocalContainer<RenderPngEncoder> render_png_encoder_self;
+
+// Surface of the last closed image of the session
+class RenderPngSurfaceCache
+{
+public:
+    RenderPngSurfaceCache() : surface(NULL)
+    {
+    }
+    ~RenderPngSurfaceCache()
+    {
+        if (surface != NULL)
+            cairo_surface_destroy(surface);
+    }
+
+    cairo_surface_t* surface;
+};
+
+static _SessionLocalContainer<RenderPngSurfaceCache> render_png_surface_cache;
+
+static const byte _png_signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+static const int _png_idat_size = 1 << 16;
+static const int _png_filter_none = 0;
+
+static void _pngPutDword(byte* dst, dword value)
+{
+    dst[0] = (byte)(value >> 24);
+    dst[1] = (byte)(value >> 16);
+    dst[2] = (byte)(value >> 8);
+    dst[3] = (byte)value;
+}
+
+RenderPngEncoder& RenderPngEncoder::getInstance()
+{
+    return render_png_encoder_self.getLocalCopy();
+}
+
+RenderPngEncoder::RenderPngEncoder() : _zsInit(false)
+{
+    memset(&_zs, 0, sizeof(_zs));
+}
+
+RenderPngEncoder::~RenderPngEncoder()
+{
+    if (_zsInit)
+        deflateEnd(&_zs);
+}
+
+void RenderPngEncoder::_writeChunk(Output& output, const char* type, const byte* data, int length)
+{
+    byte header[8];
+    _pngPutDword(header, length);
+    memcpy(header + 4, type, 4);
+    output.write(header, 8);
+    if (length > 0)
+        output.write(data, length);
+
+    uLong crc = crc32(0, (const Bytef*)type, 4);
+    if (length > 0)
+        crc = crc32(crc, data, length);
+    byte footer[4];
+    _pngPutDword(footer, (dword)crc);
+    output.write(footer, 4);
+}
+
+void RenderPngEncoder::_deflate(Output& output, const byte* data, int length, int flush)
+{
+    _zs.next_in = (Bytef*)data;
+    _zs.avail_in = length;
+
+    while (true)
+    {
+        int ret = deflate(&_zs, flush);
+        if (ret == Z_STREAM_ERROR)
+            throw Error("deflate failed");
+
+        if (_zs.avail_out == 0)
+        {
+            _writeChunk(output, "IDAT", _idat.ptr(), _idat.size());
+            _zs.next_out = _idat.ptr();
+            _zs.avail_out = _idat.size();
+            continue;
+        }
+        if (flush != Z_FINISH && _zs.avail_in == 0)
+            break;
+        if (flush == Z_FINISH && ret == Z_STREAM_END)
+            break;
+    }
+
+    if (flush == Z_FINISH && _zs.avail_out < (uInt)_idat.size())
+        _writeChunk(output, "IDAT", _idat.ptr(), _idat.size() - _zs.avail_out);
+}
+
+void RenderPngEncoder::write(cairo_surface_t* surface, Output& output)
+{
+    cairo_surface_flush(surface);
+    if (cairo_image_surface_get_format(surface) != CAIRO_FORMAT_ARGB32)
+        throw Error("unsupported image format");
+
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const byte* data = cairo_image_surface_get_data(surface);
+    if (width <= 0 || height <= 0 || data == NULL)
+        throw Error("empty image");
+
+    // Same color type choice as Cairo: drop the alpha channel for opaque images
+    bool opaque = true;
+    for (int y = 0; y < height && opaque; y++)
+    {
+        const dword* pixels = (const dword*)(data + y * stride);
+        for (int x = 0; x < width; x++)
+            if ((pixels[x] >> 24) != 0xff)
+            {
+                opaque = false;
+                break;
+            }
+    }
+    int bpp = opaque ? 3 : 4;
+
+    if (!_zsInit)
+    {
+        if (deflateInit2(&_zs, 3, Z_DEFLATED, 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw Error("cannot initialize deflate");
+        _zsInit = true;
+    }
+    else
+        deflateReset(&_zs);
+
+    _idat.resize(_png_idat_size);
+    _zs.next_out = _idat.ptr();
+    _zs.avail_out = _idat.size();
+    _row.resize(width * bpp + 1);
+
+    output.write(_png_signature, sizeof(_png_signature));
+
+    byte ihdr[13];
+    _pngPutDword(ihdr, width);
+    _pngPutDword(ihdr + 4, height);
+    ihdr[8] = 8;              // bit depth
+    ihdr[9] = opaque ? 2 : 6; // RGB or RGBA
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+    _writeChunk(output, "IHDR", ihdr, sizeof(ihdr));
+
+    byte bkgd[6] = {0, 255, 0, 255, 0, 255};
+    _writeChunk(output, "bKGD", bkgd, sizeof(bkgd));
+
+    for (int y = 0; y < height; y++)
+    {
+        const dword* pixels = (const dword*)(data + y * stride);
+        byte* row = _row.ptr();
+        byte* raw = row + 1;
+
+        row[0] = _png_filter_none;
+
+        for (int x = 0; x < width; x++)
+        {
+            dword pixel = pixels[x];
+            dword alpha = pixel >> 24;
+            dword r = (pixel >> 16) & 0xff, g = (pixel >> 8) & 0xff, b = pixel & 0xff;
+
+            if (bpp == 4)
+            {
+                // Cairo stores premultiplied colors
+                if (alpha == 0)
+                    r = g = b = 0;
+                else if (alpha != 0xff)
+                {
+                    r = (r * 255 + alpha / 2) / alpha;
+                    g = (g * 255 + alpha / 2) / alpha;
+                    b = (b * 255 + alpha / 2) / alpha;
+                }
+                raw[3] = (byte)alpha;
+            }
+            raw[0] = (byte)r;
+            raw[1] = (byte)g;
+            raw[2] = (byte)b;
+            raw += bpp;
+        }
+
+        _deflate(output, row, _row.size(), y == height - 1 ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    _writeChunk(output, "IEND", NULL, 0);
+}
+
+cairo_surface_t* RenderPngBackend::createSurface(cairo_write_func_t, void*, int width, int height)
+{
+    RenderPngSurfaceCache& cache = render_png_surface_cache.getLocalCopy();
+    cairo_surface_t* surface = cache.surface;
+
+    if (surface != NULL && cairo_image_surface_get_width(surface) == width && cairo_image_surface_get_height(surface) == height)
+    {
+        // The surface is taken from the cache while it is in use
+        cache.surface = NULL;
+        cairo_surface_flush(surface);
+        memset(cairo_image_surface_get_data(surface), 0, cairo_image_surface_get_stride(surface) * height);
+        cairo_surface_mark_dirty(surface);
+        return surface;
+    }
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+}
+
+void RenderPngBackend::closeSurface(cairo_surface_t* surface, Output* output, bool discard)
+{
+    RenderPngSurfaceCache& cache = render_png_surface_cache.getLocalCopy();
+
+    // Discarded surfaces come from the contexts that only measure the
+    // drawing, so they are not kept in place of the image surface
+    if (discard || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+    {
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    try
+    {
+        RenderPngEncoder::getInstance().write(surface, *output);
+    }
+    catch (...)
+    {
+        cairo_surface_destroy(surface);
+        throw;
+    }
+
+    if (cache.surface != NULL)
+        cairo_surface_destroy(cache.surface);
+    cache.surface = surface;
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+#include "render_surface_backend.h"
+#include "base_cpp/os_sync_wrapper.h"
+#include "render_common.h"
+#include "render_png.h"
+
+#include <cairo-pdf.h>
+#include <cairo-svg.h>
+
+using namespace indigo;
+
+IMPL_ERROR(RenderSurfaceBackend, "render surface backend");
+
+namespace
+{
+    // PDF and SVG documents are written by Cairo to the output stream
+    class RenderStreamBackend : public RenderSurfaceBackend
+    {
+    public:
+        RenderStreamBackend(int mode) : _mode(mode)
+        {
+        }
+
+        virtual cairo_surface_t* createSurface(cairo_write_func_t writer, void* closure, int width, int height)
+        {
+            if (_mode == MODE_PDF)
+                return cairo_pdf_surface_create_for_stream(writer, closure, width, height);
+            return cairo_svg_surface_create_for_stream(writer, closure, width, height);
+        }
+
+        virtual void closeSurface(cairo_surface_t* surface, Output* output, bool discard)
+        {
+            // Finishing the document writes the trailer and the embedded fonts
+            cairo_surface_finish(surface);
+            cairo_status_t s = cairo_surface_status(surface);
+            cairo_surface_destroy(surface);
+            if (!discard && s != CAIRO_STATUS_SUCCESS)
+                throw Error("Cairo error: %s\n", cairo_status_to_string(s));
+        }
+
+        virtual bool textToCurves() const
+        {
+            // The SVG surface embeds glyphs as font subsets taken from the scaled fonts,
+            // which Cairo shares between all threads (IND-482). Plain paths are written
+            // instead, so SVG documents can be rendered concurrently without a global lock.
+            return _mode == MODE_SVG;
+        }
+
+    private:
+        int _mode;
+    };
+
+    class RenderSurfaceBackends
+    {
+    public:
+        RenderSurfaceBackends() : _pdf(MODE_PDF), _svg(MODE_SVG)
+        {
+            for (int i = 0; i < MODE_COUNT; i++)
+                _custom[i] = NULL;
+        }
+
+        ~RenderSurfaceBackends()
+        {
+            for (int i = 0; i < MODE_COUNT; i++)
+                delete _custom[i];
+        }
+
+        RenderSurfaceBackend* get(int mode)
+        {
+            OsLocker locker(_lock);
+            if (mode < 0 || mode >= MODE_COUNT)
+                return NULL;
+            if (_custom[mode] != NULL)
+                return _custom[mode];
+            switch (mode)
+            {
+            case MODE_PDF:
+                return &_pdf;
+            case MODE_SVG:
+                return &_svg;
+            case MODE_PNG:
+                return &_png;
+            default:
+                return NULL;
+            }
+        }
+
+        void set(int mode, RenderSurfaceBackend* backend)
+        {
+            OsLocker locker(_lock);
+            if (mode < 0 || mode >= MODE_COUNT)
+            {
+                delete backend;
+                throw RenderSurfaceBackend::Error("unknown mode: %d", mode);
+            }
+            delete _custom[mode];
+            _custom[mode] = backend;
+        }
+
+    private:
+        enum
+        {
+            MODE_COUNT = MODE_CDXML + 1
+        };
+
+        OsLock _lock;
+        RenderStreamBackend _pdf;
+        RenderStreamBackend _svg;
+        RenderPngBackend _png;
+        RenderSurfaceBackend* _custom[MODE_COUNT];
+    };
+
+    RenderSurfaceBackends& getRenderSurfaceBackends()
+    {
+        static RenderSurfaceBackends backends;
+        return backends;
+    }
+} // namespace
+
+RenderSurfaceBackend::~RenderSurfaceBackend()
+{
+}
+
+bool RenderSurfaceBackend::textToCurves() const
+{
+    return false;
+}
+
+RenderSurfaceBackend* RenderSurfaceBackend::get(int mode)
+{
+    return getRenderSurfaceBackends().get(mode);
+}
+
+void RenderSurfaceBackend::set(int mode, RenderSurfaceBackend* backend)
+{
+    getRenderSurfaceBackends().set(mode, backend);
+}
@@ -0,0 +1,332 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+//
+// This is a command line utility for measuring the decoding throughput of
+// the CMF records. The molecules of every input file are stored in a Bingo
+// database, and then all the records are read back several times. Reading
+// a record decodes its CMF into a molecule, so the report shows how many
+// records and atoms are decoded per second. The records are saved in CMF
+// or, with -format cmf2, in the sectioned format of CMF version 2.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base_c/nano.h"
+#include "bingo.h"
+#include "indigo.h"
+
+#define MAX_CATEGORIES 32
+#define MAX_LINE 65536
+
+typedef struct
+{
+    char name[256];
+    int* ids;
+    int count;
+    int capacity;
+    int failed;
+    long long atoms;
+    double seconds;
+} Stats;
+
+typedef struct
+{
+    int repeat;
+    int check;
+    const char* location;
+    const char* options;
+    Stats stats[MAX_CATEGORIES];
+    int ncategories;
+    int failures;
+} Bench;
+
+void onError(const char* message, void* context)
+{
+    fflush(stdout);
+    fprintf(stderr, "%s\n", message);
+    fflush(stderr);
+    exit(-1);
+}
+
+void usage()
+{
+    printf("Usage:\n"
+           "  indigo-cmf-bench file.{smi,sdf,mol} [file ...] [parameters]\n"
+           "Each file is reported as a separate category named after the file.\n"
+           "SMILES files contain one molecule per line, optionally followed by a name.\n"
+           "Parameters:\n"
+           "  -repeat <n>      Read all the records n times (default: 10)\n"
+           "  -format <f>      Record format: cmf or cmf2 (default: cmf)\n"
+           "  -check           Check that every record is decoded into the\n"
+           "                   same structure as inserted\n"
+           "  -db <dir>        Directory for the temporary database\n"
+           "                   (default: indigo-cmf-bench.db)\n"
+           "The utility exits with a non-zero code if any structure failed.\n"
+           "Examples:\n"
+           "   indigo-cmf-bench corpus/*.smi corpus/*.sdf\n"
+           "   indigo-cmf-bench catalog.sdf -repeat 3 -db /tmp/bench.db\n"
+           "   indigo-cmf-bench corpus/*.sdf -format cmf2 -check\n");
+}
+
+static void categoryName(const char* filename, char* name, int size)
+{
+    const char* base = filename;
+    const char* p;
+    int len;
+
+    for (p = filename; *p != 0; p++)
+        if (*p == '/' || *p == '\\')
+            base = p + 1;
+
+    p = strchr(base, '.');
+    len = p != 0 ? (int)(p - base) : (int)strlen(base);
+    if (len >= size)
+        len = size - 1;
+    memcpy(name, base, len);
+    name[len] = 0;
+}
+
+static void insertMolecule(Bench* bench, Stats* s, int db, int mol, const char* name)
+{
+    int id = bingoInsertRecordObj(db, mol);
+
+    if (id < 0)
+    {
+        fprintf(stderr, "%s %s: %s\n", s->name, name, indigoGetLastError());
+        s->failed++;
+        bench->failures++;
+        return;
+    }
+
+    if (bench->check)
+    {
+        int decoded = bingoGetRecordObj(db, id);
+        int match = decoded >= 0 ? indigoExactMatch(mol, decoded, "") : -1;
+
+        if (match <= 0)
+        {
+            fprintf(stderr, "%s %s: decoded record differs\n", s->name, name);
+            s->failed++;
+            bench->failures++;
+        }
+        if (match > 0)
+            indigoFree(match);
+        if (decoded >= 0)
+            indigoFree(decoded);
+    }
+
+    if (s->count == s->capacity)
+    {
+        s->capacity = s->capacity > 0 ? s->capacity * 2 : 1024;
+        s->ids = (int*)realloc(s->ids, s->capacity * sizeof(int));
+    }
+    s->ids[s->count++] = id;
+    s->atoms += indigoCountAtoms(mol);
+}
+
+static void loadSmilesFile(Bench* bench, Stats* s, int db, const char* filename)
+{
+    static char line[MAX_LINE];
+    FILE* f = fopen(filename, "r");
+
+    if (f == 0)
+    {
+        fprintf(stderr, "cannot open %s\n", filename);
+        bench->failures++;
+        return;
+    }
+
+    while (fgets(line, sizeof(line), f) != 0)
+    {
+        char* smiles = strtok(line, " \t\r\n");
+        int mol;
+
+        if (smiles == 0 || smiles[0] == '#')
+            continue;
+
+        mol = indigoLoadMoleculeFromString(smiles);
+        if (mol < 0)
+        {
+            fprintf(stderr, "%s %s: %s\n", s->name, smiles, indigoGetLastError());
+            s->failed++;
+            bench->failures++;
+            continue;
+        }
+        insertMolecule(bench, s, db, mol, smiles);
+        indigoFree(mol);
+    }
+    fclose(f);
+}
+
+static void loadFile(Bench* bench, Stats* s, int db, const char* filename)
+{
+    int iter, item;
+
+    iter = indigoIterateSDFile(filename);
+    if (iter < 0)
+    {
+        fprintf(stderr, "%s: %s\n", filename, indigoGetLastError());
+        bench->failures++;
+        return;
+    }
+
+    while ((item = indigoNext(iter)) > 0)
+    {
+        const char* name = indigoName(item);
+
+        insertMolecule(bench, s, db, item, (name != 0 && name[0] != 0) ? name : "-");
+        indigoFree(item);
+    }
+    indigoFree(iter);
+}
+
+static void decodeRecords(Bench* bench, Stats* s, int db)
+{
+    qword start = nanoClock();
+    int r, i;
+
+    for (r = 0; r < bench->repeat; r++)
+        for (i = 0; i < s->count; i++)
+        {
+            int mol = bingoGetRecordObj(db, s->ids[i]);
+
+            if (mol < 0)
+            {
+                fprintf(stderr, "%s record %d: %s\n", s->name, s->ids[i], indigoGetLastError());
+                bench->failures++;
+                continue;
+            }
+            indigoFree(mol);
+        }
+
+    s->seconds = nanoHowManySeconds(nanoClock() - start);
+}
+
+static void report(Bench* bench)
+{
+    int c;
+
+    printf("%-14s %7s %5s %9s %10s %12s %14s\n", "category", "n", "fail", "total,s", "us/record", "records/s", "atoms/s");
+
+    for (c = 0; c < bench->ncategories; c++)
+    {
+        Stats* s = &bench->stats[c];
+        double decoded = (double)s->count * bench->repeat;
+
+        printf("%-14s %7d %5d %9.3f %10.2f %12.0f %14.0f\n", s->name, s->count, s->failed, s->seconds, decoded > 0 ? s->seconds * 1e6 / decoded : 0.0,
+               s->seconds > 0 ? decoded / s->seconds : 0.0, s->seconds > 0 ? (double)s->atoms * bench->repeat / s->seconds : 0.0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static Bench bench;
+    const char* files[MAX_CATEGORIES];
+    int nfiles = 0;
+    int i, c;
+
+    bench.repeat = 10;
+    bench.location = "indigo-cmf-bench.db";
+    bench.options = "";
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-repeat") == 0)
+        {
+            if (++i >= argc || (bench.repeat = atoi(argv[i])) < 1)
+            {
+                fprintf(stderr, "expecting a positive number after -repeat\n");
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-db") == 0)
+        {
+            if (++i >= argc)
+            {
+                fprintf(stderr, "expecting a directory after -db\n");
+                return -1;
+            }
+            bench.location = argv[i];
+        }
+        else if (strcmp(argv[i], "-format") == 0)
+        {
+            if (++i < argc && strcmp(argv[i], "cmf") == 0)
+                bench.options = "";
+            else if (i < argc && strcmp(argv[i], "cmf2") == 0)
+                bench.options = "cf_format:cmf2";
+            else
+            {
+                fprintf(stderr, "expecting cmf or cmf2 after -format\n");
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-check") == 0)
+            bench.check = 1;
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "unknown parameter: %s\n", argv[i]);
+            return -1;
+        }
+        else if (nfiles == MAX_CATEGORIES)
+        {
+            fprintf(stderr, "too many input files\n");
+            return -1;
+        }
+        else
+            files[nfiles++] = argv[i];
+    }
+
+    if (nfiles == 0)
+    {
+        usage();
+        return -1;
+    }
+
+    // Failures of single structures are reported and counted, not fatal
+    indigoSetErrorHandler(0, 0);
+
+    for (c = 0; c < nfiles; c++)
+    {
+        Stats* s = &bench.stats[c];
+        const char* ext = strrchr(files[c], '.');
+        int db;
+
+        categoryName(files[c], s->name, sizeof(s->name));
+        bench.ncategories++;
+
+        db = bingoCreateDatabaseFile(bench.location, "molecule", bench.options);
+        if (db < 0)
+            onError(indigoGetLastError(), 0);
+
+        if (ext != 0 && (strcmp(ext, ".smi") == 0 || strcmp(ext, ".smiles") == 0))
+            loadSmilesFile(&bench, s, db, files[c]);
+        else
+            loadFile(&bench, s, db, files[c]);
+
+        decodeRecords(&bench, s, db);
+        bingoCloseDatabase(db);
+        free(s->ids);
+    }
+
+    report(&bench);
+
+    return bench.failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,706 @@
+/****************************************************************************
+ * Copyright (C) from 2009 to Present EPAM Systems.
+ *
+ * This file is part of Indigo toolkit.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ***************************************************************************/
+
+//
+// This is a command line utility for measuring the speed and the quality
+// of 2D layout and cleaning over a corpus of structures. Every input file
+// is one category of the report (drug-like molecules, macrocycles,
+// polymers, reactions, ...). For each structure and mode the utility
+// records the latency and the geometric quality of the result: bond
+// length deviation, overlapping atoms and crossing bonds.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base_c/nano.h"
+#include "indigo.h"
+
+#define MAX_CATEGORIES 32
+#define MAX_LINE 65536
+
+enum
+{
+    MODE_LAYOUT = 0,
+    MODE_SMART,
+    MODE_CLEAN,
+    MODE_COUNT
+};
+
+static const char* mode_names[MODE_COUNT] = {"layout", "smart", "clean"};
+
+// Atoms closer than this fraction of the mean bond length overlap
+static const double overlap_threshold = 0.3;
+// Cleaning starts from a layout with atoms shifted by up to this
+// fraction of the mean bond length
+static const double clean_jitter = 0.25;
+
+typedef struct
+{
+    double bond_sq_sum;
+    double bond_max;
+    int bonds;
+    int overlaps;
+    int crossings;
+} Quality;
+
+typedef struct
+{
+    double* xy;
+    int* atoms;
+    int natoms;
+    int* ends;
+    int nbonds;
+} Geometry;
+
+typedef struct
+{
+    char name[256];
+    int count;
+    int failed;
+    int size;
+    double* times;
+    double bond_rms_sum;
+    double bond_max;
+    int measured;
+    int overlaps;
+    int crossings;
+} Stats;
+
+typedef struct
+{
+    int modes[MODE_COUNT];
+    int nmodes;
+    int timeout;
+    FILE* tsv;
+    Stats stats[MAX_CATEGORIES][MODE_COUNT];
+    int ncategories;
+    int failures;
+} Bench;
+
+void onError(const char* message, void* context)
+{
+    fflush(stdout);
+    fprintf(stderr, "%s\n", message);
+    fflush(stderr);
+    exit(-1);
+}
+
+void usage()
+{
+    printf("Usage:\n"
+           "  indigo-layout-bench file.{smi,sdf,mol,rdf} [file ...] [parameters]\n"
+           "Each file is reported as a separate category named after the file.\n"
+           "SMILES files contain one molecule or reaction per line, optionally\n"
+           "followed by a name.\n"
+           "Parameters:\n"
+           "  -modes <list>    Comma-separated modes to run (default: layout,smart,clean)\n"
+           "                     layout  indigoLayout() with smart-layout disabled\n"
+           "                     smart   indigoLayout() with smart-layout enabled\n"
+           "                     clean   indigoClean2d() of a perturbed layout\n"
+           "  -tsv <file>      Write per-structure results to a tab-separated file\n"
+           "  -timeout <ms>    Stop a layout after the given time (default: none)\n"
+           "The utility exits with a non-zero code if any structure failed.\n"
+           "Examples:\n"
+           "   indigo-layout-bench corpus/*.smi corpus/*.sdf\n"
+           "   indigo-layout-bench macrocycles.smi -modes smart -tsv results.tsv\n");
+}
+
+static int parseModes(Bench* bench, const char* list)
+{
+    char buf[256];
+    char* token;
+    int i;
+
+    bench->nmodes = 0;
+    strncpy(buf, list, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+
+    for (token = strtok(buf, ","); token != 0; token = strtok(0, ","))
+    {
+        for (i = 0; i < MODE_COUNT; i++)
+            if (strcmp(token, mode_names[i]) == 0)
+                break;
+        if (i == MODE_COUNT)
+        {
+            fprintf(stderr, "unknown mode: %s\n", token);
+            return -1;
+        }
+        bench->modes[bench->nmodes++] = i;
+    }
+    return bench->nmodes > 0 ? 0 : -1;
+}
+
+static void categoryName(const char* filename, char* name, int size)
+{
+    const char* base = filename;
+    const char* p;
+    int len;
+
+    for (p = filename; *p != 0; p++)
+        if (*p == '/' || *p == '\\')
+            base = p + 1;
+
+    p = strchr(base, '.');
+    len = p != 0 ? (int)(p - base) : (int)strlen(base);
+    if (len >= size)
+        len = size - 1;
+    memcpy(name, base, len);
+    name[len] = 0;
+}
+
+static double randomShift(unsigned* seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return ((*seed >> 8) & 0xFFFF) / 65535.0 - 0.5;
+}
+
+// Reads the atom coordinates, indexed by the atom index, and the bonds
+static int readGeometry(int mol, Geometry* g)
+{
+    int natoms = indigoCountAtoms(mol);
+    int nbonds = indigoCountBonds(mol);
+    int maxidx = 0;
+    int iter, item;
+
+    memset(g, 0, sizeof(Geometry));
+    if (natoms < 0 || nbonds < 0)
+        return -1;
+
+    g->atoms = (int*)malloc((natoms + 1) * sizeof(int));
+    iter = indigoIterateAtoms(mol);
+    while ((item = indigoNext(iter)))
+    {
+        int idx = indigoIndex(item);
+
+        g->atoms[g->natoms++] = idx;
+        if (idx > maxidx)
+            maxidx = idx;
+        indigoFree(item);
+    }
+    indigoFree(iter);
+
+    g->xy = (double*)calloc(2 * (maxidx + 1), sizeof(double));
+    iter = indigoIterateAtoms(mol);
+    while ((item = indigoNext(iter)))
+    {
+        float* pos = indigoXYZ(item);
+        int idx = indigoIndex(item);
+
+        if (pos != 0)
+        {
+            g->xy[2 * idx] = pos[0];
+            g->xy[2 * idx + 1] = pos[1];
+        }
+        indigoFree(item);
+    }
+    indigoFree(iter);
+
+    g->ends = (int*)malloc(2 * (nbonds + 1) * sizeof(int));
+    iter = indigoIterateBonds(mol);
+    while ((item = indigoNext(iter)))
+    {
+        int src = indigoSource(item);
+        int dst = indigoDestination(item);
+
+        g->ends[2 * g->nbonds] = indigoIndex(src);
+        g->ends[2 * g->nbonds + 1] = indigoIndex(dst);
+        g->nbonds++;
+        indigoFree(src);
+        indigoFree(dst);
+        indigoFree(item);
+    }
+    indigoFree(iter);
+    return 0;
+}
+
+static void freeGeometry(Geometry* g)
+{
+    free(g->xy);
+    free(g->atoms);
+    free(g->ends);
+}
+
+static double bondLength(const Geometry* g, int bond)
+{
+    const double* a = g->xy + 2 * g->ends[2 * bond];
+    const double* b = g->xy + 2 * g->ends[2 * bond + 1];
+
+    return hypot(a[0] - b[0], a[1] - b[1]);
+}
+
+static double meanBondLength(const Geometry* g)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < g->nbonds; i++)
+        sum += bondLength(g, i);
+    return g->nbonds > 0 ? sum / g->nbonds : 0;
+}
+
+static double orientation(const double* a, const double* b, const double* c)
+{
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+static int segmentsCross(const double* a, const double* b, const double* c, const double* d)
+{
+    double d1 = orientation(c, d, a);
+    double d2 = orientation(c, d, b);
+    double d3 = orientation(a, b, c);
+    double d4 = orientation(a, b, d);
+
+    return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+// Adds the quality figures of one molecule (or one reaction component)
+static int measureMolecule(int mol, Quality* q)
+{
+    Geometry g;
+    double mean;
+    int i, j;
+
+    if (readGeometry(mol, &g) < 0)
+        return -1;
+
+    mean = meanBondLength(&g);
+    if (mean > 0)
+    {
+        for (i = 0; i < g.nbonds; i++)
+        {
+            double dev = fabs(bondLength(&g, i) - mean) / mean;
+
+            q->bond_sq_sum += dev * dev;
+            if (dev > q->bond_max)
+                q->bond_max = dev;
+        }
+        q->bonds += g.nbonds;
+
+        for (i = 0; i < g.natoms; i++)
+            for (j = i + 1; j < g.natoms; j++)
+            {
+                const double* a = g.xy + 2 * g.atoms[i];
+                const double* b = g.xy + 2 * g.atoms[j];
+
+                if (hypot(a[0] - b[0], a[1] - b[1]) < overlap_threshold * mean)
+                    q->overlaps++;
+            }
+
+        for (i = 0; i < g.nbonds; i++)
+            for (j = i + 1; j < g.nbonds; j++)
+            {
+                const int* e1 = g.ends + 2 * i;
+                const int* e2 = g.ends + 2 * j;
+
+                if (e1[0] == e2[0] || e1[0] == e2[1] || e1[1] == e2[0] || e1[1] == e2[1])
+                    continue;
+                if (segmentsCross(g.xy + 2 * e1[0], g.xy + 2 * e1[1], g.xy + 2 * e2[0], g.xy + 2 * e2[1]))
+                    q->crossings++;
+            }
+    }
+    freeGeometry(&g);
+    return 0;
+}
+
+static int measure(int obj, int reaction, Quality* q)
+{
+    memset(q, 0, sizeof(Quality));
+
+    if (reaction)
+    {
+        int iter = indigoIterateMolecules(obj);
+        int item;
+
+        if (iter < 0)
+            return -1;
+        while ((item = indigoNext(iter)) > 0)
+        {
+            int res = measureMolecule(item, q);
+
+            indigoFree(item);
+            if (res < 0)
+                break;
+        }
+        indigoFree(iter);
+        return 0;
+    }
+    return measureMolecule(obj, q);
+}
+
+// Shifts every atom by a reproducible random offset
+static void perturb(int mol, unsigned seed, double amplitude)
+{
+    int iter = indigoIterateAtoms(mol);
+    int item;
+
+    while ((item = indigoNext(iter)) > 0)
+    {
+        float* pos = indigoXYZ(item);
+
+        if (pos != 0)
+        {
+            float x = pos[0] + (float)(amplitude * randomShift(&seed));
+            float y = pos[1] + (float)(amplitude * randomShift(&seed));
+
+            indigoSetXYZ(item, x, y, pos[2]);
+        }
+        indigoFree(item);
+    }
+    indigoFree(iter);
+}
+
+static int prepareClean(int obj, int reaction, unsigned seed)
+{
+    Geometry g;
+    double mean;
+
+    if (indigoSetOptionBool("smart-layout", 0) < 0 || indigoLayout(obj) < 0)
+        return -1;
+
+    if (reaction)
+    {
+        int iter = indigoIterateMolecules(obj);
+        int item;
+
+        while ((item = indigoNext(iter)) > 0)
+        {
+            if (readGeometry(item, &g) == 0)
+            {
+                mean = meanBondLength(&g);
+                freeGeometry(&g);
+                perturb(item, seed++, clean_jitter * mean);
+            }
+            indigoFree(item);
+        }
+        indigoFree(iter);
+        return 0;
+    }
+
+    if (readGeometry(obj, &g) < 0)
+        return -1;
+    mean = meanBondLength(&g);
+    freeGeometry(&g);
+    perturb(obj, seed, clean_jitter * mean);
+    return 0;
+}
+
+// Runs one mode on a copy of the structure; returns the time in
+// milliseconds or a negative value if the structure failed
+static double runMode(int structure, int reaction, int mode, unsigned seed, Quality* q)
+{
+    int obj = indigoClone(structure);
+    int res = 0;
+    qword start;
+    double ms;
+
+    if (obj < 0)
+        return -1;
+
+    switch (mode)
+    {
+    case MODE_LAYOUT:
+    case MODE_SMART:
+        res = indigoSetOptionBool("smart-layout", mode == MODE_SMART);
+        break;
+    case MODE_CLEAN:
+        res = prepareClean(obj, reaction, seed);
+        break;
+    }
+
+    if (res >= 0)
+    {
+        start = nanoClock();
+        res = mode == MODE_CLEAN ? indigoClean2d(obj) : indigoLayout(obj);
+        ms = nanoHowManySeconds(nanoClock() - start) * 1000.0;
+    }
+
+    if (res >= 0)
+        res = measure(obj, reaction, q);
+
+    indigoFree(obj);
+    return res < 0 ? -1 : ms;
+}
+
+static void addResult(Stats* s, double ms, const Quality* q)
+{
+    s->count++;
+    if (ms < 0)
+    {
+        s->failed++;
+        return;
+    }
+    if (s->measured == s->size)
+    {
+        s->size = s->size * 2 + 16;
+        s->times = (double*)realloc(s->times, s->size * sizeof(double));
+    }
+    s->times[s->measured++] = ms;
+    if (q->bonds > 0)
+        s->bond_rms_sum += sqrt(q->bond_sq_sum / q->bonds);
+    if (q->bond_max > s->bond_max)
+        s->bond_max = q->bond_max;
+    s->overlaps += q->overlaps;
+    s->crossings += q->crossings;
+}
+
+static void processStructure(Bench* bench, int category, int obj, int reaction, int index, const char* name)
+{
+    int m;
+
+    for (m = 0; m < bench->nmodes; m++)
+    {
+        int mode = bench->modes[m];
+        Stats* s = &bench->stats[category][mode];
+        Quality q;
+        double ms;
+
+        memset(&q, 0, sizeof(q));
+        ms = runMode(obj, reaction, mode, (unsigned)index * 7919u + 1, &q);
+        addResult(s, ms, &q);
+
+        if (ms < 0)
+        {
+            bench->failures++;
+            fprintf(stderr, "%s #%d %s (%s): %s\n", s->name, index, name, mode_names[mode], indigoGetLastError());
+        }
+
+        if (bench->tsv != 0)
+        {
+            if (ms < 0)
+                fprintf(bench->tsv, "%s\t%s\t%d\t%s\tfailed\t\t\t\t\t\n", s->name, mode_names[mode], index, name);
+            else
+                fprintf(bench->tsv, "%s\t%s\t%d\t%s\tok\t%.3f\t%.4f\t%.4f\t%d\t%d\n", s->name, mode_names[mode], index, name, ms,
+                        q.bonds > 0 ? sqrt(q.bond_sq_sum / q.bonds) : 0.0, q.bond_max, q.overlaps, q.crossings);
+        }
+    }
+}
+
+static void processSmilesFile(Bench* bench, int category, const char* filename)
+{
+    static char line[MAX_LINE];
+    FILE* f = fopen(filename, "r");
+    int index = 0;
+
+    if (f == 0)
+    {
+        fprintf(stderr, "cannot open %s\n", filename);
+        bench->failures++;
+        return;
+    }
+
+    while (fgets(line, sizeof(line), f) != 0)
+    {
+        char* smiles = strtok(line, " \t\r\n");
+        char* name = strtok(0, "\r\n");
+        int reaction, obj;
+
+        if (smiles == 0 || smiles[0] == '#')
+            continue;
+        if (name == 0)
+            name = smiles;
+        while (*name == ' ' || *name == '\t')
+            name++;
+
+        reaction = strchr(smiles, '>') != 0;
+        if (reaction)
+            obj = indigoLoadReactionFromString(smiles);
+        else
+            obj = indigoLoadMoleculeFromString(smiles);
+
+        if (obj < 0)
+        {
+            fprintf(stderr, "%s #%d %s: %s\n", bench->stats[category][0].name, index, name, indigoGetLastError());
+            bench->failures++;
+        }
+        else
+        {
+            processStructure(bench, category, obj, reaction, index, name);
+            indigoFree(obj);
+        }
+        index++;
+    }
+    fclose(f);
+}
+
+static void processFile(Bench* bench, int category, const char* filename)
+{
+    int iter, item;
+    int rdf = strstr(filename, ".rdf") != 0;
+
+    iter = rdf ? indigoIterateRDFile(filename) : indigoIterateSDFile(filename);
+    if (iter < 0)
+    {
+        fprintf(stderr, "%s: %s\n", filename, indigoGetLastError());
+        bench->failures++;
+        return;
+    }
+
+    while ((item = indigoNext(iter)) > 0)
+    {
+        const char* name = indigoName(item);
+        char buf[256];
+
+        snprintf(buf, sizeof(buf), "%s", (name != 0 && name[0] != 0) ? name : "-");
+        processStructure(bench, category, item, rdf, indigoIndex(item), buf);
+        indigoFree(item);
+    }
+    indigoFree(iter);
+}
+
+static int compareTimes(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static double percentile(const Stats* s, double p)
+{
+    int rank = (int)ceil(p * s->measured) - 1;
+
+    if (s->measured == 0)
+        return 0;
+    if (rank < 0)
+        rank = 0;
+    return s->times[rank];
+}
+
+static void report(Bench* bench)
+{
+    int c, m;
+
+    printf("%-14s %-7s %5s %5s %9s %9s %9s %9s %9s %9s %8s %9s\n", "category", "mode", "n", "fail", "p50,ms", "p90,ms", "p99,ms", "max,ms", "bond-rms",
+           "bond-max", "overlaps", "crossings");
+
+    for (c = 0; c < bench->ncategories; c++)
+        for (m = 0; m < bench->nmodes; m++)
+        {
+            Stats* s = &bench->stats[c][bench->modes[m]];
+
+            qsort(s->times, s->measured, sizeof(double), compareTimes);
+            printf("%-14s %-7s %5d %5d %9.3f %9.3f %9.3f %9.3f %9.4f %9.4f %8d %9d\n", s->name, mode_names[bench->modes[m]], s->count, s->failed,
+                   percentile(s, 0.5), percentile(s, 0.9), percentile(s, 0.99), percentile(s, 1.0),
+                   s->measured > 0 ? s->bond_rms_sum / s->measured : 0.0, s->bond_max, s->overlaps, s->crossings);
+        }
+}
+
+int main(int argc, char* argv[])
+{
+    static Bench bench;
+    const char* files[MAX_CATEGORIES];
+    const char* tsvname = 0;
+    int nfiles = 0;
+    int i, c, m;
+
+    parseModes(&bench, "layout,smart,clean");
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-modes") == 0)
+        {
+            if (++i >= argc || parseModes(&bench, argv[i]) < 0)
+            {
+                fprintf(stderr, "expecting a list of modes after -modes\n");
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-tsv") == 0)
+        {
+            if (++i >= argc)
+            {
+                fprintf(stderr, "expecting a file name after -tsv\n");
+                return -1;
+            }
+            tsvname = argv[i];
+        }
+        else if (strcmp(argv[i], "-timeout") == 0)
+        {
+            if (++i >= argc)
+            {
+                fprintf(stderr, "expecting a number of milliseconds after -timeout\n");
+                return -1;
+            }
+            bench.timeout = atoi(argv[i]);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "unknown parameter: %s\n", argv[i]);
+            return -1;
+        }
+        else if (nfiles == MAX_CATEGORIES)
+        {
+            fprintf(stderr, "too many input files\n");
+            return -1;
+        }
+        else
+            files[nfiles++] = argv[i];
+    }
+
+    if (nfiles == 0)
+    {
+        usage();
+        return -1;
+    }
+
+    indigoSetErrorHandler(onError, 0);
+
+    if (bench.timeout > 0)
+        indigoSetOptionInt("timeout", bench.timeout);
+
+    if (tsvname != 0)
+    {
+        bench.tsv = fopen(tsvname, "w");
+        if (bench.tsv == 0)
+        {
+            fprintf(stderr, "cannot open %s\n", tsvname);
+            return -1;
+        }
+        fprintf(bench.tsv, "category\tmode\tindex\tname\tstatus\tms\tbond-rms\tbond-max\toverlaps\tcrossings\n");
+    }
+
+    // Failures of single structures are reported and counted, not fatal
+    indigoSetErrorHandler(0, 0);
+
+    for (c = 0; c < nfiles; c++)
+    {
+        const char* ext = strrchr(files[c], '.');
+
+        for (m = 0; m < MODE_COUNT; m++)
+            categoryName(files[c], bench.stats[c][m].name, sizeof(bench.stats[c][m].name));
+        bench.ncategories++;
+
+        if (ext != 0 && (strcmp(ext, ".smi") == 0 || strcmp(ext, ".smiles") == 0))
+            processSmilesFile(&bench, c, files[c]);
+        else
+            processFile(&bench, c, files[c]);
+    }
+
+    report(&bench);
+
+    if (bench.tsv != 0)
+        fclose(bench.tsv);
+    for (c = 0; c < bench.ncategories; c++)
+        for (m = 0; m < MODE_COUNT; m++)
+            free(bench.stats[c][m].times);
+
+    return bench.failures > 0 ? 1 : 0;
+}